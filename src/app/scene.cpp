@@ -1,15 +1,27 @@
 #include "scene.h"
 
 #include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
 #include <optional>
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "concurrency/thread_pool.h"
+#include "geometry/half_edge_mesh.h"
 #include "geometry/mesh_simplifier.h"
+#include "geometry/mesh_snapshot.h"
+#include "geometry/mesh_welder.h"
 #include "graphics/arcball.h"
 #include "graphics/obj_loader.h"
+#include "io/content_hash.h"
+#include "io/lod_archive.h"
+#include "io/tile_set.h"
 
 using namespace app;
+using namespace concurrency;
 using namespace geometry;
 using namespace gfx;
 using namespace glm;
@@ -41,7 +53,100 @@ static  std::array<Scene::PointLight, 2> kPointLights{
 };
 
 
-Scene::Scene(Window& window, Camera& camera, ShaderProgram& shader_program)
+namespace {
+
+/** \brief The largest projected error, in pixels, of a level of detail selected for rendering. */
+constexpr auto kMaxScreenSpaceError = 1.f;
+
+/** \brief The time between snapshots of a scene object shown while it is simplified. */
+constexpr chrono::milliseconds kPreviewInterval{250};
+
+/** \brief The memory that resident tiles of a tile set may occupy. */
+constexpr size_t kTileCpuBudget = size_t{512} << 20;
+
+/** \brief The GPU memory that drawable tiles of a tile set may occupy. */
+constexpr size_t kTileGpuBudget = size_t{256} << 20;
+
+/** \brief Determines whether a model file is a level of detail archive. */
+bool IsLodArchive(const filesystem::path& filepath)
+{
+    return filepath.extension() == io::kLodArchiveExtension;
+}
+
+/** \brief Gets the scale and translation that transform a bounding box to fit a unit cube centered at the origin. */
+pair<vec3, vec3> GetNormalizingScaleAndTranslation(const vec3& bmin, const vec3& bmax)
+{
+    float maxExtent = 0.5f * (bmax[0] - bmin[0]);
+    if (maxExtent < 0.5f * (bmax[1] - bmin[1])) {
+        maxExtent = 0.5f * (bmax[1] - bmin[1]);
+    }
+    if (maxExtent < 0.5f * (bmax[2] - bmin[2])) {
+        maxExtent = 0.5f * (bmax[2] - bmin[2]);
+    }
+
+    return {vec3{ 1.0f / maxExtent }, vec3{ -0.5 * (bmax[0] + bmin[0]), -0.5 * (bmax[1] + bmin[1]), -0.5 * (bmax[2] + bmin[2]) }};
+}
+
+/** \brief Transforms a mesh to fit a unit cube centered at the origin given its bounding box. */
+void Normalize(Mesh& mesh, const vec3 bmin, const vec3 bmax)
+{
+    const auto [scale, translation] = GetNormalizingScaleAndTranslation(bmin, bmax);
+    mesh.Scale(scale);
+    mesh.Translate(translation);
+}
+
+/** \brief Gets the number of pixels covered by a view space length of one at a distance of one from the camera. */
+float GetPixelsPerUnit(const int viewport_height)
+{
+    return static_cast<float>(viewport_height) / (2.f * std::tan(kViewFrustrum.field_of_view_y / 2.f));
+}
+
+/**
+ * \brief Loads a mesh, welds it so it can be simplified, and transforms it to fit a unit cube centered at the origin.
+ * \details The loader emits a triangle soup, which the simplifier rejects because its triangles share no vertices. The
+ *          welded mesh is converted through a half-edge mesh so it has the same area-weighted vertex normals as the
+ *          simplified meshes that replace it. Meshes that cannot be represented by a half-edge mesh (e.g., non-manifold
+ *          meshes) are shown as loaded and fail to simplify.
+ */
+Mesh LoadNormalizedMesh(const std::string_view filepath)
+{
+    auto mesh = obj_loader::LoadMesh(filepath);
+    const auto bmin = mesh.GetBoxMin();
+    const auto bmax = mesh.GetBoxMax();
+    try {
+        mesh = static_cast<Mesh>(HalfEdgeMesh{mesh::Weld(mesh)});
+    } catch (const exception& e) {
+        cerr << format("{} cannot be simplified: {}", filepath, e.what()) << endl;
+    }
+    Normalize(mesh, bmin, bmax);
+    return mesh;
+}
+
+/** \brief Copies a mesh, which owns GPU buffers and therefore cannot be copy constructed. */
+Mesh CopyMesh(const Mesh& mesh)
+{
+    return Mesh{mesh.GetPositions(),
+                mesh.GetTexture_coordinates(),
+                mesh.GetNormals(),
+                mesh.GetIndices(),
+                mesh.GetModelTransform(),
+                mesh.GetBoxMin(),
+                mesh.GetBoxMax()};
+}
+
+/**
+ * \brief Loads a level of detail from an archive and transforms it to fit a unit cube centered at the origin.
+ * \details Levels are normalized by the bounds of the whole archive so switching levels does not move the model.
+ */
+Mesh LoadNormalizedLevel(const io::LodArchive& lod_archive, const size_t lod_level)
+{
+    auto mesh = lod_archive.LoadLevel(lod_level);
+    Normalize(mesh, lod_archive.box_min(), lod_archive.box_max());
+    return mesh;
+}
+}
+
+Scene::Scene(Window& window, Camera& camera, ShaderProgram& shader_program, const span<const string_view> model_filepaths)
 	: window_{window}, 
 	camera_(camera),
 	shader_program_{shader_program}
@@ -57,7 +162,9 @@ Scene::Scene(Window& window, Camera& camera, ShaderProgram& shader_program)
 
 	UpdateProjectionTransform();
 
-	LoadObject(ASSETS_FOLDER"/models/bunny.obj");
+	for (const auto filepath : model_filepaths) {
+		LoadObject(filepath);
+	}
 
 	for (size_t i = 0; i < kPointLights.size(); ++i) {
 		const auto& [position, color, attenuation] = kPointLights[i];
@@ -69,26 +176,56 @@ Scene::Scene(Window& window, Camera& camera, ShaderProgram& shader_program)
 
 void Scene::LoadObject(const std::string_view filepath) noexcept
 {
-    auto mesh = obj_loader::LoadMesh(filepath);
-
-	const auto& bmax = mesh.GetBoxMax();
-	const auto& bmin = mesh.GetBoxMin();
-
-    float maxExtent = 0.5f * (bmax[0] - bmin[0]);
-    if (maxExtent < 0.5f * (bmax[1] - bmin[1])) {
-        maxExtent = 0.5f * (bmax[1] - bmin[1]);
-    }
-    if (maxExtent < 0.5f * (bmax[2] - bmin[2])) {
-        maxExtent = 0.5f * (bmax[2] - bmin[2]);
+    if (filesystem::path{filepath}.extension() == io::kTileSetExtension) {
+        try {
+            auto tile_streamer = io::TileStreamer::FromTileSet(io::OpenTileSet(filepath), kTileCpuBudget, kTileGpuBudget);
+
+            vec3 bmin{numeric_limits<float>::max()};
+            vec3 bmax{numeric_limits<float>::lowest()};
+            for (const auto& tile : tile_streamer.tiles()) {
+                bmin = min(bmin, tile.box_min);
+                bmax = max(bmax, tile.box_max);
+            }
+            const auto [scale, translation] = GetNormalizingScaleAndTranslation(bmin, bmax);
+
+            tiled_objects_.push_back(TiledObject{
+                .tile_streamer = move(tile_streamer),
+                .model_transform = translate(glm::scale(mat4{1.f}, scale), translation),
+                .material = Material::FromType(current_mtl_type_)
+                });
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+        }
+        return;
     }
 
-    mesh.Scale(vec3{ 1.0f / maxExtent });
-    mesh.Translate(vec3{ -0.5 * (bmax[0] + bmin[0]), -0.5 * (bmax[1] + bmin[1]), -0.5 * (bmax[2] + bmin[2]) });
+    filesystem::path watched_filepath{filepath};
+    try {
+        watched_filepath = file_watcher_.Watch(watched_filepath);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+    }
 
-    scene_objects_.push_back(SceneObject{
-        .mesh = move(mesh),
-        .material = Material::FromType(current_mtl_type_)
-        });
+    try {
+        // archives start with their least detailed level, which is refined as the camera approaches
+        auto lod_archive = IsLodArchive(watched_filepath) ? make_shared<const io::LodArchive>(watched_filepath) : nullptr;
+        const auto lod_level = lod_archive ? lod_archive->levels().size() - 1 : 0;
+
+        // hashing an archive would read every level, archives are reopened whenever they change instead
+        const auto content_hash = lod_archive ? 0 : io::HashFile(filesystem::path{filepath});
+
+        scene_objects_.push_back(SceneObject{
+            .mesh = lod_archive ? LoadNormalizedLevel(*lod_archive, lod_level) : LoadNormalizedMesh(filepath),
+            .material = Material::FromType(current_mtl_type_),
+            .filepath = move(watched_filepath),
+            .content_hash = content_hash,
+            .simplification_rates = {},
+            .lod_archive = move(lod_archive),
+            .lod_level = lod_level
+            });
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+    }
 }
 
 void Scene::SetMaterialType(gfx::MaterialType mtl_type) noexcept
@@ -100,14 +237,224 @@ void Scene::SetMaterialType(gfx::MaterialType mtl_type) noexcept
             scene_object.material = Material::FromType(mtl_type);
         }
 
+        for (auto& tiled_object : tiled_objects_)
+        {
+            tiled_object.material = Material::FromType(mtl_type);
+        }
+
         current_mtl_type_ = mtl_type;
     }
 }
 
 void Scene::Simplify() noexcept
 {
-    auto& mesh = scene_objects_[active_scene_object_].mesh;
-    mesh = mesh::Simplify(mesh, 0.5f);
+    if (scene_objects_.empty() || HasPendingJob(active_scene_object_)) return;
+
+    auto& scene_object = scene_objects_[active_scene_object_];
+    try {
+        scene_object.mesh = mesh::Simplify(scene_object.mesh, 0.5f);
+        scene_object.simplification_rates.push_back(0.5f);
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+    }
+}
+
+void Scene::SimplifyAll(const float rate) noexcept
+{
+    auto& thread_pool = ThreadPool::Default();
+
+    for (size_t i = 0; i < scene_objects_.size(); ++i) {
+        if (HasPendingJob(i)) continue;
+
+        // copy the source mesh so scene objects can be modified or reallocated while the job runs
+        auto source = make_shared<const Mesh>(CopyMesh(scene_objects_[i].mesh));
+
+        // the job publishes its progress so the object shows the mesh being simplified
+        auto preview = make_shared<MeshSnapshotChannel>();
+        simplification_jobs_.push_back(SimplificationJob{
+            .scene_object_index = i,
+            .rate = rate,
+            .mesh = thread_pool.Submit([source, rate, preview] {
+                mesh::SimplificationOptions options;
+                options.snapshot_channel = preview;
+                return mesh::Simplify(*source, rate, options);
+            }),
+            .source = source,
+            .preview = preview,
+            .next_preview = chrono::steady_clock::now() + kPreviewInterval
+        });
+    }
+}
+
+void Scene::Update() noexcept
+{
+    erase_if(simplification_jobs_, [this](SimplificationJob& job) {
+        if (job.mesh.wait_for(chrono::seconds{0}) != future_status::ready) {
+            if (const auto now = chrono::steady_clock::now(); now >= job.next_preview) {
+                job.next_preview = now + kPreviewInterval;
+                try {
+                    if (auto preview = job.preview->TakeSnapshot()) {
+                        scene_objects_[job.scene_object_index].mesh = move(*preview);
+                    }
+                } catch (const exception& e) {
+                    cerr << e.what() << endl;
+                }
+            }
+            return false;
+        }
+        try {
+            auto& scene_object = scene_objects_[job.scene_object_index];
+            scene_object.mesh = job.mesh.get();
+            scene_object.simplification_rates.push_back(job.rate);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            // previews replaced the object's mesh while the job ran, show the mesh it started from again
+            try {
+                scene_objects_[job.scene_object_index].mesh = CopyMesh(*job.source);
+            } catch (const exception& restore_error) {
+                cerr << restore_error.what() << endl;
+            }
+        }
+        return true;
+    });
+
+    erase_if(reload_jobs_, [this](ReloadJob& job) {
+        if (job.mesh.wait_for(chrono::seconds{0}) != future_status::ready) return false;
+        try {
+            if (auto reloaded_mesh = job.mesh.get()) {
+                auto& scene_object = scene_objects_[job.scene_object_index];
+                scene_object.mesh = move(reloaded_mesh->mesh);
+                scene_object.content_hash = reloaded_mesh->content_hash;
+                scene_object.lod_archive = move(reloaded_mesh->lod_archive);
+                if (scene_object.lod_archive) {
+                    scene_object.lod_level = std::min(scene_object.lod_level, scene_object.lod_archive->levels().size() - 1);
+                }
+            }
+        } catch (const exception& e) {
+            // keep the current mesh, the file is reloaded again when it is next modified
+            cerr << e.what() << endl;
+        }
+        return true;
+    });
+
+    erase_if(lod_jobs_, [this](LodJob& job) {
+        if (job.mesh.wait_for(chrono::seconds{0}) != future_status::ready) return false;
+        auto& scene_object = scene_objects_[job.scene_object_index];
+        try {
+            scene_object.mesh = job.mesh.get();
+            scene_object.lod_level = job.lod_level;
+        } catch (const exception& e) {
+            // stop streaming from a corrupt archive, it is reopened when the file is next modified
+            scene_object.lod_archive = nullptr;
+            cerr << e.what() << endl;
+        }
+        return true;
+    });
+
+    ReloadModifiedObjects();
+    StreamLevelsOfDetail();
+    StreamTiles();
+}
+
+void Scene::ReloadModifiedObjects() noexcept
+{
+    for (const auto& filepath : file_watcher_.Poll()) {
+        for (size_t i = 0; i < scene_objects_.size(); ++i) {
+            if (scene_objects_[i].filepath == filepath) pending_reloads_.insert(i);
+        }
+    }
+
+    // objects with a pending job are reloaded once it finishes so a reload re-applies every simplification rate
+    erase_if(pending_reloads_, [this](const size_t scene_object_index) {
+        if (HasPendingJob(scene_object_index)) return false;
+
+        const auto& scene_object = scene_objects_[scene_object_index];
+        reload_jobs_.push_back(ReloadJob{
+            .scene_object_index = scene_object_index,
+            .mesh = ThreadPool::Default().Submit([filepath = scene_object.filepath,
+                                                  content_hash = scene_object.content_hash,
+                                                  simplification_rates = scene_object.simplification_rates,
+                                                  lod_level = scene_object.lod_level]()
+                                                     -> optional<ReloadedMesh> {
+                // saving a file without changing it (or touching it) does not require reprocessing
+                const auto is_lod_archive = IsLodArchive(filepath);
+                const auto reloaded_content_hash = is_lod_archive ? 0 : io::HashFile(filepath);
+                if (!is_lod_archive && reloaded_content_hash == content_hash) return nullopt;
+
+                auto lod_archive = is_lod_archive ? make_shared<const io::LodArchive>(filepath) : nullptr;
+                auto mesh = lod_archive
+                    ? LoadNormalizedLevel(*lod_archive, std::min(lod_level, lod_archive->levels().size() - 1))
+                    : LoadNormalizedMesh(filepath.string());
+                for (const auto rate : simplification_rates) {
+                    mesh = mesh::Simplify(mesh, rate);
+                }
+                return ReloadedMesh{
+                    .content_hash = reloaded_content_hash, .mesh = move(mesh), .lod_archive = move(lod_archive)};
+            })
+        });
+        return true;
+    });
+}
+
+void Scene::StreamLevelsOfDetail() noexcept
+{
+    const auto [width, height] = window_.GetSize();
+    if (!width || !height) return;
+
+    const auto pixels_per_unit = GetPixelsPerUnit(height);
+    const auto view_transform = camera_.GetViewTansform();
+
+    for (size_t i = 0; i < scene_objects_.size(); ++i) {
+        const auto& scene_object = scene_objects_[i];
+
+        // simplifying an archived object replaces its level of detail until the archive is reloaded
+        if (!scene_object.lod_archive || !scene_object.simplification_rates.empty() || HasPendingJob(i)) continue;
+
+        const auto& lod_archive = *scene_object.lod_archive;
+        const auto view_model_transform = view_transform * scene_object.mesh.GetModelTransform();
+        const auto center = (lod_archive.box_min() + lod_archive.box_max()) / 2.f;
+        const auto scale = length(vec3{view_model_transform[0]});
+        const auto radius = length(lod_archive.box_max() - center) * scale;
+
+        // measure from the nearest point of the bounding sphere so no part of the model exceeds the error tolerance
+        const auto distance = glm::max(length(vec3{view_model_transform * vec4{center, 1.f}}) - radius, kViewFrustrum.z_near);
+        const auto max_error = kMaxScreenSpaceError * distance / (pixels_per_unit * scale);
+
+        if (const auto lod_level = lod_archive.SelectLevel(max_error); lod_level != scene_object.lod_level) {
+            lod_jobs_.push_back(LodJob{
+                .scene_object_index = i,
+                .lod_level = lod_level,
+                .mesh = ThreadPool::Default().Submit([lod_archive = scene_object.lod_archive, lod_level] {
+                    return LoadNormalizedLevel(*lod_archive, lod_level);
+                })
+            });
+        }
+    }
+}
+
+void Scene::StreamTiles() noexcept
+{
+    const auto [width, height] = window_.GetSize();
+    if (!width || !height) return;
+
+    const auto max_error_per_distance = kMaxScreenSpaceError / GetPixelsPerUnit(height);
+    const auto view_transform = camera_.GetViewTansform();
+
+    for (auto& tiled_object : tiled_objects_) {
+        // tiles are selected in object space, where errors and distances are scaled alike by the model transform
+        const auto viewpoint = vec3{inverse(view_transform * tiled_object.model_transform) * vec4{0.f, 0.f, 0.f, 1.f}};
+        tiled_object.tile_streamer.Update(viewpoint, max_error_per_distance);
+    }
+}
+
+bool Scene::HasPendingJob(const size_t scene_object_index) const noexcept
+{
+    const auto has_scene_object_index = [scene_object_index](const auto& job) {
+        return job.scene_object_index == scene_object_index;
+    };
+    return ranges::any_of(simplification_jobs_, has_scene_object_index)
+        || ranges::any_of(reload_jobs_, has_scene_object_index)
+        || ranges::any_of(lod_jobs_, has_scene_object_index);
 }
 
 
@@ -117,24 +464,34 @@ void Scene::Render(gfx::DrawMode draw_mode)
 	auto view_transform = camera_.GetViewTansform();
 	UpdateProjectionTransform();
 
-	for (const auto& [mesh, material] : scene_objects_) {
+	for (const auto& scene_object : scene_objects_) {
+		RenderMesh(scene_object.mesh, view_transform * scene_object.mesh.GetModelTransform(), scene_object.material, draw_mode);
+	}
+
+	for (const auto& tiled_object : tiled_objects_) {
+		for (const auto* const mesh : tiled_object.tile_streamer.drawable_meshes()) {
+			const auto view_model_transform = view_transform * tiled_object.model_transform * mesh->GetModelTransform();
+			RenderMesh(*mesh, view_model_transform, tiled_object.material, draw_mode);
+		}
+	}
+}
 
-		const auto view_model_transform = view_transform * mesh.GetModelTransform();
-		shader_program_.SetUniform("view_model_transform", view_model_transform);
+void Scene::RenderMesh(const Mesh& mesh, const mat4& view_model_transform, const Material& material, const DrawMode draw_mode)
+{
+	shader_program_.SetUniform("view_model_transform", view_model_transform);
 
-		// generally, normals should be transformed by the upper 3x3 inverse transpose of the view-model matrix, however,
-		// this is unnecessary in this context because meshes are only transformed by rotations and translations (which are
-		// orthogonal matrices and therefore the inverse transpose of the view-model matrix is to view-model matrix itself)
-		// in addition to uniform scaling (which is undone when the transformed normal is renormalized in the vertex shader)
-		shader_program_.SetUniform("normal_transform", mat3{view_model_transform});
+	// generally, normals should be transformed by the upper 3x3 inverse transpose of the view-model matrix, however,
+	// this is unnecessary in this context because meshes are only transformed by rotations and translations (which are
+	// orthogonal matrices and therefore the inverse transpose of the view-model matrix is to view-model matrix itself)
+	// in addition to uniform scaling (which is undone when the transformed normal is renormalized in the vertex shader)
+	shader_program_.SetUniform("normal_transform", mat3{view_model_transform});
 
-		shader_program_.SetUniform("material.ambient", material.ambient());
-		shader_program_.SetUniform("material.diffuse", material.diffuse());
-		shader_program_.SetUniform("material.specular", material.specular());
-		shader_program_.SetUniform("material.shininess", material.shininess() * 128.f);
+	shader_program_.SetUniform("material.ambient", material.ambient());
+	shader_program_.SetUniform("material.diffuse", material.diffuse());
+	shader_program_.SetUniform("material.specular", material.specular());
+	shader_program_.SetUniform("material.shininess", material.shininess() * 128.f);
 
-		mesh.Draw(draw_mode);
-	}
+	mesh.Draw(draw_mode);
 }
 
 void Scene::UpdateProjectionTransform() 
@@ -170,11 +527,12 @@ void Scene::HandleKeyPress(const int key_code) {
     if (!scene_objects_size) return;
 
     switch (key_code) {
-    case GLFW_KEY_S: {
-        auto& mesh = scene_objects_[active_scene_object_].mesh;
-        mesh = mesh::Simplify(mesh, 0.5f);
+    case GLFW_KEY_S:
+        Simplify();
+        break;
+    case GLFW_KEY_A:
+        SimplifyAll(0.5f);
         break;
-    }
     case GLFW_KEY_P: {
         static auto use_phong_shading = false;
         use_phong_shading = !use_phong_shading;
@@ -1,8 +1,19 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
@@ -11,16 +22,50 @@
 #include "graphics/material.h"
 #include "graphics/mesh.h"
 #include "graphics/shader_program.h"
+#include "io/file_watcher.h"
+#include "io/lod_archive.h"
+#include "io/tile_streamer.h"
+
+namespace geometry {
+class MeshSnapshotChannel;
+}
 
 namespace app {
 
 class Scene {
 
 public:
-	Scene(Window& window, Camera& camera, gfx::ShaderProgram& shader_program);
+	Scene(Window& window,
+	      Camera& camera,
+	      gfx::ShaderProgram& shader_program,
+	      std::span<const std::string_view> model_filepaths);
+
+	/**
+	 * \brief Loads a model into the scene.
+	 * \param filepath An .obj model, a level of detail archive, or a tile set directory. Archives are opened with their
+	 *                 least detailed level and refined on demand as the camera approaches. Tile sets stream the tiles
+	 *                 near the camera within fixed memory budgets and are not simplified or reloaded.
+	 */
 	void LoadObject(const std::string_view filepath) noexcept;
 	void SetMaterialType(gfx::MaterialType mtl_type) noexcept;
 	void Simplify() noexcept;
+
+	/**
+	 * \brief Simplifies every scene object concurrently on worker threads.
+	 * \param rate The percentage of triangles to be removed from each object.
+	 * \note Objects show snapshots of their meshes being simplified and are replaced by their simplified meshes in
+	 *       \c Update as each job finishes.
+	 */
+	void SimplifyAll(float rate) noexcept;
+
+	/**
+	 * \brief Replaces scene objects whose background simplification has finished since the last update.
+	 * \details Also reloads scene objects whose model file changed on disk. Reloading runs in the background and
+	 *          re-applies the simplifications applied to the object so far before replacing its mesh. Scene objects
+	 *          loaded from level of detail archives switch to the level whose projected error is below a pixel.
+	 */
+	void Update() noexcept;
+
 	void Render(gfx::DrawMode draw_mode);
 
 public:
@@ -33,6 +78,43 @@ public:
 	struct SceneObject {
 		gfx::Mesh mesh;
 		gfx::Material material;
+		std::filesystem::path filepath;
+		std::uint64_t content_hash;
+		std::vector<float> simplification_rates;
+		std::shared_ptr<const io::LodArchive> lod_archive;
+		std::size_t lod_level;
+	};
+
+	struct TiledObject {
+		io::TileStreamer tile_streamer;
+		glm::mat4 model_transform;
+		gfx::Material material;
+	};
+
+	struct SimplificationJob {
+		std::size_t scene_object_index;
+		float rate;
+		std::future<gfx::Mesh> mesh;
+		std::shared_ptr<const gfx::Mesh> source;
+		std::shared_ptr<geometry::MeshSnapshotChannel> preview;
+		std::chrono::steady_clock::time_point next_preview;
+	};
+
+	struct ReloadedMesh {
+		std::uint64_t content_hash;
+		gfx::Mesh mesh;
+		std::shared_ptr<const io::LodArchive> lod_archive;
+	};
+
+	struct ReloadJob {
+		std::size_t scene_object_index;
+		std::future<std::optional<ReloadedMesh>> mesh;
+	};
+
+	struct LodJob {
+		std::size_t scene_object_index;
+		std::size_t lod_level;
+		std::future<gfx::Mesh> mesh;
 	};
 
 	struct PointLight {
@@ -47,12 +129,23 @@ private:
 	void HandleWindowResize(int width, int height);
 	void HandleMouseButtonClick(int button, int action, int mods);
 	void HandleMouseMove(double mouse_x, double mouse_y);
+	void ReloadModifiedObjects() noexcept;
+	void StreamLevelsOfDetail() noexcept;
+	void StreamTiles() noexcept;
+	void RenderMesh(const gfx::Mesh& mesh, const glm::mat4& view_model_transform, const gfx::Material& material, gfx::DrawMode draw_mode);
+	[[nodiscard]] bool HasPendingJob(std::size_t scene_object_index) const noexcept;
 
 	Window& window_;
 	Camera& camera_;
 
 	gfx::ShaderProgram& shader_program_;
 	std::vector<SceneObject> scene_objects_;
+	std::vector<TiledObject> tiled_objects_;
+	std::vector<SimplificationJob> simplification_jobs_;
+	std::vector<ReloadJob> reload_jobs_;
+	std::vector<LodJob> lod_jobs_;
+	std::unordered_set<std::size_t> pending_reloads_;
+	io::FileWatcher file_watcher_;
 	int active_scene_object_ = 0;
 
 	gfx::MaterialType current_mtl_type_ = gfx::MaterialType::Brass;
@@ -0,0 +1,95 @@
+#include "concurrency/large_array_allocator.h"
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace concurrency;
+using namespace std;
+
+namespace {
+
+atomic<HugePagePolicy> huge_page_policy{HugePagePolicy::kDisabled};
+
+constexpr size_t RoundUp(const size_t size, const size_t alignment) noexcept {
+	return (size + alignment - 1) / alignment * alignment;
+}
+}
+
+void concurrency::SetHugePagePolicy(const HugePagePolicy policy) noexcept {
+	huge_page_policy.store(policy, memory_order_relaxed);
+}
+
+HugePagePolicy concurrency::GetHugePagePolicy() noexcept {
+	return huge_page_policy.load(memory_order_relaxed);
+}
+
+#ifdef _WIN32
+
+void* concurrency::AllocateHugePages(const size_t size, const HugePagePolicy policy) {
+
+	// large pages require SeLockMemoryPrivilege, Windows has no transparent huge pages to fall back to
+	if (const auto large_page_size = GetLargePageMinimum(); policy == HugePagePolicy::kExplicit && large_page_size) {
+		if (auto* const data = VirtualAlloc(
+				nullptr, RoundUp(size, large_page_size), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE)) {
+			return data;
+		}
+	}
+
+	if (auto* const data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)) return data;
+	throw bad_alloc{};
+}
+
+void concurrency::DeallocateHugePages(void* const data, size_t) noexcept {
+	VirtualFree(data, 0, MEM_RELEASE);
+}
+
+#else
+
+void* concurrency::AllocateHugePages(const size_t size, const HugePagePolicy policy) {
+	const auto mapping_size = RoundUp(size, kHugePageSize);
+
+#ifdef MAP_HUGETLB
+	if (policy == HugePagePolicy::kExplicit) {
+		if (auto* const data = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			data != MAP_FAILED) {
+			return data;
+		}
+	}
+#else
+	static_cast<void>(policy);
+#endif
+
+	// transparent huge pages are only used for aligned ranges, so over-allocate and trim the mapping to alignment
+	auto* const mapping = mmap(nullptr, mapping_size + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) throw bad_alloc{};
+
+	const auto mapping_begin = reinterpret_cast<uintptr_t>(mapping);
+	const auto data_begin = RoundUp(mapping_begin, kHugePageSize);
+	const auto data_end = data_begin + mapping_size;
+	if (data_begin != mapping_begin) munmap(mapping, data_begin - mapping_begin);
+	if (const auto mapping_end = mapping_begin + mapping_size + kHugePageSize; mapping_end != data_end) {
+		munmap(reinterpret_cast<void*>(data_end), mapping_end - data_end);
+	}
+
+	auto* const data = reinterpret_cast<void*>(data_begin);
+#ifdef MADV_HUGEPAGE
+	// this is advisory, the range is backed by regular pages if transparent huge pages are disabled
+	madvise(data, mapping_size, MADV_HUGEPAGE);
+#endif
+	return data;
+}
+
+void concurrency::DeallocateHugePages(void* const data, const size_t size) noexcept {
+	munmap(data, RoundUp(size, kHugePageSize));
+}
+
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace concurrency {
+
+/** \brief Controls whether large geometry arrays are backed by huge pages. */
+enum class HugePagePolicy {
+
+	/** \brief Large arrays use the default allocator. */
+	kDisabled,
+
+	/** \brief Large arrays are backed by transparent huge pages where supported (Linux). */
+	kTransparent,
+
+	/**
+	 * \brief Large arrays are backed by explicitly reserved huge pages (hugetlbfs on Linux, large pages on Windows).
+	 * \details Falls back to transparent huge pages when no huge pages are reserved or the process lacks the privilege
+	 *          to use them.
+	 */
+	kExplicit
+};
+
+/** \brief The size of a huge page, allocations smaller than this always use the default allocator. */
+constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+/**
+ * \brief Sets the huge page policy used by allocators created after this call. Defaults to \c kDisabled.
+ * \param policy The huge page policy.
+ */
+void SetHugePagePolicy(HugePagePolicy policy) noexcept;
+
+/** \brief Gets the huge page policy used by newly created allocators. */
+[[nodiscard]] HugePagePolicy GetHugePagePolicy() noexcept;
+
+/**
+ * \brief Maps memory backed by huge pages.
+ * \details Pages are not touched, so with the default first-touch NUMA policy each page is placed on the node of the
+ *          thread that first writes it.
+ * \param size The number of bytes to allocate.
+ * \param policy The huge page policy, which must not be \c kDisabled.
+ * \return Memory aligned to \c kHugePageSize.
+ * \throw std::bad_alloc Indicates the memory could not be mapped.
+ */
+[[nodiscard]] void* AllocateHugePages(std::size_t size, HugePagePolicy policy);
+
+/**
+ * \brief Unmaps memory returned by \c AllocateHugePages.
+ * \param data The memory to unmap.
+ * \param size The size passed to \c AllocateHugePages.
+ */
+void DeallocateHugePages(void* data, std::size_t size) noexcept;
+
+/**
+ * \brief An allocator for large geometry arrays (e.g., vertex quadrics and hash table buckets) that are accessed
+ *        randomly, where TLB misses dominate on meshes with hundreds of millions of triangles.
+ * \details When the huge page policy at construction is enabled, allocations of at least \c kHugePageSize are mapped
+ *          directly with huge pages, while smaller allocations (e.g., hash table nodes) use the default allocator.
+ *          Elements constructed without arguments are default-initialized rather than value-initialized, so arrays
+ *          of trivial types are not zeroed on a single thread and their pages are first touched (and placed on NUMA
+ *          nodes) by the parallel pass that fills them.
+ */
+template <typename T>
+class LargeArrayAllocator {
+
+public:
+	using value_type = T;
+
+	// allocators created under different policies are unequal, so containers exchange them along with their memory
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	/** \brief Initializes an allocator with the current huge page policy. */
+	LargeArrayAllocator() noexcept : policy_{GetHugePagePolicy()} {}
+
+	template <typename U>
+	LargeArrayAllocator(const LargeArrayAllocator<U>& allocator) noexcept : policy_{allocator.policy()} {}
+
+	/** \brief Gets the huge page policy of this allocator. */
+	[[nodiscard]] HugePagePolicy policy() const noexcept { return policy_; }
+
+	[[nodiscard]] T* allocate(const std::size_t count) {
+		if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length{};
+		if (!UsesHugePages(count)) return std::allocator<T>{}.allocate(count);
+		return static_cast<T*>(AllocateHugePages(count * sizeof(T), policy_));
+	}
+
+	void deallocate(T* const data, const std::size_t count) noexcept {
+		if (!UsesHugePages(count)) {
+			std::allocator<T>{}.deallocate(data, count);
+		} else {
+			DeallocateHugePages(data, count * sizeof(T));
+		}
+	}
+
+	template <typename U, typename... Args>
+	void construct(U* const data, Args&&... args) {
+		if constexpr (sizeof...(Args) == 0) {
+			::new (static_cast<void*>(data)) U;
+		} else {
+			::new (static_cast<void*>(data)) U(std::forward<Args>(args)...);
+		}
+	}
+
+	friend bool operator==(const LargeArrayAllocator& lhs, const LargeArrayAllocator& rhs) noexcept {
+		return lhs.policy_ == rhs.policy_;
+	}
+
+private:
+	[[nodiscard]] bool UsesHugePages(const std::size_t count) const noexcept {
+		return policy_ != HugePagePolicy::kDisabled && count * sizeof(T) >= kHugePageSize;
+	}
+
+	HugePagePolicy policy_;
+};
+}
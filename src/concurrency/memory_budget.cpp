@@ -0,0 +1,36 @@
+#include "concurrency/memory_budget.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace concurrency;
+using namespace std;
+
+void MemoryBudget::Acquire(const size_t size) {
+	unique_lock lock{mutex_};
+	released_.wait(lock, [&] { return reserved_ == 0 || reserved_ + size <= capacity_; });
+	reserved_ += size;
+}
+
+void MemoryBudget::Release(const size_t size) noexcept {
+	{
+		scoped_lock lock{mutex_};
+		reserved_ -= size;
+	}
+	released_.notify_all();
+}
+
+size_t MemoryBudget::GetPhysicalMemory() noexcept {
+#ifdef _WIN32
+	MEMORYSTATUSEX memory_status{.dwLength = sizeof(MEMORYSTATUSEX)};
+	return GlobalMemoryStatusEx(&memory_status) ? static_cast<size_t>(memory_status.ullTotalPhys) : 0;
+#else
+	const auto page_count = sysconf(_SC_PHYS_PAGES);
+	const auto page_size = sysconf(_SC_PAGE_SIZE);
+	return page_count > 0 && page_size > 0 ? static_cast<size_t>(page_count) * static_cast<size_t>(page_size) : 0;
+#endif
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace concurrency {
+
+/**
+ * \brief Limits the total memory reserved by concurrently running jobs.
+ * \details Jobs reserve an estimate of their peak memory use before they start and release it when they finish.
+ *          A reservation blocks until enough of the budget is available, which bounds the number of jobs that run at
+ *          once by memory rather than by a fixed count.
+ */
+class MemoryBudget {
+
+public:
+	/**
+	 * \brief Initializes a memory budget.
+	 * \param capacity The total number of bytes that may be reserved at once.
+	 */
+	explicit MemoryBudget(std::size_t capacity) noexcept : capacity_{capacity} {}
+
+	/** \brief Gets the total number of bytes that may be reserved at once. */
+	[[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+	/**
+	 * \brief Reserves memory from the budget, blocking until it is available.
+	 * \param size The number of bytes to reserve.
+	 * \note A reservation larger than the capacity is granted once no other reservations are held so that oversized
+	 *       jobs still run, one at a time.
+	 */
+	void Acquire(std::size_t size);
+
+	/**
+	 * \brief Returns reserved memory to the budget.
+	 * \param size The number of bytes to release, which must match a previous call to \c Acquire.
+	 */
+	void Release(std::size_t size) noexcept;
+
+	/** \brief Gets the amount of physical memory installed in the system, or zero if it cannot be determined. */
+	[[nodiscard]] static std::size_t GetPhysicalMemory() noexcept;
+
+private:
+	std::size_t capacity_;
+	std::size_t reserved_ = 0;
+	std::mutex mutex_;
+	std::condition_variable released_;
+};
+}
@@ -0,0 +1,188 @@
+#include "concurrency/memory_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <cstdio>
+#include <fstream>
+#endif
+
+using namespace concurrency;
+using namespace std;
+
+namespace {
+
+/** \brief The allocation counters of a memory category, aligned so categories updated concurrently do not share a cache line. */
+struct alignas(64) Counters {
+	atomic<size_t> live_bytes{0};
+	atomic<size_t> peak_bytes{0};
+	atomic<size_t> allocation_count{0};
+};
+
+array<Counters, kMemoryCategoryCount> counters;
+
+Counters& GetCounters(const MemoryCategory category) noexcept {
+	return counters[static_cast<size_t>(category)];
+}
+
+/** \brief The peak bytes of each memory category recorded by a memory profiler. */
+using ProfilerPeaks = array<atomic<size_t>, kMemoryCategoryCount>;
+
+/** \brief The peaks of every existing memory profiler, which allocations raise while any profiler exists. */
+shared_mutex profiler_peaks_mutex;
+vector<ProfilerPeaks*> profiler_peaks;
+atomic<size_t> profiler_count{0};
+
+/** \brief Raises a peak to a number of bytes if it is lower. */
+void RaisePeak(atomic<size_t>& peak_bytes, const size_t bytes) noexcept {
+	auto current_peak_bytes = peak_bytes.load(memory_order_relaxed);
+	while (bytes > current_peak_bytes
+	       && !peak_bytes.compare_exchange_weak(current_peak_bytes, bytes, memory_order_relaxed)) {}
+}
+
+/** \brief Formats a number of bytes in mebibytes. */
+string FormatMebibytes(const size_t bytes) {
+	return format("{:.1f} MiB", static_cast<double>(bytes) / (1 << 20));
+}
+}
+
+string_view concurrency::GetName(const MemoryCategory category) noexcept {
+	switch (category) {
+		case MemoryCategory::kVertices: return "vertices";
+		case MemoryCategory::kHalfEdges: return "half-edges";
+		case MemoryCategory::kFaces: return "faces";
+		case MemoryCategory::kQuadrics: return "quadrics";
+		case MemoryCategory::kEdgeQueue: return "edge queue";
+		case MemoryCategory::kValidEdges: return "valid edges";
+	}
+	return "unknown";
+}
+
+MemoryUsage concurrency::GetMemoryUsage(const MemoryCategory category) noexcept {
+	const auto& category_counters = GetCounters(category);
+	return MemoryUsage{.live_bytes = category_counters.live_bytes.load(memory_order_relaxed),
+	                   .peak_bytes = category_counters.peak_bytes.load(memory_order_relaxed),
+	                   .allocation_count = category_counters.allocation_count.load(memory_order_relaxed)};
+}
+
+void concurrency::TrackAllocation(const MemoryCategory category, const size_t size) noexcept {
+	auto& category_counters = GetCounters(category);
+	category_counters.allocation_count.fetch_add(1, memory_order_relaxed);
+
+	// the peak is only written when exceeded, which is rare once a phase reaches its steady state
+	const auto live_bytes = category_counters.live_bytes.fetch_add(size, memory_order_relaxed) + size;
+	RaisePeak(category_counters.peak_bytes, live_bytes);
+
+	// allocations only pay for the profiler registry while profiling
+	if (profiler_count.load(memory_order_relaxed) > 0) {
+		shared_lock lock{profiler_peaks_mutex};
+		for (auto* const peaks : profiler_peaks) {
+			RaisePeak((*peaks)[static_cast<size_t>(category)], live_bytes);
+		}
+	}
+}
+
+void concurrency::TrackDeallocation(const MemoryCategory category, const size_t size) noexcept {
+	GetCounters(category).live_bytes.fetch_sub(size, memory_order_relaxed);
+}
+
+ResidentMemory concurrency::GetResidentMemory() noexcept {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS memory_counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &memory_counters, sizeof(memory_counters))) return {};
+	return ResidentMemory{.current_bytes = memory_counters.WorkingSetSize, .peak_bytes = memory_counters.PeakWorkingSetSize};
+#else
+	// VmRSS and VmHWM are reported in kB by Linux, other platforms do not provide /proc/self/status
+	ResidentMemory resident_memory;
+	ifstream stream{"/proc/self/status"};
+	for (string line; getline(stream, line);) {
+		size_t kibibytes = 0;
+		if (line.starts_with("VmRSS:") && sscanf(line.c_str(), "VmRSS: %zu", &kibibytes) == 1) {
+			resident_memory.current_bytes = kibibytes << 10;
+		} else if (line.starts_with("VmHWM:") && sscanf(line.c_str(), "VmHWM: %zu", &kibibytes) == 1) {
+			resident_memory.peak_bytes = kibibytes << 10;
+		}
+	}
+	return resident_memory;
+#endif
+}
+
+bool concurrency::ResetPeakResidentMemory() noexcept {
+#ifdef _WIN32
+	return false;
+#else
+	// writing 5 to clear_refs resets VmHWM to VmRSS on Linux 4.0 and later
+	ofstream stream{"/proc/self/clear_refs"};
+	return static_cast<bool>(stream << '5' << flush);
+#endif
+}
+
+MemoryProfiler::MemoryProfiler(string name) : name_{move(name)}, initial_resident_memory_{GetResidentMemory()} {
+	scoped_lock lock{profiler_peaks_mutex};
+	for (size_t i = 0; i < kMemoryCategoryCount; ++i) {
+		const auto memory_usage = concurrency::GetMemoryUsage(static_cast<MemoryCategory>(i));
+		initial_allocation_counts_[i] = memory_usage.allocation_count;
+		peak_bytes_[i].store(memory_usage.live_bytes, memory_order_relaxed);
+	}
+	profiler_peaks.push_back(&peak_bytes_);
+	profiler_count.fetch_add(1, memory_order_relaxed);
+}
+
+MemoryProfiler::~MemoryProfiler() {
+	scoped_lock lock{profiler_peaks_mutex};
+	erase(profiler_peaks, &peak_bytes_);
+	profiler_count.fetch_sub(1, memory_order_relaxed);
+}
+
+MemoryUsage MemoryProfiler::GetMemoryUsage(const MemoryCategory category) const noexcept {
+	const auto i = static_cast<size_t>(category);
+	const auto memory_usage = concurrency::GetMemoryUsage(category);
+	return MemoryUsage{.live_bytes = memory_usage.live_bytes,
+	                   .peak_bytes = std::max(peak_bytes_[i].load(memory_order_relaxed), memory_usage.live_bytes),
+	                   .allocation_count = memory_usage.allocation_count - initial_allocation_counts_[i]};
+}
+
+void MemoryProfiler::EndPhase(const string_view phase) {
+	auto& sample = samples_.emplace_back(Sample{.phase = string{phase}, .resident_memory = GetResidentMemory(), .live_bytes = {}});
+	for (size_t i = 0; i < kMemoryCategoryCount; ++i) {
+		sample.live_bytes[i] = concurrency::GetMemoryUsage(static_cast<MemoryCategory>(i)).live_bytes;
+	}
+}
+
+string MemoryProfiler::Summary() const {
+	auto summary = format("Memory used by {} (resident {} at start, peak {}):\n",
+		name_,
+		FormatMebibytes(initial_resident_memory_.current_bytes),
+		FormatMebibytes(initial_resident_memory_.peak_bytes));
+
+	for (const auto& [phase, resident_memory, live_bytes] : samples_) {
+		summary += format("  after {:<24} resident {:>12}  peak {:>12}  tracked {:>12}\n",
+			phase,
+			FormatMebibytes(resident_memory.current_bytes),
+			FormatMebibytes(resident_memory.peak_bytes),
+			FormatMebibytes(accumulate(live_bytes.begin(), live_bytes.end(), size_t{0})));
+	}
+
+	for (size_t i = 0; i < kMemoryCategoryCount; ++i) {
+		const auto category = static_cast<MemoryCategory>(i);
+		const auto [live_bytes, peak_bytes, allocation_count] = GetMemoryUsage(category);
+		if (peak_bytes == 0 && allocation_count == 0) continue;
+		summary += format("  {:<30} live {:>12}  peak {:>12}  allocations {}\n",
+			GetName(category),
+			FormatMebibytes(live_bytes),
+			FormatMebibytes(peak_bytes),
+			allocation_count);
+	}
+	return summary;
+}
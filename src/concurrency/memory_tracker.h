@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace concurrency {
+
+/** \brief The subsystems whose allocations are attributed by \c TrackingAllocator. */
+enum class MemoryCategory {
+
+	/** \brief Half-edge mesh vertices and the vertex table. */
+	kVertices,
+
+	/** \brief Half-edges and the half-edge table. */
+	kHalfEdges,
+
+	/** \brief Half-edge mesh faces and the face table. */
+	kFaces,
+
+	/** \brief Vertex error quadrics. */
+	kQuadrics,
+
+	/** \brief The edge contraction priority queue and its entries. */
+	kEdgeQueue,
+
+	/** \brief The table of valid edge contraction candidates. */
+	kValidEdges
+};
+
+/** \brief The number of memory categories. */
+constexpr std::size_t kMemoryCategoryCount = 6;
+
+/** \brief Gets a human-readable name for a memory category. */
+[[nodiscard]] std::string_view GetName(MemoryCategory category) noexcept;
+
+/** \brief Counters describing the allocations of a memory category. */
+struct MemoryUsage {
+
+	/** \brief The number of bytes currently allocated. */
+	std::size_t live_bytes = 0;
+
+	/** \brief The largest number of bytes allocated at once since the process started. */
+	std::size_t peak_bytes = 0;
+
+	/** \brief The number of allocations made since the process started. */
+	std::size_t allocation_count = 0;
+};
+
+/**
+ * \brief Gets the allocation counters of a memory category.
+ * \note Counters are process-wide, so when several meshes are processed concurrently they describe the combined usage.
+ */
+[[nodiscard]] MemoryUsage GetMemoryUsage(MemoryCategory category) noexcept;
+
+/** \brief Records an allocation of a memory category. */
+void TrackAllocation(MemoryCategory category, std::size_t size) noexcept;
+
+/** \brief Records a deallocation of a memory category. */
+void TrackDeallocation(MemoryCategory category, std::size_t size) noexcept;
+
+/** \brief The resident set size of the process. */
+struct ResidentMemory {
+
+	/** \brief The number of bytes currently resident. */
+	std::size_t current_bytes = 0;
+
+	/** \brief The largest number of bytes resident at once since the process started or \c ResetPeakResidentMemory. */
+	std::size_t peak_bytes = 0;
+};
+
+/** \brief Samples the resident set size of the process, zero where it cannot be determined. */
+[[nodiscard]] ResidentMemory GetResidentMemory() noexcept;
+
+/**
+ * \brief Resets the peak resident set size of the process to its current resident set size.
+ * \return \c true if the peak was reset, \c false if the platform does not support resetting it (e.g., Windows).
+ */
+bool ResetPeakResidentMemory() noexcept;
+
+/**
+ * \brief Attributes the memory of an operation to its phases.
+ * \details Each phase samples the resident set size of the process and the live bytes of every memory category when it
+ *          ends, which shows both how much memory each phase retains and which phase raised the peak resident set size.
+ *          Each profiler records the peak of every category from its own creation without resetting the process-wide
+ *          counters, so profilers of concurrent operations do not disturb each other. Counters are still process-wide,
+ *          so the memory of concurrent operations is combined. Allocations are only compared against peaks while a
+ *          profiler exists, and sampling reads \c /proc/self/status on Linux, so profiling is meant to be opt-in.
+ */
+class MemoryProfiler {
+
+public:
+	/**
+	 * \brief Initializes a memory profiler.
+	 * \param name The name of the profiled operation used in the summary.
+	 */
+	explicit MemoryProfiler(std::string name);
+
+	~MemoryProfiler();
+
+	MemoryProfiler(const MemoryProfiler&) = delete;
+	MemoryProfiler& operator=(const MemoryProfiler&) = delete;
+
+	MemoryProfiler(MemoryProfiler&&) = delete;
+	MemoryProfiler& operator=(MemoryProfiler&&) = delete;
+
+	/**
+	 * \brief Gets the allocation counters of a memory category since the profiler was created.
+	 * \return The live bytes of \p category, the largest number of bytes allocated at once since the profiler was
+	 *         created, and the number of allocations made since.
+	 */
+	[[nodiscard]] MemoryUsage GetMemoryUsage(MemoryCategory category) const noexcept;
+
+	/**
+	 * \brief Ends the current phase and begins the next one.
+	 * \param phase The name of the phase that ended.
+	 */
+	void EndPhase(std::string_view phase);
+
+	/** \brief Formats the samples of every ended phase followed by the usage of every memory category in use. */
+	[[nodiscard]] std::string Summary() const;
+
+private:
+	struct Sample {
+		std::string phase;
+		ResidentMemory resident_memory;
+		std::array<std::size_t, kMemoryCategoryCount> live_bytes;
+	};
+
+	std::string name_;
+	ResidentMemory initial_resident_memory_;
+	std::array<std::size_t, kMemoryCategoryCount> initial_allocation_counts_{};
+	std::array<std::atomic<std::size_t>, kMemoryCategoryCount> peak_bytes_{};
+	std::vector<Sample> samples_;
+};
+
+/**
+ * \brief An allocator adaptor that attributes the memory of another allocator to a memory category.
+ * \details Construction is forwarded to the adapted allocator, so adapting a \c LargeArrayAllocator keeps its huge page
+ *          and default-initialization behavior. Use with \c std::allocate_shared to attribute individually allocated
+ *          objects, in which case the shared control block is counted as well.
+ * \tparam T The allocated type.
+ * \tparam Allocator The adapted allocator.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class TrackingAllocator {
+
+	using Traits = std::allocator_traits<Allocator>;
+
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = typename Traits::propagate_on_container_move_assignment;
+	using propagate_on_container_swap = typename Traits::propagate_on_container_swap;
+
+	template <typename U>
+	struct rebind {
+		using other = TrackingAllocator<U, typename Traits::template rebind_alloc<U>>;
+	};
+
+	/**
+	 * \brief Initializes a tracking allocator.
+	 * \param category The memory category allocations are attributed to.
+	 * \param allocator The allocator to adapt.
+	 */
+	explicit TrackingAllocator(const MemoryCategory category, Allocator allocator = Allocator{}) noexcept
+		: category_{category}, allocator_{std::move(allocator)} {}
+
+	template <typename U, typename OtherAllocator>
+	TrackingAllocator(const TrackingAllocator<U, OtherAllocator>& allocator) noexcept
+		: category_{allocator.category()}, allocator_{allocator.allocator()} {}
+
+	/** \brief Gets the memory category allocations are attributed to. */
+	[[nodiscard]] MemoryCategory category() const noexcept { return category_; }
+
+	/** \brief Gets the adapted allocator. */
+	[[nodiscard]] const Allocator& allocator() const noexcept { return allocator_; }
+
+	[[nodiscard]] T* allocate(const std::size_t count) {
+		auto* const data = Traits::allocate(allocator_, count);
+		TrackAllocation(category_, count * sizeof(T));
+		return data;
+	}
+
+	void deallocate(T* const data, const std::size_t count) noexcept {
+		TrackDeallocation(category_, count * sizeof(T));
+		Traits::deallocate(allocator_, data, count);
+	}
+
+	template <typename U, typename... Args>
+	void construct(U* const data, Args&&... args) {
+		Traits::construct(allocator_, data, std::forward<Args>(args)...);
+	}
+
+	friend bool operator==(const TrackingAllocator& lhs, const TrackingAllocator& rhs) noexcept {
+		return lhs.category_ == rhs.category_ && lhs.allocator_ == rhs.allocator_;
+	}
+
+private:
+	MemoryCategory category_;
+	Allocator allocator_;
+};
+
+/**
+ * \brief Creates a shared object whose memory, including its control block, is attributed to a memory category.
+ * \param category The memory category to attribute the object to.
+ * \param args The arguments to construct the object with.
+ * \return The created object.
+ */
+template <typename T, typename... Args>
+[[nodiscard]] std::shared_ptr<T> MakeTracked(const MemoryCategory category, Args&&... args) {
+	return std::allocate_shared<T>(TrackingAllocator<T>{category}, std::forward<Args>(args)...);
+}
+}
@@ -0,0 +1,61 @@
+#include "concurrency/thread_pool.h"
+
+using namespace concurrency;
+using namespace std;
+
+ThreadPool::ThreadPool(const size_t thread_count) {
+	threads_.reserve(thread_count);
+	for (size_t i = 0; i < thread_count; ++i) {
+		threads_.emplace_back([this] { RunWorker(); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		scoped_lock lock{mutex_};
+		stopping_ = true;
+	}
+	task_available_.notify_all();
+	for (auto& thread : threads_) {
+		thread.join();
+	}
+}
+
+ThreadPool& ThreadPool::Default() {
+	static ThreadPool thread_pool;
+	return thread_pool;
+}
+
+void ThreadPool::Enqueue(function<void()> task) {
+	{
+		scoped_lock lock{mutex_};
+		tasks_.push(move(task));
+	}
+	task_available_.notify_one();
+}
+
+bool ThreadPool::TryRunPendingTask() {
+	function<void()> task;
+	{
+		scoped_lock lock{mutex_};
+		if (tasks_.empty()) return false;
+		task = move(tasks_.front());
+		tasks_.pop();
+	}
+	task();
+	return true;
+}
+
+void ThreadPool::RunWorker() {
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock lock{mutex_};
+			task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+			if (stopping_ && tasks_.empty()) return;
+			task = move(tasks_.front());
+			tasks_.pop();
+		}
+		task();
+	}
+}
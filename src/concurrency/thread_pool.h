@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace concurrency {
+
+/**
+ * \brief A fixed-size pool of worker threads that execute submitted tasks in FIFO order.
+ * \details Threads blocked on work they submitted to the pool (e.g., in \c ParallelFor) execute pending tasks while
+ *          they wait. This allows tasks running on the pool to use the pool for nested parallelism without
+ *          exhausting its workers.
+ */
+class ThreadPool {
+
+public:
+	/**
+	 * \brief Initializes a thread pool.
+	 * \param thread_count The number of worker threads to create.
+	 */
+	explicit ThreadPool(std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency()));
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	ThreadPool(ThreadPool&&) noexcept = delete;
+	ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+	/** \brief Gets a process-wide thread pool sized to the number of hardware threads. */
+	[[nodiscard]] static ThreadPool& Default();
+
+	/** \brief Gets the number of worker threads. */
+	[[nodiscard]] std::size_t size() const noexcept { return threads_.size(); }
+
+	/**
+	 * \brief Schedules a task for execution on a worker thread.
+	 * \param task The callable to execute.
+	 * \return A future holding the result of \p task or the exception it threw.
+	 */
+	template <typename Task>
+	std::future<std::invoke_result_t<std::decay_t<Task>>> Submit(Task&& task) {
+		using Result = std::invoke_result_t<std::decay_t<Task>>;
+		// packaged tasks are move-only, share ownership so the queued callable remains copyable
+		auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+		auto future = packaged_task->get_future();
+		Enqueue([packaged_task] { (*packaged_task)(); });
+		return future;
+	}
+
+	/**
+	 * \brief Invokes a function over contiguous chunks of an index range in parallel.
+	 * \param begin,end The half-open index range to process.
+	 * \param grain_size The minimum number of indices processed by a single task.
+	 * \param function A callable accepting a half-open index range (chunk_begin, chunk_end).
+	 * \note The calling thread processes the first chunk and then helps execute pending tasks until all chunks finish.
+	 *       The first exception thrown by \p function is rethrown after all chunks have completed.
+	 */
+	template <typename Function>
+	void ParallelFor(const std::size_t begin, const std::size_t end, std::size_t grain_size, Function&& function) {
+		if (begin >= end) return;
+
+		grain_size = std::max<std::size_t>(grain_size, 1);
+		const auto chunk_count = std::min((end - begin + grain_size - 1) / grain_size, size() + 1);
+		const auto chunk_size = (end - begin + chunk_count - 1) / chunk_count;
+
+		std::vector<std::future<void>> chunks;
+		chunks.reserve(chunk_count);
+		for (auto chunk_begin = begin + chunk_size; chunk_begin < end; chunk_begin += chunk_size) {
+			const auto chunk_end = std::min(chunk_begin + chunk_size, end);
+			chunks.push_back(Submit([&function, chunk_begin, chunk_end] { function(chunk_begin, chunk_end); }));
+		}
+
+		std::exception_ptr exception;
+		try {
+			function(begin, std::min(begin + chunk_size, end));
+		} catch (...) {
+			exception = std::current_exception();
+		}
+
+		for (auto& chunk : chunks) {
+			Wait(chunk);
+			try {
+				chunk.get();
+			} catch (...) {
+				if (!exception) exception = std::current_exception();
+			}
+		}
+
+		if (exception) std::rethrow_exception(exception);
+	}
+
+	/**
+	 * \brief Blocks until a future is ready while executing pending tasks on the calling thread.
+	 * \param future The future to wait for.
+	 */
+	template <typename T>
+	void Wait(const std::future<T>& future) {
+		while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+			if (!TryRunPendingTask()) {
+				future.wait();
+			}
+		}
+	}
+
+private:
+	void Enqueue(std::function<void()> task);
+	bool TryRunPendingTask();
+	void RunWorker();
+
+	std::vector<std::thread> threads_;
+	std::queue<std::function<void()>> tasks_;
+	std::mutex mutex_;
+	std::condition_variable task_available_;
+	bool stopping_ = false;
+};
+}
@@ -0,0 +1,437 @@
+#include "geometry/edgebreaker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "geometry/half_edge.h"
+#include "geometry/half_edge_mesh.h"
+
+using namespace geometry;
+using namespace std;
+
+namespace {
+
+/**
+ * \brief An Edgebreaker symbol describing how a triangle attaches to the boundary of the visited region.
+ * \details The triangle is entered through the gate edge (a,b) and its remaining vertex x is either new (C), the
+ *          boundary vertex before a (L), the boundary vertex after b (R), both (E), another vertex of the current
+ *          boundary loop which splits it in two (S), or a vertex of another boundary loop which merges both (M).
+ */
+enum class Symbol { C, L, E, R, S, M };
+
+/** \brief A prefix code for a symbol with bits stored least significant bit first. */
+struct Code {
+	uint32_t bits;
+	int length;
+};
+
+/** \brief Prefix codes chosen from the symbol frequencies of the spiraling traversal (C and R are most frequent). */
+constexpr array<Code, 6> kCodes{
+	Code{.bits = 0b0, .length = 1},     // C
+	Code{.bits = 0b0111, .length = 4},  // L
+	Code{.bits = 0b011, .length = 3},   // E
+	Code{.bits = 0b01, .length = 2},    // R
+	Code{.bits = 0b01111, .length = 5}, // S
+	Code{.bits = 0b11111, .length = 5}  // M
+};
+
+constexpr int kMaxCodeLength = 5;
+
+/** \brief Appends bits to a byte stream least significant bit first. */
+class BitWriter {
+
+public:
+	explicit BitWriter(vector<byte>& bytes) noexcept : bytes_{bytes} {}
+
+	void Write(const Code& code) {
+		buffer_ |= static_cast<uint64_t>(code.bits) << size_;
+		size_ += code.length;
+		for (; size_ >= 8; size_ -= 8, buffer_ >>= 8) {
+			bytes_.push_back(static_cast<byte>(buffer_ & 0xFF));
+		}
+	}
+
+	void Flush() {
+		if (size_ > 0) bytes_.push_back(static_cast<byte>(buffer_ & 0xFF));
+		buffer_ = 0;
+		size_ = 0;
+	}
+
+private:
+	vector<byte>& bytes_;
+	uint64_t buffer_ = 0;
+	int size_ = 0;
+};
+
+/** \brief Reads prefix-coded symbols from a byte stream using a lookup table indexed by the next bits. */
+class SymbolReader {
+
+public:
+	explicit SymbolReader(const span<const byte> bytes) noexcept : bytes_{bytes} {}
+
+	Symbol Read() {
+		static const auto kDecodeTable = [] {
+			array<pair<Symbol, int>, 1u << kMaxCodeLength> table{};
+			for (size_t i = 0; i < kCodes.size(); ++i) {
+				const auto [bits, length] = kCodes[i];
+				for (uint32_t suffix = 0; suffix < 1u << (kMaxCodeLength - length); ++suffix) {
+					table[bits | suffix << length] = {static_cast<Symbol>(i), length};
+				}
+			}
+			return table;
+		}();
+
+		while (size_ < kMaxCodeLength && position_ < bytes_.size()) {
+			buffer_ |= static_cast<uint64_t>(bytes_[position_++]) << size_;
+			size_ += 8;
+		}
+
+		const auto [symbol, length] = kDecodeTable[buffer_ & ((1u << kMaxCodeLength) - 1)];
+		if (length > size_) throw runtime_error{"Edgebreaker symbol stream is truncated"};
+		buffer_ >>= length;
+		size_ -= length;
+		return symbol;
+	}
+
+private:
+	span<const byte> bytes_;
+	size_t position_ = 0;
+	uint64_t buffer_ = 0;
+	int size_ = 0;
+};
+
+void WriteVarint(vector<byte>& bytes, uint64_t value) {
+	for (; value >= 0x80; value >>= 7) {
+		bytes.push_back(static_cast<byte>(value | 0x80));
+	}
+	bytes.push_back(static_cast<byte>(value));
+}
+
+uint64_t ReadVarint(const span<const byte> bytes, size_t& position) {
+	uint64_t value = 0;
+	for (auto shift = 0; shift < 64; shift += 7) {
+		if (position == bytes.size()) break;
+		const auto next_byte = static_cast<uint64_t>(bytes[position++]);
+		value |= (next_byte & 0x7F) << shift;
+		if (!(next_byte & 0x80)) return value;
+	}
+	throw runtime_error{"Edgebreaker offset stream is corrupt"};
+}
+
+constexpr uint64_t ZigZag(const int64_t value) noexcept {
+	return static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t UnZigZag(const uint64_t value) noexcept {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * \brief Orders the faces of a mesh by their vertex IDs.
+ * \details Each face is keyed by its vertex IDs rotated to start at the smallest, which preserves its orientation, so
+ *          the order depends neither on the iteration order of the face table nor on the standard library hash.
+ */
+vector<const Face*> GetCanonicalFaceOrder(const HalfEdgeMesh& mesh) {
+	vector<pair<array<size_t, 3>, const Face*>> faces;
+	faces.reserve(mesh.faces().size());
+	for (const auto& face : mesh.faces() | views::values) {
+		array<size_t, 3> key{face->v0()->id(), face->v1()->id(), face->v2()->id()};
+		ranges::rotate(key, ranges::min_element(key));
+		faces.emplace_back(key, face.get());
+	}
+	ranges::sort(faces, {}, &pair<array<size_t, 3>, const Face*>::first);
+
+	vector<const Face*> face_order;
+	face_order.reserve(faces.size());
+	ranges::copy(faces | views::values, back_inserter(face_order));
+	return face_order;
+}
+}
+
+mesh::EncodedConnectivity mesh::EncodeConnectivity(const HalfEdgeMesh& mesh) {
+
+	// the boundary of the visited region is a set of loops of half-edges that border unvisited triangles
+	struct Links {
+		const HalfEdge* previous;
+		const HalfEdge* next;
+	};
+	unordered_map<const HalfEdge*, Links> loops;
+	unordered_set<const Face*> visited_faces;
+	vector<const HalfEdge*> stacked_gates;
+
+	EncodedConnectivity connectivity;
+	connectivity.triangle_count = mesh.faces().size();
+	auto& vertex_order = connectivity.vertex_order;
+	BitWriter symbols{connectivity.symbols};
+	auto& offsets = connectivity.offsets;
+
+	const auto link = [&loops](const HalfEdge* const edge0, const HalfEdge* const edge1) {
+		loops[edge0].next = edge1;
+		loops[edge1].previous = edge0;
+	};
+
+	// components are seeded in a canonical face order so the encoded bytes do not depend on the face table
+	for (const auto* const face : GetCanonicalFaceOrder(mesh)) {
+		if (visited_faces.contains(face)) continue;
+
+		// start a new component by visiting its first triangle whose edges form the initial boundary loop
+		const auto* const edge01 = mesh.edges().at(hash_value(*face->v0(), *face->v1())).get();
+		const auto* const edge12 = edge01->next().get();
+		const auto* const edge20 = edge12->next().get();
+		visited_faces.insert(face);
+		vertex_order.insert(vertex_order.end(), {face->v0()->id(), face->v1()->id(), face->v2()->id()});
+
+		link(edge01->flip().get(), edge20->flip().get());
+		link(edge20->flip().get(), edge12->flip().get());
+		link(edge12->flip().get(), edge01->flip().get());
+		const auto* gate = edge01->flip().get();
+
+		for (;;) {
+			// the gate (a,b) borders the next triangle (a,b,x)
+			const auto* const edge_ab = gate;
+			const auto* const edge_bx = edge_ab->next().get();
+			const auto* const edge_xa = edge_bx->next().get();
+			const auto* const edge_ax = edge_xa->flip().get();
+			const auto* const edge_xb = edge_bx->flip().get();
+			const auto [previous_ab, next_ab] = loops.at(edge_ab);
+			const auto left_visited = loops.contains(edge_xa);
+			const auto right_visited = loops.contains(edge_bx);
+			visited_faces.insert(edge_ab->face().get());
+
+			if (left_visited && right_visited) {
+				symbols.Write(kCodes[static_cast<size_t>(Symbol::E)]);
+				loops.erase(edge_ab);
+				loops.erase(edge_bx);
+				loops.erase(edge_xa);
+				if (stacked_gates.empty()) break;
+				gate = stacked_gates.back();
+				stacked_gates.pop_back();
+				continue;
+			}
+
+			if (left_visited) {
+				symbols.Write(kCodes[static_cast<size_t>(Symbol::L)]);
+				const auto previous_xa = loops.at(edge_xa).previous;
+				loops.erase(edge_ab);
+				loops.erase(edge_xa);
+				link(previous_xa, edge_xb);
+				link(edge_xb, next_ab);
+				gate = edge_xb;
+				continue;
+			}
+
+			if (right_visited) {
+				symbols.Write(kCodes[static_cast<size_t>(Symbol::R)]);
+				const auto next_bx = loops.at(edge_bx).next;
+				loops.erase(edge_ab);
+				loops.erase(edge_bx);
+				link(previous_ab, edge_ax);
+				link(edge_ax, next_bx);
+				gate = edge_ax;
+				continue;
+			}
+
+			// rotate around x through unvisited triangles to find the boundary edge leaving x in this triangle fan
+			const auto* boundary_x = edge_ax->next().get();
+			while (boundary_x != edge_xa && !loops.contains(boundary_x)) {
+				boundary_x = boundary_x->flip()->next().get();
+			}
+
+			if (boundary_x == edge_xa) {
+				symbols.Write(kCodes[static_cast<size_t>(Symbol::C)]);
+				vertex_order.push_back(edge_bx->vertex()->id());
+				loops.erase(edge_ab);
+				link(previous_ab, edge_ax);
+				link(edge_ax, edge_xb);
+				link(edge_xb, next_ab);
+				gate = edge_xb;
+				continue;
+			}
+
+			// search both directions of the current loop so the cost is bounded by the shorter side of the split
+			int64_t offset = 0;
+			const auto* forward = next_ab;
+			const auto* backward = edge_ab;
+			for (int64_t distance = 1; forward != edge_ab; ++distance) {
+				if (forward = loops.at(forward).next; forward == boundary_x) {
+					offset = distance;
+					break;
+				}
+				if (backward = loops.at(backward).previous; backward == boundary_x) {
+					offset = -distance;
+					break;
+				}
+			}
+
+			if (offset != 0) {
+				symbols.Write(kCodes[static_cast<size_t>(Symbol::S)]);
+				WriteVarint(offsets, ZigZag(offset));
+				stacked_gates.push_back(edge_ax);
+			} else {
+				// x lies on a stacked loop which happens once per handle of the mesh
+				auto found = false;
+				for (size_t i = 0; i < stacked_gates.size() && !found; ++i) {
+					const auto stacked_gate = stacked_gates.rbegin() + static_cast<ptrdiff_t>(i);
+					const auto* edge = *stacked_gate;
+					for (uint64_t distance = 0; !found; ++distance) {
+						if (edge == boundary_x) {
+							symbols.Write(kCodes[static_cast<size_t>(Symbol::M)]);
+							WriteVarint(offsets, i);
+							WriteVarint(offsets, distance);
+							stacked_gates.erase(next(stacked_gate).base());
+							found = true;
+						} else if (edge = loops.at(edge).next; edge == *stacked_gate) {
+							break;
+						}
+					}
+				}
+				if (!found) throw logic_error{"Edgebreaker boundary loops are inconsistent"};
+			}
+
+			// split or merge loops at x into (..., a, x, ...) and (..., x, b, ...)
+			const auto previous_x = loops.at(boundary_x).previous;
+			loops.erase(edge_ab);
+			link(previous_ab, edge_ax);
+			link(edge_ax, boundary_x);
+			link(previous_x, edge_xb);
+			link(edge_xb, next_ab);
+			gate = edge_xb;
+		}
+	}
+
+	symbols.Flush();
+	return connectivity;
+}
+
+vector<unsigned int> mesh::DecodeConnectivity(const span<const byte> symbols,
+                                              const span<const byte> offsets,
+                                              const size_t triangle_count,
+                                              const size_t vertex_count) {
+
+	// boundary loops are doubly linked lists of nodes, each node is the start vertex of a boundary edge
+	struct Node {
+		unsigned int vertex;
+		unsigned int previous;
+		unsigned int next;
+	};
+	vector<Node> nodes;
+	nodes.reserve(vertex_count + triangle_count / 8 + 3);
+	vector<unsigned int> stacked_gates;
+
+	vector<unsigned int> indices;
+	indices.reserve(triangle_count * 3);
+	SymbolReader symbol_reader{symbols};
+	size_t offset_position = 0;
+	unsigned int next_vertex = 0;
+
+	const auto create_vertex = [&] {
+		if (next_vertex >= vertex_count) throw runtime_error{"Edgebreaker connectivity references too many vertices"};
+		return next_vertex++;
+	};
+	const auto create_node = [&nodes](const unsigned int vertex) {
+		nodes.push_back(Node{.vertex = vertex, .previous = 0, .next = 0});
+		return static_cast<unsigned int>(nodes.size() - 1);
+	};
+	const auto link = [&nodes](const unsigned int node0, const unsigned int node1) {
+		nodes[node0].next = node1;
+		nodes[node1].previous = node0;
+	};
+	const auto walk = [&nodes](unsigned int node, uint64_t distance, const bool forward) {
+		if (distance > nodes.size()) throw runtime_error{"Edgebreaker offset stream is corrupt"};
+		for (; distance > 0; --distance) node = forward ? nodes[node].next : nodes[node].previous;
+		return node;
+	};
+
+	while (indices.size() < triangle_count * 3) {
+		// each component starts with a triangle of three new vertices
+		const auto v0 = create_vertex();
+		const auto v1 = create_vertex();
+		const auto v2 = create_vertex();
+		indices.insert(indices.end(), {v0, v1, v2});
+
+		const auto node1 = create_node(v1);
+		const auto node0 = create_node(v0);
+		const auto node2 = create_node(v2);
+		link(node1, node0);
+		link(node0, node2);
+		link(node2, node1);
+		auto gate = node1;
+
+		for (auto component_ended = false; !component_ended && indices.size() < triangle_count * 3;) {
+			const auto node_a = gate;
+			const auto node_b = nodes[node_a].next;
+			const auto a = nodes[node_a].vertex;
+			const auto b = nodes[node_b].vertex;
+
+			switch (const auto symbol = symbol_reader.Read(); symbol) {
+				case Symbol::C: {
+					const auto node_x = create_node(create_vertex());
+					indices.insert(indices.end(), {a, b, nodes[node_x].vertex});
+					link(node_a, node_x);
+					link(node_x, node_b);
+					gate = node_x;
+					break;
+				}
+				case Symbol::L: {
+					const auto node_x = nodes[node_a].previous;
+					indices.insert(indices.end(), {a, b, nodes[node_x].vertex});
+					link(node_x, node_b);
+					gate = node_x;
+					break;
+				}
+				case Symbol::R: {
+					const auto node_x = nodes[node_b].next;
+					indices.insert(indices.end(), {a, b, nodes[node_x].vertex});
+					link(node_a, node_x);
+					break;
+				}
+				case Symbol::E: {
+					indices.insert(indices.end(), {a, b, nodes[nodes[node_a].previous].vertex});
+					if (stacked_gates.empty()) {
+						component_ended = true;
+					} else {
+						gate = stacked_gates.back();
+						stacked_gates.pop_back();
+					}
+					break;
+				}
+				case Symbol::S:
+				case Symbol::M: {
+					unsigned int node_x;
+					if (symbol == Symbol::S) {
+						const auto offset = UnZigZag(ReadVarint(offsets, offset_position));
+						node_x = offset > 0 ? walk(node_b, static_cast<uint64_t>(offset), true)
+						                    : walk(node_a, static_cast<uint64_t>(-offset), false);
+						stacked_gates.push_back(node_a);
+					} else {
+						const auto stack_index = ReadVarint(offsets, offset_position);
+						if (stack_index >= stacked_gates.size()) throw runtime_error{"Edgebreaker offset stream is corrupt"};
+						const auto stacked_gate = stacked_gates.end() - 1 - static_cast<ptrdiff_t>(stack_index);
+						node_x = walk(*stacked_gate, ReadVarint(offsets, offset_position), true);
+						stacked_gates.erase(stacked_gate);
+					}
+
+					// split or merge loops at x into (..., a, x, ...) and (..., x, b, ...)
+					const auto x = nodes[node_x].vertex;
+					const auto node_xb = create_node(x);
+					indices.insert(indices.end(), {a, b, x});
+					link(nodes[node_x].previous, node_xb);
+					link(node_xb, node_b);
+					link(node_a, node_x);
+					gate = node_xb;
+					break;
+				}
+			}
+		}
+	}
+
+	if (next_vertex != vertex_count) throw runtime_error{"Edgebreaker connectivity does not reference every vertex"};
+	return indices;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace geometry {
+class HalfEdgeMesh;
+}
+
+namespace geometry::mesh {
+
+/** \brief Triangle mesh connectivity encoded with Edgebreaker. */
+struct EncodedConnectivity {
+
+	/** \brief The number of triangles in the mesh. */
+	std::size_t triangle_count = 0;
+
+	/** \brief Prefix-coded CLERS symbols, one per triangle. */
+	std::vector<std::byte> symbols;
+
+	/** \brief Varint-encoded loop offsets for split and merge symbols. */
+	std::vector<std::byte> offsets;
+
+	/**
+	 * \brief The half-edge mesh vertex ID of each decoded vertex.
+	 * \details The decoder numbers vertices in the order they are first referenced, so vertex attributes must be
+	 *          stored in this order. A vertex shared by several triangle fans (or mesh components) is listed once per fan.
+	 */
+	std::vector<std::size_t> vertex_order;
+};
+
+/**
+ * \brief Encodes the connectivity of a triangle mesh.
+ * \details Implements Edgebreaker which visits triangles in a spiraling traversal over the half-edge mesh and records
+ *          for each triangle how it attaches to the boundary of the visited region using one of the symbols C (new
+ *          vertex), L (left neighbor visited), E (end of a boundary loop), R (right neighbor visited), or S (split a
+ *          boundary loop). Handles (mesh genus) are encoded by merging boundary loops. Typical meshes need about two
+ *          bits per triangle in addition to a few bytes of offsets per split. Each component is entered through its
+ *          face with the smallest vertex IDs, so the encoding only depends on the faces and vertex IDs of \p mesh.
+ * \param mesh The mesh to encode.
+ * \return The encoded mesh connectivity.
+ */
+EncodedConnectivity EncodeConnectivity(const HalfEdgeMesh& mesh);
+
+/**
+ * \brief Decodes triangle mesh connectivity encoded by \c EncodeConnectivity.
+ * \param symbols The encoded CLERS symbols.
+ * \param offsets The encoded loop offsets.
+ * \param triangle_count The number of triangles to decode.
+ * \param vertex_count The number of vertices the encoded connectivity references.
+ * \return Element indices such that each three consecutive integers define a triangle face. Vertices are numbered in
+ *         the order given by \c EncodedConnectivity::vertex_order.
+ * \throw std::runtime_error Indicates the encoded connectivity is corrupt.
+ */
+std::vector<unsigned int> DecodeConnectivity(std::span<const std::byte> symbols,
+                                             std::span<const std::byte> offsets,
+                                             std::size_t triangle_count,
+                                             std::size_t vertex_count);
+}
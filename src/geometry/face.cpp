@@ -44,5 +44,15 @@ Face::Face(const shared_ptr<const Vertex>& v0, const shared_ptr<const Vertex>& v
 	}
 
 	normal_ = normal / magnitude;
+	plane_offset_ = -dot(normal_, v0_->position());
 	area_ = .5f * magnitude;
 }
+
+Face::Face(const shared_ptr<const Vertex>& v0,
+           const shared_ptr<const Vertex>& v1,
+           const shared_ptr<const Vertex>& v2,
+           const vec4& plane,
+           const float area)
+	: normal_{plane}, plane_offset_{plane.w}, area_{area} {
+	tie(v0_, v1_, v2_) = GetMinVertexOrder(v0, v1, v2);
+}
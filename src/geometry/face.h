@@ -4,6 +4,7 @@
 #include <memory>
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 #include "geometry/vertex.h"
 
@@ -22,18 +23,33 @@ public:
 	     const std::shared_ptr<const Vertex>& v1,
 	     const std::shared_ptr<const Vertex>& v2);
 
+	/**
+	 * \brief Initializes a triangle face with precomputed geometry (e.g., from \c ComputeFaceGeometry).
+	 * \param v0,v1,v2 The face vertices.
+	 * \param plane The face plane equation as its unit normal followed by its plane offset.
+	 * \param area The face area.
+	 */
+	Face(const std::shared_ptr<const Vertex>& v0,
+	     const std::shared_ptr<const Vertex>& v1,
+	     const std::shared_ptr<const Vertex>& v2,
+	     const glm::vec4& plane,
+	     float area);
+
 	/** \brief Gets the first face vertex. */
-	[[nodiscard]] std::shared_ptr<const Vertex> v0() const noexcept { return v0_; }
+	[[nodiscard]] const std::shared_ptr<const Vertex>& v0() const noexcept { return v0_; }
 
 	/** \brief  Gets the second face vertex. */
-	[[nodiscard]] std::shared_ptr<const Vertex> v1() const noexcept { return v1_; }
+	[[nodiscard]] const std::shared_ptr<const Vertex>& v1() const noexcept { return v1_; }
 
 	/** \brief Gets the third face vertex. */
-	[[nodiscard]] std::shared_ptr<const Vertex> v2() const noexcept { return v2_; }
+	[[nodiscard]] const std::shared_ptr<const Vertex>& v2() const noexcept { return v2_; }
 
 	/** \brief  Gets the face normal. */
 	[[nodiscard]] const glm::vec3& normal() const noexcept { return normal_; }
 
+	/** \brief Gets the face plane equation as its unit normal followed by its plane offset. */
+	[[nodiscard]] glm::vec4 plane() const noexcept { return glm::vec4{normal_, plane_offset_}; }
+
 	/** \brief Gets the face area. */
 	[[nodiscard]] float area() const noexcept { return area_; }
 
@@ -43,6 +59,7 @@ public:
 private:
 	std::shared_ptr<const Vertex> v0_, v1_, v2_;
 	glm::vec3 normal_;
+	float plane_offset_;
 	float area_;
 };
 }
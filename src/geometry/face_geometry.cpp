@@ -0,0 +1,212 @@
+#include "geometry/face_geometry.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define FACE_GEOMETRY_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include <glm/geometric.hpp>
+
+using namespace geometry;
+using namespace glm;
+using namespace std;
+
+namespace {
+
+/**
+ * \brief Rotates the vertices of a triangle so the vertex with the lowest index comes first.
+ * \note Preserves winding order. Faces are computed from the same vertex as \c Face, so both round identically.
+ */
+array<unsigned int, 3> GetMinIndexOrder(const unsigned int i0, const unsigned int i1, const unsigned int i2) noexcept {
+	if (const auto min_index = min({i0, i1, i2}); min_index == i0) {
+		return {i0, i1, i2};
+	} else if (min_index == i1) {
+		return {i1, i2, i0};
+	} else {
+		return {i2, i0, i1};
+	}
+}
+
+/** \brief Computes the geometry of a range of faces one at a time. */
+void ComputeFaceGeometryScalar(const span<const vec3> positions,
+                               const span<const unsigned int> indices,
+                               const size_t begin,
+                               const size_t end,
+                               FaceGeometry& face_geometry) noexcept {
+	for (auto i = begin; i < end; ++i) {
+		const auto [i0, i1, i2] = GetMinIndexOrder(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]);
+		const auto& p0 = positions[i0];
+		const auto& p1 = positions[i1];
+		const auto& p2 = positions[i2];
+
+		const auto normal = cross(p1 - p0, p2 - p0);
+		const auto magnitude = length(normal);
+		const auto unit_normal = normal / magnitude;
+
+		face_geometry.normal_x[i] = unit_normal.x;
+		face_geometry.normal_y[i] = unit_normal.y;
+		face_geometry.normal_z[i] = unit_normal.z;
+		face_geometry.areas[i] = .5f * magnitude;
+		face_geometry.plane_offsets[i] = -dot(unit_normal, p0);
+	}
+}
+
+#ifdef FACE_GEOMETRY_AVX2
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FACE_GEOMETRY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FACE_GEOMETRY_TARGET_AVX2
+#endif
+
+/** \brief Determines if the processor and operating system support AVX2. */
+bool SupportsAvx2() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_cpu_supports("avx2");
+#else
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+
+	// the operating system must save the upper halves of the YMM registers on context switches
+	__cpuid(info, 1);
+	constexpr auto kOsxsave = 1 << 27, kAvx = 1 << 28;
+	if ((info[2] & kOsxsave) == 0 || (info[2] & kAvx) == 0 || (_xgetbv(0) & 6) != 6) return false;
+
+	__cpuidex(info, 7, 0);
+	constexpr auto kAvx2 = 1 << 5;
+	return (info[1] & kAvx2) != 0;
+#endif
+}
+
+/** \brief Gathers a position component of eight vertices given their offsets into the position array. */
+FACE_GEOMETRY_TARGET_AVX2 inline __m256 GatherComponent(const float* const positions, const __m256i offsets) noexcept {
+	return _mm256_i32gather_ps(positions, offsets, sizeof(float));
+}
+
+/** \brief Selects the index of eight faces depending on which of their vertices they start at. */
+FACE_GEOMETRY_TARGET_AVX2 inline __m256i SelectIndex(const __m256i from_i0,
+                                                     const __m256i from_i1,
+                                                     const __m256i from_i2,
+                                                     const __m256i starts_at_i0,
+                                                     const __m256i starts_at_i1) noexcept {
+	return _mm256_blendv_epi8(_mm256_blendv_epi8(from_i2, from_i1, starts_at_i1), from_i0, starts_at_i0);
+}
+
+/**
+ * \brief Computes the geometry of faces eight at a time.
+ * \return The number of faces processed, the remaining faces must be processed by \c ComputeFaceGeometryScalar.
+ */
+FACE_GEOMETRY_TARGET_AVX2 size_t ComputeFaceGeometryAvx2(const span<const vec3> positions,
+                                                         const span<const unsigned int> indices,
+                                                         FaceGeometry& face_geometry) noexcept {
+
+	const auto* const x = reinterpret_cast<const float*>(positions.data());
+	const auto* const y = x + 1;
+	const auto* const z = x + 2;
+	const auto* const index_data = reinterpret_cast<const int*>(indices.data());
+
+	// each face has three indices and each position three components
+	const auto face_offsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+	const auto three = _mm256_set1_epi32(3);
+	const auto half = _mm256_set1_ps(.5f);
+	const auto sign = _mm256_set1_ps(-0.f);
+
+	const auto face_count = indices.size() / 3;
+	size_t i = 0;
+	for (; i + 8 <= face_count; i += 8) {
+		const auto* const face_indices = index_data + 3 * i;
+		const auto i0 = _mm256_i32gather_epi32(face_indices, face_offsets, sizeof(int));
+		const auto i1 = _mm256_i32gather_epi32(face_indices + 1, face_offsets, sizeof(int));
+		const auto i2 = _mm256_i32gather_epi32(face_indices + 2, face_offsets, sizeof(int));
+
+		// rotate each face to start at its lowest index as in GetMinIndexOrder
+		const auto min_index = _mm256_min_epu32(i0, _mm256_min_epu32(i1, i2));
+		const auto starts_at_i0 = _mm256_cmpeq_epi32(i0, min_index);
+		const auto starts_at_i1 = _mm256_andnot_si256(starts_at_i0, _mm256_cmpeq_epi32(i1, min_index));
+		const auto offset0 = _mm256_mullo_epi32(SelectIndex(i0, i1, i2, starts_at_i0, starts_at_i1), three);
+		const auto offset1 = _mm256_mullo_epi32(SelectIndex(i1, i2, i0, starts_at_i0, starts_at_i1), three);
+		const auto offset2 = _mm256_mullo_epi32(SelectIndex(i2, i0, i1, starts_at_i0, starts_at_i1), three);
+
+		const auto p0x = GatherComponent(x, offset0), p0y = GatherComponent(y, offset0), p0z = GatherComponent(z, offset0);
+		const auto e1x = _mm256_sub_ps(GatherComponent(x, offset1), p0x);
+		const auto e1y = _mm256_sub_ps(GatherComponent(y, offset1), p0y);
+		const auto e1z = _mm256_sub_ps(GatherComponent(z, offset1), p0z);
+		const auto e2x = _mm256_sub_ps(GatherComponent(x, offset2), p0x);
+		const auto e2y = _mm256_sub_ps(GatherComponent(y, offset2), p0y);
+		const auto e2z = _mm256_sub_ps(GatherComponent(z, offset2), p0z);
+
+		// the operations mirror glm::cross, glm::length, and glm::dot so both paths round identically
+		const auto nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e2y, e1z));
+		const auto ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e2z, e1x));
+		const auto nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e2x, e1y));
+		const auto magnitude = _mm256_sqrt_ps(
+			_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz)));
+
+		const auto ux = _mm256_div_ps(nx, magnitude);
+		const auto uy = _mm256_div_ps(ny, magnitude);
+		const auto uz = _mm256_div_ps(nz, magnitude);
+		const auto offset = _mm256_xor_ps(
+			_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ux, p0x), _mm256_mul_ps(uy, p0y)), _mm256_mul_ps(uz, p0z)), sign);
+
+		_mm256_storeu_ps(face_geometry.normal_x.data() + i, ux);
+		_mm256_storeu_ps(face_geometry.normal_y.data() + i, uy);
+		_mm256_storeu_ps(face_geometry.normal_z.data() + i, uz);
+		_mm256_storeu_ps(face_geometry.areas.data() + i, _mm256_mul_ps(half, magnitude));
+		_mm256_storeu_ps(face_geometry.plane_offsets.data() + i, offset);
+	}
+
+	return i;
+}
+#endif
+}
+
+FaceGeometry geometry::ComputeFaceGeometry(const span<const vec3> positions, const span<const unsigned int> indices) {
+
+	const auto face_count = indices.size() / 3;
+	FaceGeometry face_geometry;
+	for (auto* const values : {&face_geometry.normal_x,
+	                           &face_geometry.normal_y,
+	                           &face_geometry.normal_z,
+	                           &face_geometry.areas,
+	                           &face_geometry.plane_offsets}) {
+		values->resize(face_count);
+	}
+
+	size_t begin = 0;
+#ifdef FACE_GEOMETRY_AVX2
+	// gathers address positions with 32-bit signed offsets of three floats per vertex
+	static const auto supports_avx2 = SupportsAvx2();
+	if (supports_avx2 && positions.size() <= static_cast<size_t>(numeric_limits<int32_t>::max() / 3)) {
+		begin = ComputeFaceGeometryAvx2(positions, indices, face_geometry);
+	}
+#endif
+	ComputeFaceGeometryScalar(positions, indices, begin, face_count, face_geometry);
+
+	return face_geometry;
+}
+
+vector<vec3> geometry::ComputeVertexNormals(const span<const vec3> positions, const span<const unsigned int> indices) {
+
+	const auto face_geometry = ComputeFaceGeometry(positions, indices);
+	vector<vec3> normals(positions.size(), vec3{0.f});
+	for (size_t i = 0; i < face_geometry.size(); ++i) {
+		const auto weighted_normal = face_geometry.normal(i) * face_geometry.areas[i];
+		for (size_t j = 0; j < 3; ++j) {
+			normals[indices[3 * i + j]] += weighted_normal;
+		}
+	}
+	for (auto& normal : normals) {
+		normal = normalize(normal);
+	}
+	return normals;
+}
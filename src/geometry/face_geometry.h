@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace geometry {
+
+/**
+ * \brief The normals, areas, and plane equations of the triangles of a mesh in structure-of-arrays layout.
+ * \details Faces with zero area have an area of zero and undefined normals and planes.
+ */
+struct FaceGeometry {
+
+	/** \brief The components of the unit normal of each face. */
+	std::vector<float> normal_x, normal_y, normal_z;
+
+	/** \brief The area of each face. */
+	std::vector<float> areas;
+
+	/** \brief The offset of the plane of each face such that <tt>dot(normal, p) + offset = 0</tt> for points \c p on the face. */
+	std::vector<float> plane_offsets;
+
+	/** \brief Gets the number of faces. */
+	[[nodiscard]] std::size_t size() const noexcept { return areas.size(); }
+
+	/** \brief Gets the unit normal of a face. */
+	[[nodiscard]] glm::vec3 normal(const std::size_t face) const noexcept {
+		return glm::vec3{normal_x[face], normal_y[face], normal_z[face]};
+	}
+
+	/** \brief Gets the plane equation of a face as its unit normal followed by its plane offset. */
+	[[nodiscard]] glm::vec4 plane(const std::size_t face) const noexcept {
+		return glm::vec4{normal_x[face], normal_y[face], normal_z[face], plane_offsets[face]};
+	}
+};
+
+/**
+ * \brief Computes the normal, area, and plane equation of every triangle in a mesh.
+ * \details Faces are processed eight at a time with AVX2 when the processor supports it and one at a time otherwise.
+ *          Both paths evaluate the same operations in the same order without fused multiply-adds, so results are
+ *          bit-identical across processors and simplification stays deterministic. Each face is computed from its
+ *          vertex with the lowest index like \c Face is from its vertex with the lowest ID, so a half-edge mesh whose
+ *          vertex IDs are its indices has the same face geometry (and rejects the same zero-area faces) either way.
+ * \param positions The mesh vertex positions.
+ * \param indices Element indices such that each three consecutive integers define a triangle face. Every index must
+ *                refer to an element of \p positions.
+ * \return The geometry of each face in \p indices, in order.
+ */
+[[nodiscard]] FaceGeometry ComputeFaceGeometry(std::span<const glm::vec3> positions, std::span<const unsigned int> indices);
+
+/**
+ * \brief Computes the normal of every vertex in a mesh as the area-weighted average of the normals of its faces.
+ * \param positions The mesh vertex positions.
+ * \param indices Element indices such that each three consecutive integers define a triangle face. Every index must
+ *                refer to an element of \p positions.
+ * \return The unit normal of each vertex in \p positions.
+ */
+[[nodiscard]] std::vector<glm::vec3> ComputeVertexNormals(std::span<const glm::vec3> positions,
+                                                          std::span<const unsigned int> indices);
+}
@@ -19,22 +19,22 @@ public:
 	explicit HalfEdge(std::shared_ptr<Vertex> vertex) noexcept : vertex_{std::move(vertex)} {}
 
 	/** \brief Gets the vertex at the head of this half-edge. */
-	[[nodiscard]] std::shared_ptr<Vertex> vertex() const noexcept { return vertex_; }
+	[[nodiscard]] const std::shared_ptr<Vertex>& vertex() const noexcept { return vertex_; }
 
 	/** \brief Gets the next half-edge of a triangle in counter-clockwise order. */
-	[[nodiscard]] std::shared_ptr<HalfEdge> next() const noexcept { return next_; }
+	[[nodiscard]] const std::shared_ptr<HalfEdge>& next() const noexcept { return next_; }
 
 	/** \brief Sets the next half-edge. */
 	void set_next(const std::shared_ptr<HalfEdge>& next) noexcept { next_ = next; }
 
 	/** \brief Gets the half-edge that shares this edge's vertices in the opposite direction. */
-	[[nodiscard]] std::shared_ptr<HalfEdge> flip() const noexcept { return flip_; }
+	[[nodiscard]] const std::shared_ptr<HalfEdge>& flip() const noexcept { return flip_; }
 
 	/** \brief Sets the flip half-edge. */
 	void set_flip(const std::shared_ptr<HalfEdge>& flip) noexcept { flip_ = flip; }
 
 	/** \brief Gets the face created by three counter-clockwise \c next iterations starting from this half-edge. */
-	[[nodiscard]] std::shared_ptr<Face> face() const noexcept { return face_; }
+	[[nodiscard]] const std::shared_ptr<Face>& face() const noexcept { return face_; }
 
 	/** Sets the half-edge face. */
 	void set_face(const std::shared_ptr<Face>& face) noexcept { face_ = face; }
@@ -1,15 +1,23 @@
 #include "geometry/half_edge_mesh.h"
 
+#include <algorithm>
+#include <array>
 #include <format>
 #include <ranges>
+#include <stdexcept>
+#include <vector>
 
 #include <glm/vec3.hpp>
 
 #include "geometry/face.h"
+#include "geometry/face_geometry.h"
 #include "geometry/half_edge.h"
+#include "geometry/mesh_snapshot.h"
+#include "geometry/one_ring.h"
 #include "geometry/vertex.h"
 #include "graphics/mesh.h"
 
+using namespace concurrency;
 using namespace geometry;
 using namespace gfx;
 using namespace glm;
@@ -24,7 +32,7 @@ namespace {
  * \return The half-edge connecting vertex \p v0 to \p v1.
  */
 shared_ptr<HalfEdge> CreateHalfEdge(
-	const shared_ptr<Vertex>& v0, const shared_ptr<Vertex>& v1, unordered_map<size_t, shared_ptr<HalfEdge>>& edges) {
+	const shared_ptr<Vertex>& v0, const shared_ptr<Vertex>& v1, HalfEdgeMesh::ElementMap<HalfEdge>& edges) {
 
 	const auto edge01_key = hash_value(*v0, *v1);
 	const auto edge10_key = hash_value(*v1, *v0);
@@ -34,8 +42,8 @@ shared_ptr<HalfEdge> CreateHalfEdge(
 		return iterator->second;
 	}
 
-	auto edge01 = make_shared<HalfEdge>(v1);
-	const auto edge10 = make_shared<HalfEdge>(v0);
+	auto edge01 = MakeTracked<HalfEdge>(MemoryCategory::kHalfEdges, v1);
+	const auto edge10 = MakeTracked<HalfEdge>(MemoryCategory::kHalfEdges, v0);
 
 	edge01->set_flip(edge10);
 	edge10->set_flip(edge01);
@@ -49,14 +57,16 @@ shared_ptr<HalfEdge> CreateHalfEdge(
 /**
  * \brief Creates a new triangle in the half-edge mesh.
  * \param v0,v1,v2 The triangle vertices in counter-clockwise order.
+ * \param face012 The face representing vertices \p v0, \p v1, \p v2 to link the triangle half-edges to.
  * \param edges A mapping of mesh half-edges by ID.
- * \return A triangle face representing vertices \p v0, \p v1, \p v2 in the half-edge mesh.
+ * \return The face \p face012 linked into the half-edge mesh.
  */
 shared_ptr<Face> CreateTriangle(
 	const shared_ptr<Vertex>& v0,
 	const shared_ptr<Vertex>& v1,
 	const shared_ptr<Vertex>& v2,
-	unordered_map<size_t, shared_ptr<HalfEdge>>& edges) {
+	shared_ptr<Face> face012,
+	HalfEdgeMesh::ElementMap<HalfEdge>& edges) {
 
 	const auto edge01 = CreateHalfEdge(v0, v1, edges);
 	const auto edge12 = CreateHalfEdge(v1, v2, edges);
@@ -70,7 +80,6 @@ shared_ptr<Face> CreateTriangle(
 	edge12->set_next(edge20);
 	edge20->set_next(edge01);
 
-	auto face012 = make_shared<Face>(v0, v1, v2);
 	edge01->set_face(face012);
 	edge12->set_face(face012);
 	edge20->set_face(face012);
@@ -86,7 +95,7 @@ shared_ptr<Face> CreateTriangle(
  * \throw invalid_argument Indicates no edge connecting \p v0 to \p v1 exists in \p edges.
  */
 shared_ptr<HalfEdge> GetHalfEdge(
-	const Vertex& v0, const Vertex& v1, const unordered_map<size_t, shared_ptr<HalfEdge>>& edges) {
+	const Vertex& v0, const Vertex& v1, const HalfEdgeMesh::ElementMap<HalfEdge>& edges) {
 
 	if (const auto iterator = edges.find(hash_value(v0, v1)); iterator == edges.end()) {
 		throw invalid_argument(format("Attempted to retrieve a nonexistent edge: ({},{})", v0, v1));
@@ -101,7 +110,7 @@ shared_ptr<HalfEdge> GetHalfEdge(
  * \param vertices A mapping of mesh vertices by ID.
  * \throw invalid_argument Indicates \p vertex does not exist in \p vertices.
  */
-void DeleteVertex(const Vertex& vertex, map<size_t, shared_ptr<Vertex>>& vertices) {
+void DeleteVertex(const Vertex& vertex, HalfEdgeMesh::VertexMap& vertices) {
 
 	if (const auto iterator = vertices.find(vertex.id()); iterator == vertices.end()) {
 		throw invalid_argument{format("Attempted to delete a nonexistent vertex: {}", vertex)};
@@ -116,7 +125,7 @@ void DeleteVertex(const Vertex& vertex, map<size_t, shared_ptr<Vertex>>& vertice
  * \param edges A mapping of mesh half-edges by ID.
  * \throw invalid_argument Indicates \p edge does not exist in \p edges.
  */
-void DeleteEdge(const HalfEdge& edge, unordered_map<size_t, shared_ptr<HalfEdge>>& edges) {
+void DeleteEdge(const HalfEdge& edge, HalfEdgeMesh::ElementMap<HalfEdge>& edges) {
 
 	for (const auto& edge_key : {hash_value(edge), hash_value(*edge.flip())}) {
 		if (const auto iterator = edges.find(edge_key); iterator == edges.end()) {
@@ -133,7 +142,7 @@ void DeleteEdge(const HalfEdge& edge, unordered_map<size_t, shared_ptr<HalfEdge>
  * \param faces A mapping of mesh faces by ID.
  * \throw invalid_argument Indicates \p face does not exist in \p faces.
  */
-void DeleteFace(const Face& face, unordered_map<size_t, shared_ptr<Face>>& faces) {
+void DeleteFace(const Face& face, HalfEdgeMesh::ElementMap<Face>& faces) {
 
 	if (const auto iterator = faces.find(hash_value(face)); iterator == faces.end()) {
 		throw invalid_argument{format("Attempted to delete a nonexistent face: {}", face)};
@@ -156,8 +165,8 @@ void UpdateIncidentTriangles(
 	const shared_ptr<Vertex>& v_start,
 	const shared_ptr<Vertex>& v_end,
 	const shared_ptr<Vertex>& v_new,
-	unordered_map<size_t, shared_ptr<HalfEdge>>& edges,
-	unordered_map<size_t, shared_ptr<Face>>& faces) {
+	HalfEdgeMesh::ElementMap<HalfEdge>& edges,
+	HalfEdgeMesh::ElementMap<Face>& faces) {
 
 	const auto edge_start = GetHalfEdge(*v_target, *v_start, edges);
 	const auto edge_end = GetHalfEdge(*v_target, *v_end, edges);
@@ -170,7 +179,7 @@ void UpdateIncidentTriangles(
 		const auto vi = edge0i->vertex();
 		const auto vj = edgeij->vertex();
 
-		const auto face_new = CreateTriangle(v_new, vi, vj, edges);
+		const auto face_new = CreateTriangle(v_new, vi, vj, MakeTracked<Face>(MemoryCategory::kFaces, v_new, vi, vj), edges);
 		faces.emplace(hash_value(*face_new), face_new);
 
 		DeleteFace(*edge0i->face(), faces);
@@ -182,40 +191,145 @@ void UpdateIncidentTriangles(
 	DeleteEdge(*edge_end, edges);
 }
 
+/** \brief Clears the links of a half-edge so the elements it refers to can be released. */
+void Unlink(HalfEdge& edge) noexcept {
+	edge.set_next(nullptr);
+	edge.set_flip(nullptr);
+	edge.set_face(nullptr);
+}
+
+/**
+ * \brief Clears the links between mesh elements so elements that refer to each other in a cycle are released.
+ * \param vertices The vertices to unlink.
+ * \param edges The half-edges to unlink.
+ */
+void UnlinkElements(const HalfEdgeMesh::VertexMap& vertices, const HalfEdgeMesh::ElementMap<HalfEdge>& edges) noexcept {
+	for (const auto& vertex : vertices | views::values) {
+		vertex->set_edge(nullptr);
+	}
+	for (const auto& edge : edges | views::values) {
+		Unlink(*edge);
+	}
+}
+
 /**
- * \brief Computes a vertex normal by averaging its face normals weighted by surface area.
- * \param v0 The vertex to compute the normal for.
- * \return The weighted vertex normal.
+ * \brief Validates the indices of a mesh.
+ * \param mesh The mesh to validate.
+ * \throw invalid_argument Indicates an index of \p mesh does not refer to a vertex.
  */
-vec3 ComputeWeightedVertexNormal(const Vertex& v0) {
-	vec3 normal{0.f};
-	auto edgei0 = v0.edge();
-	do {
-		const auto& face = edgei0->face();
-		normal += face->normal() * face->area();
-		edgei0 = edgei0->next()->flip();
-	} while (edgei0 != v0.edge());
-	return normalize(normal);
+void ValidateIndices(const MeshView& mesh) {
+	// mesh views may refer to data from other processes that has not been validated by gfx::Mesh
+	if (const auto iterator = ranges::find_if(mesh.indices, [&](const auto index) { return index >= mesh.positions.size(); });
+		iterator != mesh.indices.end()) {
+		throw invalid_argument{format("Vertex index {} is out of range", *iterator)};
+	}
+}
 }
+
+HalfEdgeMesh::HalfEdgeMesh(const MeshView& mesh)
+	: vertices_{VertexMap::allocator_type{MemoryCategory::kVertices}},
+	  edges_{ElementAllocator<HalfEdge>{MemoryCategory::kHalfEdges}},
+	  faces_{ElementAllocator<Face>{MemoryCategory::kFaces}},
+	  model_transform_{mesh.model_transform} {
+
+	try {
+		ValidateIndices(mesh);
+		// computes the geometry of every face in one vectorized pass rather than once per face
+		Initialize(mesh, {}, ComputeFaceGeometry(mesh.positions, mesh.indices));
+		next_vertex_id_ = mesh.positions.size();
+	} catch (...) {
+		// the destructor does not run when construction fails
+		UnlinkElements(vertices_, edges_);
+		throw;
+	}
+}
+
+HalfEdgeMesh::HalfEdgeMesh(const MeshView& mesh,
+                           const span<const uint64_t> vertex_ids,
+                           const FaceGeometry& face_geometry,
+                           const size_t next_vertex_id)
+	: vertices_{VertexMap::allocator_type{MemoryCategory::kVertices}},
+	  edges_{ElementAllocator<HalfEdge>{MemoryCategory::kHalfEdges}},
+	  faces_{ElementAllocator<Face>{MemoryCategory::kFaces}},
+	  model_transform_{mesh.model_transform},
+	  next_vertex_id_{next_vertex_id} {
+
+	try {
+		ValidateIndices(mesh);
+		if (vertex_ids.size() != mesh.positions.size() || face_geometry.size() != mesh.indices.size() / 3) {
+			throw invalid_argument{"Vertex IDs or face geometry do not match the mesh"};
+		}
+		Initialize(mesh, vertex_ids, face_geometry);
+		if (!vertices_.empty() && vertices_.rbegin()->first >= next_vertex_id_) {
+			throw invalid_argument{format(
+				"Vertex ID {} is not less than the next vertex ID {}", vertices_.rbegin()->first, next_vertex_id_)};
+		}
+	} catch (...) {
+		UnlinkElements(vertices_, edges_);
+		throw;
+	}
+}
+
+HalfEdgeMesh::~HalfEdgeMesh() {
+	UnlinkElements(vertices_, edges_);
 }
 
-HalfEdgeMesh::HalfEdgeMesh(const Mesh& mesh) : model_transform_{mesh.GetModelTransform()} {
-	const auto& positions = mesh.GetPositions();
-	const auto& indices = mesh.GetIndices();
+void HalfEdgeMesh::Initialize(const MeshView& mesh, const span<const uint64_t> vertex_ids, const FaceGeometry& face_geometry) {
+	const auto& positions = mesh.positions;
+	const auto& indices = mesh.indices;
+
+	// vertex IDs are the vertex indices unless given
+	const auto get_vertex_id = [&](const size_t index) noexcept {
+		return vertex_ids.empty() ? index : static_cast<size_t>(vertex_ids[index]);
+	};
 
 	for (size_t i = 0; i < positions.size(); ++i) {
-		vertices_.emplace(i, make_shared<Vertex>(i, positions[i]));
+		const auto id = get_vertex_id(i);
+		if (!vertices_.emplace(id, MakeTracked<Vertex>(MemoryCategory::kVertices, id, positions[i])).second) {
+			throw invalid_argument{format("Vertex ID {} is not unique", id)};
+		}
 	}
 
-	for (size_t i = 0; i < indices.size(); i += 3) {
-		const auto& v0 = vertices_[indices[i]];
-		const auto& v1 = vertices_[indices[i + 1]];
-		const auto& v2 = vertices_[indices[i + 2]];
-		const auto face012 = CreateTriangle(v0, v1, v2, edges_);
+	// reserve the tables up front so large meshes allocate each bucket array once rather than rehashing repeatedly
+	edges_.reserve(indices.size());
+	faces_.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const auto& v0 = vertices_[get_vertex_id(indices[i])];
+		const auto& v1 = vertices_[get_vertex_id(indices[i + 1])];
+		const auto& v2 = vertices_[get_vertex_id(indices[i + 2])];
+
+		const auto face_index = i / 3;
+		if (!(face_geometry.areas[face_index] > 0.f)) {
+			throw invalid_argument{format("({},{},{}) is not a triangle", *v0, *v1, *v2)};
+		}
+
+		// a half-edge can only border a single triangle
+		for (const auto& [vi, vj] : {pair{v0, v1}, pair{v1, v2}, pair{v2, v0}}) {
+			if (const auto iterator = edges_.find(hash_value(*vi, *vj)); iterator != edges_.end() && iterator->second->face()) {
+				throw invalid_argument{format("Edge ({},{}) is non-manifold or inconsistently oriented", *vi, *vj)};
+			}
+		}
+
+		const auto face012 = CreateTriangle(v0,
+		                                    v1,
+		                                    v2,
+		                                    MakeTracked<Face>(MemoryCategory::kFaces,
+		                                                      v0,
+		                                                      v1,
+		                                                      v2,
+		                                                      face_geometry.plane(face_index),
+		                                                      face_geometry.areas[face_index]),
+		                                    edges_);
 		faces_.emplace(hash_value(*face012), face012);
 	}
 
-	next_vertex_id_ = positions.size();
+	// edge traversals assume every half-edge borders a triangle
+	for (const auto& edge : edges_ | views::values) {
+		if (!edge->face()) {
+			throw invalid_argument{format("Mesh is not closed, found boundary edge {}", *edge)};
+		}
+	}
 }
 
 HalfEdgeMesh::operator Mesh() const {
@@ -223,26 +337,47 @@ HalfEdgeMesh::operator Mesh() const {
 	vector<vec3> positions;
 	positions.reserve(vertices_.size());
 
-	vector<vec3> normals;
-	normals.reserve(vertices_.size());
-
 	vector<GLuint> indices;
 	indices.reserve(faces_.size() * 3);
 
 	unordered_map<size_t, GLuint> index_map;
 	for (GLuint i = 0; const auto& vertex : vertices_ | views::values) {
 		positions.push_back(vertex->position());
-		normals.push_back(ComputeWeightedVertexNormal(*vertex));
 		index_map.emplace(vertex->id(), i++);
 	}
 
+	// sort triangles so the output does not depend on the iteration order of the face table
+	vector<array<GLuint, 3>> triangles;
+	triangles.reserve(faces_.size());
 	for (const auto& face : faces_ | views::values) {
-		indices.push_back(index_map.at(face->v0()->id()));
-		indices.push_back(index_map.at(face->v1()->id()));
-		indices.push_back(index_map.at(face->v2()->id()));
+		triangles.push_back({index_map.at(face->v0()->id()), index_map.at(face->v1()->id()), index_map.at(face->v2()->id())});
+	}
+	ranges::sort(triangles);
+	for (const auto& triangle : triangles) {
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
 	}
 
-	return Mesh{positions, {}, normals, indices, model_transform_};
+	auto normals = ComputeVertexNormals(positions, indices);
+	return Mesh{positions, {}, move(normals), indices, model_transform_};
+}
+
+void HalfEdgeMesh::set_snapshot_channel(MeshSnapshotChannel* const snapshot_channel) {
+
+	if (snapshot_channel_) {
+		snapshot_channel_->Flush();
+	}
+
+	snapshot_channel_ = snapshot_channel;
+	if (snapshot_channel_) {
+		snapshot_channel_->Reset(model_transform_);
+		for (const auto& vertex : vertices_ | views::values) {
+			snapshot_channel_->AddVertex(*vertex);
+		}
+		for (const auto& face : faces_ | views::values) {
+			snapshot_channel_->AddFace(*face);
+		}
+		snapshot_channel_->Flush();
+	}
 }
 
 void HalfEdgeMesh::CollapseEdge(const shared_ptr<HalfEdge>& edge01, const shared_ptr<Vertex>& v_new) {
@@ -252,6 +387,17 @@ void HalfEdgeMesh::CollapseEdge(const shared_ptr<HalfEdge>& edge01, const shared
 	const auto v0_next = edge10->next()->vertex();
 	const auto v1_next = edge01->next()->vertex();
 
+	// every half-edge incident to the collapsed vertices is removed
+	vector<shared_ptr<HalfEdge>> removed_edges;
+	for (const auto* const vertex : {v0.get(), v1.get()}) {
+		for (const auto& edgei0 : IncomingHalfEdges(*vertex)) {
+			removed_edges.push_back(edgei0);
+			removed_edges.push_back(edgei0->flip());
+			// faces incident to both vertices are removed twice, which snapshot readers ignore
+			if (snapshot_channel_) snapshot_channel_->RemoveFace(*edgei0->face());
+		}
+	}
+
 	UpdateIncidentTriangles(v0, v1_next, v0_next, v_new, edges_, faces_);
 	UpdateIncidentTriangles(v1, v0_next, v1_next, v_new, edges_, faces_);
 
@@ -264,4 +410,86 @@ void HalfEdgeMesh::CollapseEdge(const shared_ptr<HalfEdge>& edge01, const shared
 	DeleteVertex(*v1, vertices_);
 
 	vertices_.emplace(v_new->id(), v_new);
+
+	if (snapshot_channel_) {
+		snapshot_channel_->RemoveVertex(*v0);
+		snapshot_channel_->RemoveVertex(*v1);
+		snapshot_channel_->AddVertex(*v_new);
+		for (const auto& face : IncidentFaces(*v_new)) {
+			snapshot_channel_->AddFace(*face);
+		}
+		snapshot_channel_->Commit();
+	}
+
+	// removed elements refer to each other, so unlink them to release them along with the removed faces
+	v0->set_edge(nullptr);
+	v1->set_edge(nullptr);
+	for (const auto& edge : removed_edges) {
+		Unlink(*edge);
+	}
+}
+
+void HalfEdgeMesh::FlipEdge(const shared_ptr<HalfEdge>& edge01) {
+	const auto edge10 = edge01->flip();
+	const auto v0 = edge10->vertex();
+	const auto v1 = edge01->vertex();
+	const auto v2 = edge01->next()->vertex();
+	const auto v3 = edge10->next()->vertex();
+
+	if (edges_.contains(hash_value(*v2, *v3))) {
+		throw invalid_argument{format("Flipping edge {} would duplicate edge ({},{})", *edge01, *v2, *v3)};
+	}
+
+	// create the new faces first since they validate their geometry
+	const auto face032 = MakeTracked<Face>(MemoryCategory::kFaces, v0, v3, v2);
+	const auto face312 = MakeTracked<Face>(MemoryCategory::kFaces, v3, v1, v2);
+
+	if (snapshot_channel_) {
+		snapshot_channel_->RemoveFace(*edge01->face());
+		snapshot_channel_->RemoveFace(*edge10->face());
+	}
+
+	DeleteFace(*edge01->face(), faces_);
+	DeleteFace(*edge10->face(), faces_);
+	DeleteEdge(*edge01, edges_);
+
+	// the remaining edges of the quadrilateral are reused, which also relinks the vertex half-edges
+	for (const auto& face : {CreateTriangle(v0, v3, v2, face032, edges_), CreateTriangle(v3, v1, v2, face312, edges_)}) {
+		faces_.emplace(hash_value(*face), face);
+		if (snapshot_channel_) snapshot_channel_->AddFace(*face);
+	}
+
+	Unlink(*edge01);
+	Unlink(*edge10);
+
+	if (snapshot_channel_) snapshot_channel_->Commit();
+}
+
+void HalfEdgeMesh::MoveVertex(const shared_ptr<Vertex>& vertex, const vec3& position) {
+
+	// faces cache their normal, plane, and area, so incident faces are replaced by faces at the new position
+	const auto previous_position = vertex->position();
+	vertex->set_position(position);
+	vector<shared_ptr<Face>> moved_faces;
+	try {
+		for (const auto& face : IncidentFaces(*vertex)) {
+			moved_faces.push_back(MakeTracked<Face>(MemoryCategory::kFaces, face->v0(), face->v1(), face->v2()));
+		}
+	} catch (...) {
+		vertex->set_position(previous_position);
+		throw;
+	}
+
+	for (auto moved_face = moved_faces.begin(); const auto& edgei0 : IncomingHalfEdges(*vertex)) {
+		const auto& face = *moved_face++;
+		edgei0->set_face(face);
+		edgei0->next()->set_face(face);
+		edgei0->next()->next()->set_face(face);
+		faces_[hash_value(*face)] = face;
+	}
+
+	if (snapshot_channel_) {
+		snapshot_channel_->AddVertex(*vertex);
+		snapshot_channel_->Commit();
+	}
 }
@@ -1,19 +1,30 @@
 #pragma once
 
 #include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <span>
 #include <unordered_map>
 
+#include "concurrency/large_array_allocator.h"
+#include "concurrency/memory_tracker.h"
+
 namespace gfx {
 class Mesh;
+struct MeshView;
 }
 
 namespace geometry {
 class Face;
 class HalfEdge;
+class MeshSnapshotChannel;
 class Vertex;
+struct FaceGeometry;
 
 /**
  * \brief An edge centric data structure used to represent a triangle mesh.
@@ -25,39 +36,118 @@ class Vertex;
 class HalfEdgeMesh {
 
 public:
+	/** \brief A mapping of mesh vertices by ID whose memory is attributed to \c concurrency::MemoryCategory::kVertices. */
+	using VertexMap = std::map<std::size_t,
+	                           std::shared_ptr<Vertex>,
+	                           std::less<std::size_t>,
+	                           concurrency::TrackingAllocator<std::pair<const std::size_t, std::shared_ptr<Vertex>>>>;
+
+	/** \brief The allocator of an element table, which tracks its memory and can back its bucket array with huge pages. */
+	template <typename T>
+	using ElementAllocator = concurrency::TrackingAllocator<
+		std::pair<const std::size_t, std::shared_ptr<T>>,
+		concurrency::LargeArrayAllocator<std::pair<const std::size_t, std::shared_ptr<T>>>>;
+
+	/** \brief A mapping of mesh elements by ID. */
+	template <typename T>
+	using ElementMap = std::unordered_map<std::size_t, std::shared_ptr<T>, std::hash<std::size_t>, std::equal_to<std::size_t>, ElementAllocator<T>>;
+
 	/**
 	 * \brief Initializes a half-edge mesh.
 	 * \param mesh An indexed triangle mesh to construct the half-edge mesh from.
+	 * \throw std::invalid_argument Indicates \p mesh is not a closed, consistently oriented manifold or has indices
+	 *        that do not refer to a vertex.
 	 */
-	explicit HalfEdgeMesh(const gfx::Mesh& mesh);
+	explicit HalfEdgeMesh(const gfx::MeshView& mesh);
 
-	/** \brief Defines the conversion operator back to a triangle mesh. */
+	/**
+	 * \brief Initializes a half-edge mesh with existing vertex IDs and face geometry (e.g., to resume simplification).
+	 * \param mesh An indexed triangle mesh to construct the half-edge mesh from.
+	 * \param vertex_ids The ID of each vertex in \p mesh.
+	 * \param face_geometry The geometry of each triangle in \p mesh.
+	 * \param next_vertex_id The first ID returned by \c next_vertex_id, which must exceed every ID in \p vertex_ids.
+	 * \throw std::invalid_argument Indicates \p mesh is not a closed, consistently oriented manifold, has indices that
+	 *        do not refer to a vertex, or is inconsistent with \p vertex_ids, \p face_geometry, or \p next_vertex_id.
+	 */
+	HalfEdgeMesh(const gfx::MeshView& mesh,
+	             std::span<const std::uint64_t> vertex_ids,
+	             const FaceGeometry& face_geometry,
+	             std::size_t next_vertex_id);
+
+	/**
+	 * \brief Destroys the half-edge mesh.
+	 * \details Mesh elements refer to each other through shared pointers, so links between them are cleared to release
+	 *          elements that form reference cycles. Elements must not be traversed after the mesh is destroyed.
+	 */
+	~HalfEdgeMesh();
+
+	HalfEdgeMesh(const HalfEdgeMesh&) = delete;
+	HalfEdgeMesh& operator=(const HalfEdgeMesh&) = delete;
+
+	/**
+	 * \brief Defines the conversion operator back to a triangle mesh.
+	 * \details Vertices are ordered by ID and triangles by their vertex indices, so meshes with the same vertex IDs and
+	 *          connectivity convert to identical buffers.
+	 */
 	explicit operator gfx::Mesh() const;
 
 	/** \brief Gets a mapping of mesh vertices by ID. */
-	[[nodiscard]] const std::map<std::size_t, std::shared_ptr<Vertex>>& vertices() const noexcept { return vertices_; }
+	[[nodiscard]] const VertexMap& vertices() const noexcept { return vertices_; }
 
 	/** \brief Gets a mapping of mesh half-edges by ID. */
-	[[nodiscard]] const std::unordered_map<std::size_t, std::shared_ptr<HalfEdge>>& edges() const noexcept { return edges_; }
+	[[nodiscard]] const ElementMap<HalfEdge>& edges() const noexcept { return edges_; }
 
 	/** \brief Gets a mapping of mesh faces by ID. */
-	[[nodiscard]] const std::unordered_map<std::size_t, std::shared_ptr<Face>>& faces() const noexcept { return faces_; }
+	[[nodiscard]] const ElementMap<Face>& faces() const noexcept { return faces_; }
 
 	/** \brief Gets a unique vertex ID that can be used to construct a new vertex in the half-edge mesh. */
 	[[nodiscard]] std::size_t next_vertex_id() noexcept { return next_vertex_id_++; }
 
+	/** \brief Gets the number of vertex IDs assigned so far, which is the ID \c next_vertex_id returns next. */
+	[[nodiscard]] std::size_t vertex_id_count() const noexcept { return next_vertex_id_; }
+
+	/**
+	 * \brief Publishes the mesh and every subsequent edge collapse to a snapshot channel.
+	 * \details Attaching a channel resets it and flushes the current mesh to it. Each edge collapse is then committed
+	 *          as an epoch, and detaching the channel flushes any changes that have not been published yet.
+	 * \param snapshot_channel The channel to publish to, or \c nullptr to detach the current channel. The channel must
+	 *                         remain valid until it is detached or the mesh is destroyed.
+	 */
+	void set_snapshot_channel(MeshSnapshotChannel* snapshot_channel);
+
 	/**
 	 * \brief Collapses an edge into a single vertex and updates all incident edges to connect to that vertex.
 	 * \param edge01 The edge from vertex \c v0 to \c v1 to collapse.
 	 * \param v_new The vertex to collapse the edge onto.
+	 * \note The links of removed elements are cleared, so callers must gather anything they need from the neighborhood
+	 *       of \p edge01 before collapsing it.
 	 */
 	void CollapseEdge(const std::shared_ptr<HalfEdge>& edge01, const std::shared_ptr<Vertex>& v_new);
 
+	/**
+	 * \brief Replaces an edge shared by two triangles with the edge connecting the vertices opposite to it.
+	 * \param edge01 The edge from vertex \c v0 to \c v1 to flip, whose triangles are replaced along with it.
+	 * \throw std::invalid_argument Indicates the opposite vertices are already connected by an edge or would form a
+	 *        degenerate triangle, in which case the mesh is unchanged.
+	 */
+	void FlipEdge(const std::shared_ptr<HalfEdge>& edge01);
+
+	/**
+	 * \brief Moves a vertex and updates the geometry of its incident faces.
+	 * \param vertex The vertex to move.
+	 * \param position The new vertex position.
+	 * \throw std::invalid_argument Indicates an incident face would degenerate, in which case the mesh is unchanged.
+	 */
+	void MoveVertex(const std::shared_ptr<Vertex>& vertex, const glm::vec3& position);
+
 private:
-	std::map<std::size_t, std::shared_ptr<Vertex>> vertices_;
-	std::unordered_map<std::size_t, std::shared_ptr<HalfEdge>> edges_;
-	std::unordered_map<std::size_t, std::shared_ptr<Face>> faces_;
+	void Initialize(const gfx::MeshView& mesh, std::span<const std::uint64_t> vertex_ids, const FaceGeometry& face_geometry);
+
+	VertexMap vertices_;
+	ElementMap<HalfEdge> edges_;
+	ElementMap<Face> faces_;
 	glm::mat4 model_transform_;
 	std::size_t next_vertex_id_;
+	MeshSnapshotChannel* snapshot_channel_ = nullptr;
 };
 }
@@ -0,0 +1,143 @@
+#include "geometry/mesh_culler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "concurrency/thread_pool.h"
+#include "geometry/ray_caster.h"
+
+using namespace concurrency;
+using namespace geometry;
+using namespace gfx;
+using namespace glm;
+using namespace std;
+
+namespace {
+
+/**
+ * \brief The barycentric coordinates of the points of each triangle rays are cast from: its centroid and the midpoints
+ *        between its centroid and each vertex, so triangles partially covered by other parts are kept.
+ */
+const array<vec3, 4> kSamplePoints{vec3{1.f / 3.f},
+                                   vec3{2.f / 3.f, 1.f / 6.f, 1.f / 6.f},
+                                   vec3{1.f / 6.f, 2.f / 3.f, 1.f / 6.f},
+                                   vec3{1.f / 6.f, 1.f / 6.f, 2.f / 3.f}};
+
+/**
+ * \brief Finds the connected components of a mesh.
+ * \param vertex_count The number of vertices in the mesh.
+ * \param triangle_count The number of triangles in the mesh.
+ * \param get_index Gets the vertex index at a position in the triangle list.
+ * \return The component of each triangle, numbered consecutively from zero.
+ */
+vector<size_t> FindComponents(const size_t vertex_count, const size_t triangle_count, const auto& get_index) {
+
+	// union-find over vertices joined by the triangles that reference them
+	vector<size_t> parents(vertex_count);
+	iota(parents.begin(), parents.end(), size_t{0});
+	const auto find = [&](size_t vertex) {
+		while (parents[vertex] != vertex) vertex = parents[vertex] = parents[parents[vertex]];
+		return vertex;
+	};
+	for (size_t i = 0; i < triangle_count; ++i) {
+		const auto root = find(get_index(i * 3));
+		for (size_t corner = 1; corner < 3; ++corner) parents[find(get_index(i * 3 + corner))] = root;
+	}
+
+	vector<size_t> component_ids(vertex_count, numeric_limits<size_t>::max());
+	vector<size_t> components(triangle_count);
+	size_t component_count = 0;
+	for (size_t i = 0; i < triangle_count; ++i) {
+		auto& component_id = component_ids[find(get_index(i * 3))];
+		if (component_id == numeric_limits<size_t>::max()) component_id = component_count++;
+		components[i] = component_id;
+	}
+	return components;
+}
+}
+
+Mesh mesh::RemoveHiddenTriangles(const MeshView& mesh, const unsigned int view_count) {
+
+	if (view_count == 0) throw invalid_argument{"Hidden triangles must be classified from at least one view"};
+
+	const auto& positions = mesh.positions;
+	const auto& indices = mesh.indices;
+	const auto get_index = [&](const size_t i) { return indices.empty() ? static_cast<GLuint>(i) : indices[i]; };
+
+	const RayCaster ray_caster{positions, indices};
+	const auto triangle_count = ray_caster.size();
+	const auto directions = SampleSphere(view_count);
+	const auto components = FindComponents(positions.size(), triangle_count, get_index);
+
+	// rays start slightly off each triangle on the side they leave from so they do not hit it due to rounding errors
+	const auto ray_offset = 1e-4f * length(ray_caster.box_max() - ray_caster.box_min());
+
+	// each task casts rays along a range of views for every triangle of a component not yet seen, since a component
+	// seen from any view is visible, the result is independent of which task sees it first
+	vector<atomic<bool>> visible(components.empty() ? 0 : *ranges::max_element(components) + 1);
+	ThreadPool::Default().ParallelFor(0, directions.size(), 1, [&](const size_t begin, const size_t end) {
+		for (auto view = begin; view < end; ++view) {
+			const auto& direction = directions[view];
+			for (size_t i = 0; i < triangle_count; ++i) {
+				auto& component_visible = visible[components[i]];
+				if (component_visible.load(memory_order_relaxed)) continue;
+
+				const array triangle{
+					positions[get_index(i * 3)], positions[get_index(i * 3 + 1)], positions[get_index(i * 3 + 2)]};
+				const auto normal = cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+				const auto normal_length = length(normal);
+				const auto offset = normal_length > 0.f
+					? normal * (dot(normal, direction) < 0.f ? -ray_offset : ray_offset) / normal_length
+					: vec3{0.f};
+
+				for (const auto& weights : kSamplePoints) {
+					const auto origin = triangle[0] * weights[0] + triangle[1] * weights[1] + triangle[2] * weights[2] + offset;
+					if (!ray_caster.IsOccluded(origin, direction)) {
+						component_visible.store(true, memory_order_relaxed);
+						break;
+					}
+				}
+			}
+		}
+	});
+
+	// compact the triangles of visible components and the vertices they reference in their original order
+	vector<vec3> visible_positions;
+	vector<vec2> visible_texture_coordinates;
+	vector<vec3> visible_normals;
+	vector<GLuint> visible_indices;
+	vector<GLuint> index_map(positions.size(), numeric_limits<GLuint>::max());
+	vec3 box_min{numeric_limits<float>::max()};
+	vec3 box_max{numeric_limits<float>::lowest()};
+
+	for (size_t i = 0; i < triangle_count; ++i) {
+		if (!visible[components[i]].load(memory_order_relaxed)) continue;
+		for (size_t corner = 0; corner < 3; ++corner) {
+			const auto index = get_index(i * 3 + corner);
+			if (index_map[index] == numeric_limits<GLuint>::max()) {
+				index_map[index] = static_cast<GLuint>(visible_positions.size());
+				visible_positions.push_back(positions[index]);
+				if (!mesh.texture_coordinates.empty()) visible_texture_coordinates.push_back(mesh.texture_coordinates[index]);
+				if (!mesh.normals.empty()) visible_normals.push_back(mesh.normals[index]);
+				box_min = min(box_min, positions[index]);
+				box_max = max(box_max, positions[index]);
+			}
+			visible_indices.push_back(index_map[index]);
+		}
+	}
+
+	return Mesh{move(visible_positions),
+	            move(visible_texture_coordinates),
+	            move(visible_normals),
+	            move(visible_indices),
+	            mesh.model_transform,
+	            box_min,
+	            box_max};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "graphics/mesh.h"
+
+namespace geometry::mesh {
+
+/**
+ * \brief Removes parts of a mesh that cannot be seen from outside it.
+ * \details A part is a connected component of triangles sharing vertices. A triangle is visible if a ray cast from one
+ *          of several points on it along one of \p view_count directions evenly distributed over the sphere escapes the
+ *          mesh, and a part is kept whole if any of its triangles is visible, so closed parts stay closed and can still
+ *          be simplified. Rays are cast from both sides of each triangle, so open surfaces are kept, while fully
+ *          enclosed parts (e.g., the internals of CAD assemblies) are removed. Views are classified in parallel, and the
+ *          result does not depend on the thread count. Since visibility is sampled, parts visible only through gaps
+ *          narrower than the spacing between views may be removed.
+ * \param mesh The mesh to cull. Parts are only connected through shared vertex indices, so it should be welded first.
+ *             If the mesh has no indices, its positions are treated as a triangle list and each triangle is a part.
+ * \param view_count The number of view directions to sample.
+ * \return The triangles of the visible parts of \p mesh in their original order. The mesh only contains vertices
+ *         referenced by its triangles and keeps the texture coordinates, normals, and model transform of \p mesh.
+ * \throw std::invalid_argument Indicates \p view_count is zero.
+ */
+gfx::Mesh RemoveHiddenTriangles(const gfx::MeshView& mesh, unsigned int view_count = 64);
+}
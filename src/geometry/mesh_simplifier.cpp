@@ -1,13 +1,21 @@
 #include "geometry/mesh_simplifier.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 #include <limits>
-#include <queue>
+#include <numbers>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #pragma warning(disable:4701 6001)
@@ -15,11 +23,21 @@
 #include <glm/gtc/matrix_access.hpp>
 #pragma warning(default:4701 6001)
 
+#include "concurrency/large_array_allocator.h"
+#include "concurrency/memory_tracker.h"
+#include "concurrency/thread_pool.h"
+#include "geometry/face.h"
 #include "geometry/half_edge.h"
 #include "geometry/half_edge_mesh.h"
+#include "geometry/mesh_snapshot.h"
+#include "geometry/one_ring.h"
+#include "geometry/ray_caster.h"
 #include "geometry/vertex.h"
 #include "graphics/mesh.h"
+#include "io/content_hash.h"
+#include "io/simplification_checkpoint.h"
 
+using namespace concurrency;
 using namespace geometry;
 using namespace glm;
 using namespace gfx;
@@ -27,44 +45,185 @@ using namespace std;
 
 namespace {
 
+/** \brief The minimum number of elements processed by a single task when mesh processing is parallelized. */
+constexpr size_t kParallelGrainSize = 1u << 14;
+
+/** \brief The largest buffer a simplifier retains between meshes, larger buffers are released once no longer needed. */
+constexpr size_t kMaxRetainedBufferBytes = size_t{4} << 20;
+
+/** \brief The allocator of large simplification arrays, which tracks their memory and can back them with huge pages. */
+template <typename T>
+using LargeArrayTrackingAllocator = TrackingAllocator<T, LargeArrayAllocator<T>>;
+
+/** \brief A mapping by ID whose bucket array is allocated with \c LargeArrayAllocator. */
+template <typename T>
+using IdMap = unordered_map<size_t, T, hash<size_t>, equal_to<size_t>, LargeArrayTrackingAllocator<pair<const size_t, T>>>;
+
+/**
+ * \brief The error quadric of each vertex indexed by its ID.
+ * \details Vertex IDs are dense since they start at zero (or at the IDs of a checkpoint) and each collapse assigns the
+ *          next one, so an array avoids hashing and keeps quadrics on the pages of the threads that computed them.
+ *          Entries of removed vertices remain but are never read again.
+ */
+using QuadricArray = vector<mat4, LargeArrayTrackingAllocator<mat4>>;
+
+/**
+ * \brief Empties an array or hash table, keeping its memory for the next mesh unless it is too large to retain.
+ * \param container The container to empty.
+ */
+template <typename Container>
+void Recycle(Container& container) {
+	const auto bytes = [&] {
+		if constexpr (requires { container.capacity(); }) {
+			return container.capacity() * sizeof(typename Container::value_type);
+		} else {
+			return container.bucket_count() * sizeof(void*);
+		}
+	}();
+	if (bytes > kMaxRetainedBufferBytes) {
+		Container{container.get_allocator()}.swap(container);
+	} else {
+		container.clear();
+	}
+}
+
 /**
  * \brief Gets a canonical representation of a half-edge used to disambiguate between its flip edge.
  * \param edge The half-edge to disambiguate.
- * \return For two vertices connected by an edge, returns the half-edge pointing to the vertex with the smallest ID.
+ * \return For two vertices connected by an edge, returns the half-edge pointing to the vertex with the smallest ID. The
+ *         result refers to \p edge or its flip edge in the mesh.
  */
-shared_ptr<HalfEdge> GetMinEdge(const shared_ptr<HalfEdge>& edge) noexcept {
+const shared_ptr<HalfEdge>& GetMinEdge(const shared_ptr<HalfEdge>& edge) noexcept {
 	return min<>(edge, edge->flip(), [](const auto& edge01, const auto& edge10) noexcept {
 		return edge01->vertex()->id() < edge10->vertex()->id();
 	});
 }
 
+/**
+ * \brief Gets a key that identifies an edge independently of memory addresses and hash table iteration order.
+ * \param edge The half-edge to identify.
+ * \return The IDs of the source and target vertices of \p edge.
+ */
+pair<size_t, size_t> GetEdgeKey(const HalfEdge& edge) noexcept {
+	return {edge.flip()->vertex()->id(), edge.vertex()->id()};
+}
+
+/**
+ * \brief Estimates the visibility of each face from the fraction of hemisphere directions along which it is unoccluded.
+ * \param half_edge_mesh The mesh whose faces to evaluate.
+ * \param options The simplification options that determine the number of sampled directions and the weight of hidden
+ *                faces.
+ * \param thread_pool The thread pool that casts rays.
+ * \return The quadric weight of each face by face key, which ranges from the hidden weight to one.
+ */
+IdMap<float> ComputeVisibilityWeights(const HalfEdgeMesh& half_edge_mesh,
+                                      const mesh::SimplificationOptions& options,
+                                      ThreadPool& thread_pool) {
+
+	// faces are ordered by key so the ray caster does not depend on hash table iteration order
+	vector<pair<size_t, const Face*>> faces;
+	faces.reserve(half_edge_mesh.faces().size());
+	for (const auto& [face_key, face] : half_edge_mesh.faces()) {
+		faces.emplace_back(face_key, face.get());
+	}
+	ranges::sort(faces, {}, &pair<size_t, const Face*>::first);
+
+	vector<vec3> positions;
+	positions.reserve(faces.size() * 3);
+	for (const auto& face : faces | views::values) {
+		positions.push_back(face->v0()->position());
+		positions.push_back(face->v1()->position());
+		positions.push_back(face->v2()->position());
+	}
+	const RayCaster ray_caster{positions, {}};
+
+	const auto directions = SampleSphere(options.visibility_samples);
+
+	// rays start slightly above each face so they do not hit it or its neighbors due to rounding errors
+	const auto ray_offset = 1e-4f * length(ray_caster.box_max() - ray_caster.box_min());
+	vector<float> weights(faces.size());
+	const auto grain_size = kParallelGrainSize / directions.size() + 1;
+	thread_pool.ParallelFor(0, faces.size(), grain_size, [&](const size_t begin, const size_t end) {
+		for (auto i = begin; i < end; ++i) {
+			const auto& normal = faces[i].second->normal();
+			const auto origin = (positions[i * 3] + positions[i * 3 + 1] + positions[i * 3 + 2]) / 3.f + normal * ray_offset;
+			size_t sampled_directions = 0, visible_directions = 0;
+			for (const auto& direction : directions) {
+				if (dot(direction, normal) <= 0.f) continue;
+				++sampled_directions;
+				visible_directions += !ray_caster.IsOccluded(origin, direction);
+			}
+			const auto visibility = sampled_directions > 0
+				? static_cast<float>(visible_directions) / static_cast<float>(sampled_directions)
+				: 1.f;
+			weights[i] = options.hidden_weight + (1.f - options.hidden_weight) * visibility;
+		}
+	});
+
+	IdMap<float> face_weights{IdMap<float>::allocator_type{MemoryCategory::kQuadrics}};
+	face_weights.reserve(faces.size());
+	for (size_t i = 0; i < faces.size(); ++i) {
+		face_weights.emplace(faces[i].first, weights[i]);
+	}
+	return face_weights;
+}
+
 /**
  * \brief Computes the error quadric for a vertex.
  * \param vertex The vertex to evaluate.
- * \return The summation of quadrics for all triangles incident to \p vertex.
+ * \param options The simplification options that determine how features at \p vertex are weighted.
+ * \param face_weights The weight of each face quadric by face key, null to weight faces equally.
+ * \return The summation of quadrics for all triangles incident to \p vertex, scaled by the curvature at \p vertex and
+ *         combined with the constraint planes of incident feature edges if \p options preserve features.
  */
-mat4 ComputeQuadric(const Vertex& vertex) {
+mat4 ComputeQuadric(const Vertex& vertex, const mesh::SimplificationOptions& options, const IdMap<float>* const face_weights) {
+	static constexpr auto kEpsilon = numeric_limits<float>::epsilon();
 	mat4 quadric{0.f};
-	auto edgei0 = vertex.edge();
-	do {
-		const auto& position = vertex.position();
-		const auto& normal = edgei0->face()->normal();
-		const vec4 plane{normal, -dot(position, normal)};
-		quadric += outerProduct(plane, plane);
-		edgei0 = edgei0->next()->flip();
-	} while (edgei0 != vertex.edge());
-	return quadric;
+	mat4 feature_quadric{0.f};
+	auto total_dihedral_angle = 0.f;
+	const auto& position = vertex.position();
+	for (const auto& edgei0 : IncomingHalfEdges(vertex)) {
+		const auto& face = *edgei0->face();
+		const auto& normal = face.normal();
+		const auto plane = face.plane();
+		const auto face_weight = face_weights ? face_weights->at(hash_value(face)) : 1.f;
+		quadric += outerProduct(plane, plane) * face_weight;
+
+		// each incident edge is visited once, its dihedral angle is the angle between the normals of its two faces
+		if (options.preserve_features) {
+			const auto& flip_normal = edgei0->flip()->face()->normal();
+			const auto dihedral_angle = std::acos(std::clamp(dot(normal, flip_normal), -1.f, 1.f));
+			total_dihedral_angle += dihedral_angle;
+
+			if (dihedral_angle >= options.feature_angle) {
+				// constrain the vertex to planes through the edge perpendicular to each face to preserve the crease
+				const auto edge_direction = position - edgei0->flip()->vertex()->position();
+				for (const auto& face_normal : {normal, flip_normal}) {
+					if (const auto constraint_normal = cross(edge_direction, face_normal);
+						dot(constraint_normal, constraint_normal) > kEpsilon) {
+						const auto unit_normal = normalize(constraint_normal);
+						const vec4 constraint_plane{unit_normal, -dot(position, unit_normal)};
+						feature_quadric += outerProduct(constraint_plane, constraint_plane) * face_weight;
+					}
+				}
+			}
+		}
+	}
+
+	if (!options.preserve_features) return quadric;
+
+	// the total dihedral angle in turns is a scale-invariant measure of the discrete mean curvature at the vertex
+	const auto curvature = total_dihedral_angle / (2.f * numbers::pi_v<float>);
+	return quadric * (1.f + options.curvature_weight * curvature) + feature_quadric * options.feature_weight;
 }
 
 /**
  * \brief Determines the optimal vertex position for an edge contraction.
- * \param vertex_id The ID to use for the newly created vertex.
  * \param edge01 The half-edge to evaluate.
  * \param quadrics A mapping of error quadrics by vertex ID.
- * \return The optimal vertex and cost associated with collapsing \p edge01.
+ * \return The optimal vertex position and cost associated with collapsing \p edge01.
  */
-pair<shared_ptr<Vertex>, float> GetOptimalEdgeContractionVertex(
-	const size_t vertex_id, const HalfEdge& edge01, const unordered_map<size_t, mat4>& quadrics) {
+pair<vec3, float> GetOptimalEdgeContractionPosition(const HalfEdge& edge01, const QuadricArray& quadrics) {
 
 	const auto v0 = edge01.flip()->vertex();
 	const auto v1 = edge01.vertex();
@@ -81,8 +240,7 @@ pair<shared_ptr<Vertex>, float> GetOptimalEdgeContractionVertex(
 	// if the upper 3x3 matrix of the error quadric is not invertible, average the edge vertices
 	static constexpr auto kEpsilon = numeric_limits<float>::epsilon();
 	if (std::abs(determinant(Q)) < kEpsilon || std::abs(d) < kEpsilon) {
-		const auto position = (v0->position() + v1->position()) / 2.f;
-		return {make_shared<Vertex>(vertex_id, position), 0.f};
+		return {(v0->position() + v1->position()) / 2.f, 0.f};
 	}
 
 	const auto Q_inv = inverse(Q);
@@ -92,7 +250,7 @@ pair<shared_ptr<Vertex>, float> GetOptimalEdgeContractionVertex(
 	position /= position.w;
 	const auto cost = dot(position, q01 * position);
 
-	return {make_shared<Vertex>(vertex_id, position), cost};
+	return {vec3{position}, cost};
 }
 
 /**
@@ -100,160 +258,964 @@ pair<shared_ptr<Vertex>, float> GetOptimalEdgeContractionVertex(
  * \param edge01 The half-edge to evaluate.
  * \return \c true if the removal of \p edge01 will produce a non-manifold, otherwise \c false.
  */
-bool WillDegenerate(const shared_ptr<HalfEdge>& edge01) {
-	const auto v0 = edge01->flip()->vertex();
-	const auto v1_next = edge01->next()->vertex();
-	const auto v0_next = edge01->flip()->next()->vertex();
-	unordered_map<size_t, shared_ptr<Vertex>> neighborhood;
+bool WillDegenerate(const HalfEdge& edge01) {
+	const auto& v0 = edge01.flip()->vertex();
+	const auto& v1 = edge01.vertex();
+	const auto& v1_next = edge01.next()->vertex();
+	const auto& v0_next = edge01.flip()->next()->vertex();
+	unordered_set<size_t> neighborhood;
 
-	for (auto iterator = edge01->next(); iterator != edge01->flip(); iterator = iterator->flip()->next()) {
-		if (const auto vertex = iterator->vertex(); vertex != v0 && vertex != v1_next && vertex != v0_next) {
-			neighborhood.emplace(hash_value(*vertex), vertex);
+	for (const auto& vertex : AdjacentVertices(*v1)) {
+		if (vertex != v0 && vertex != v1_next && vertex != v0_next) {
+			neighborhood.insert(vertex->id());
 		}
 	}
 
-	for (auto iterator = edge01->flip()->next(); iterator != edge01; iterator = iterator->flip()->next()) {
-		if (const auto vertex = iterator->vertex(); neighborhood.contains(hash_value(*vertex))) {
-			return true;
+	return ranges::any_of(AdjacentVertices(*v0), [&](const auto& vertex) { return neighborhood.contains(vertex->id()); });
+}
+
+/**
+ * \brief Determines if the contraction of an edge will fold over or flatten a triangle.
+ * \param edge01 The half-edge to evaluate.
+ * \param position The position of the vertex \p edge01 is collapsed onto.
+ * \return \c true if a triangle that remains after collapsing \p edge01 onto \p position reverses its orientation or
+ *         degenerates to a sliver, otherwise \c false.
+ */
+bool WillFoldOver(const HalfEdge& edge01, const vec3& position) {
+	static constexpr auto kEpsilon = numeric_limits<float>::epsilon();
+	const auto& face01 = edge01.face();
+	const auto& face10 = edge01.flip()->face();
+
+	for (const auto* const vertex : {edge01.flip()->vertex().get(), edge01.vertex().get()}) {
+		for (const auto& edgei0 : IncomingHalfEdges(*vertex)) {
+			// the faces incident to the edge are removed by the contraction
+			if (const auto& face = edgei0->face(); face != face01 && face != face10) {
+				const auto edge_a = edgei0->next()->vertex()->position() - position;
+				const auto edge_b = edgei0->flip()->vertex()->position() - position;
+				const auto normal = cross(edge_a, edge_b);
+				if (dot(normal, face->normal()) <= kEpsilon * (dot(edge_a, edge_a) + dot(edge_b, edge_b))) {
+					return true;
+				}
+			}
 		}
 	}
 
 	return false;
 }
 
+/** \brief The cosine of the largest angle between the normals of two triangles whose shared edge may be flipped. */
+constexpr auto kMinFlipNormalCosine = .95f;
+
+/** \brief The factor by which a flip or vertex move must raise the quality of the worst triangle it changes. */
+constexpr auto kMinQualityGain = 1.001f;
+
+/**
+ * \brief Computes the quadric error of a position.
+ * \param quadric The error quadric to evaluate.
+ * \param position The position to evaluate.
+ * \return The sum of squared distances of \p position to the planes of \p quadric.
+ */
+float ComputeQuadricError(const mat4& quadric, const vec3& position) noexcept {
+	const vec4 point{position, 1.f};
+	return dot(point, quadric * point);
+}
+
+/**
+ * \brief Computes the shape quality of a triangle.
+ * \param p0,p1,p2 The triangle vertex positions.
+ * \return A value that is one for equilateral triangles and approaches zero as a triangle degenerates to a sliver.
+ */
+float ComputeTriangleQuality(const vec3& p0, const vec3& p1, const vec3& p2) noexcept {
+	const auto edge01 = p1 - p0;
+	const auto edge12 = p2 - p1;
+	const auto edge20 = p0 - p2;
+	const auto squared_perimeter = dot(edge01, edge01) + dot(edge12, edge12) + dot(edge20, edge20);
+	if (!(squared_perimeter > 0.f)) return 0.f;
+	return 2.f * numbers::sqrt3_v<float> * length(cross(edge01, edge20)) / squared_perimeter;
+}
+
+/**
+ * \brief Determines if flipping an edge improves the shape of its triangles without leaving the surface.
+ * \param edge01 The half-edge to evaluate.
+ * \param edges A mapping of mesh half-edges by ID.
+ * \param quadrics A mapping of error quadrics by vertex ID.
+ * \param error_bound The largest quadric error the flipped edge may have at its midpoint.
+ * \return \c true if \p edge01 borders nearly coplanar triangles, flipping it raises the quality of the worst of them,
+ *         and the flipped edge is within \p error_bound of the source triangles of both its vertices.
+ */
+bool ShouldFlip(const HalfEdge& edge01,
+                const HalfEdgeMesh::ElementMap<HalfEdge>& edges,
+                const QuadricArray& quadrics,
+                const float error_bound) {
+	const auto& normal012 = edge01.face()->normal();
+	const auto& normal103 = edge01.flip()->face()->normal();
+	if (dot(normal012, normal103) < kMinFlipNormalCosine) return false;
+
+	const auto& v0 = *edge01.flip()->vertex();
+	const auto& v1 = *edge01.vertex();
+	const auto& v2 = *edge01.next()->vertex();
+	const auto& v3 = *edge01.flip()->next()->vertex();
+	if (edges.contains(hash_value(v2, v3))) return false;
+
+	const auto& p0 = v0.position();
+	const auto& p1 = v1.position();
+	const auto& p2 = v2.position();
+	const auto& p3 = v3.position();
+	const auto quality = std::min(ComputeTriangleQuality(p0, p1, p2), ComputeTriangleQuality(p1, p0, p3));
+	const auto flipped_quality = std::min(ComputeTriangleQuality(p0, p3, p2), ComputeTriangleQuality(p3, p1, p2));
+	if (!(flipped_quality > quality * kMinQualityGain)) return false;
+
+	// the flipped triangles must face the same way as the triangles they replace
+	for (const auto& normal : {cross(p3 - p0, p2 - p0), cross(p1 - p3, p2 - p3)}) {
+		const auto unit_normal = normalize(normal);
+		if (dot(unit_normal, normal012) < kMinFlipNormalCosine || dot(unit_normal, normal103) < kMinFlipNormalCosine) {
+			return false;
+		}
+	}
+
+	const auto midpoint = (p2 + p3) / 2.f;
+	return ComputeQuadricError(quadrics.at(v2.id()), midpoint) <= error_bound
+		&& ComputeQuadricError(quadrics.at(v3.id()), midpoint) <= error_bound;
+}
+
+/**
+ * \brief Determines where to move a vertex to improve the shape of its incident triangles.
+ * \param vertex The vertex to evaluate.
+ * \param quadrics A mapping of error quadrics by vertex ID.
+ * \param error_bound The largest quadric error the vertex may have at its new position.
+ * \return The position toward the centroid of the neighbors of \p vertex within its tangent plane (backing off by
+ *         halves) that raises the quality of the worst incident triangle without folding a triangle over or exceeding
+ *         \p error_bound, or \c std::nullopt if there is none.
+ */
+optional<vec3> ComputeRelaxedPosition(const Vertex& vertex, const QuadricArray& quadrics, const float error_bound) {
+	const auto& position = vertex.position();
+	vec3 centroid{0.f};
+	vec3 normal{0.f};
+	auto valence = 0.f;
+	auto quality = numeric_limits<float>::infinity();
+	for (const auto& edgei0 : IncomingHalfEdges(vertex)) {
+		const auto& face = *edgei0->face();
+		const auto& pi = edgei0->flip()->vertex()->position();
+		centroid += pi;
+		normal += face.normal() * face.area();
+		valence += 1.f;
+		quality = std::min(quality, ComputeTriangleQuality(position, edgei0->next()->vertex()->position(), pi));
+	}
+	if (!(dot(normal, normal) > 0.f)) return nullopt;
+
+	// move within the tangent plane so relaxation slides vertices along the surface rather than smoothing it
+	normal = normalize(normal);
+	auto displacement = centroid / valence - position;
+	displacement -= normal * dot(normal, displacement);
+
+	const auto& quadric = quadrics.at(vertex.id());
+	for (auto step = 1.f; step >= .25f; step /= 2.f) {
+		const auto relaxed_position = position + displacement * step;
+		if (ComputeQuadricError(quadric, relaxed_position) > error_bound) continue;
+
+		auto relaxed_quality = numeric_limits<float>::infinity();
+		for (const auto& edgei0 : IncomingHalfEdges(vertex)) {
+			const auto& pj = edgei0->next()->vertex()->position();
+			const auto& pi = edgei0->flip()->vertex()->position();
+			if (dot(cross(pj - relaxed_position, pi - relaxed_position), edgei0->face()->normal()) <= 0.f) {
+				relaxed_quality = 0.f;
+				break;
+			}
+			relaxed_quality = std::min(relaxed_quality, ComputeTriangleQuality(relaxed_position, pj, pi));
+		}
+		if (relaxed_quality > quality * kMinQualityGain) return relaxed_position;
+	}
+
+	return nullopt;
+}
+
+/**
+ * \brief Partitions the vertices of a mesh into independent sets by greedy graph coloring.
+ * \details Vertices are colored in ID order with the smallest color not used by a neighbor, so no two vertices of a
+ *          color share an edge or triangle and the partition does not depend on hash table iteration order.
+ * \param half_edge_mesh The mesh whose vertices to color.
+ * \return The vertices of each color in ID order.
+ */
+vector<vector<shared_ptr<Vertex>>> ColorVertices(const HalfEdgeMesh& half_edge_mesh) {
+	vector<vector<shared_ptr<Vertex>>> colored_vertices;
+	unordered_map<size_t, size_t> vertex_colors;
+	vertex_colors.reserve(half_edge_mesh.vertices().size());
+	vector<bool> neighbor_colors;
+
+	for (const auto& vertex : half_edge_mesh.vertices() | views::values) {
+		neighbor_colors.assign(colored_vertices.size() + 1, false);
+		for (const auto& neighbor : AdjacentVertices(*vertex)) {
+			if (const auto iterator = vertex_colors.find(neighbor->id()); iterator != vertex_colors.end()) {
+				neighbor_colors[iterator->second] = true;
+			}
+		}
+
+		const auto color = static_cast<size_t>(ranges::find(neighbor_colors, false) - neighbor_colors.begin());
+		if (color == colored_vertices.size()) colored_vertices.emplace_back();
+		colored_vertices[color].push_back(vertex);
+		vertex_colors.emplace(vertex->id(), color);
+	}
+
+	return colored_vertices;
+}
+
+/**
+ * \brief Improves the shape of the triangles of a simplified mesh with edge flips and tangential relaxation.
+ * \details Candidate flips are evaluated in parallel and applied in edge key order, re-evaluating each against the
+ *          flips applied before it. Vertices are relaxed one color at a time: vertices of a color share no triangle,
+ *          so their positions are computed in parallel from a neighborhood that does not change until they are moved.
+ *          Both phases therefore produce the same mesh regardless of thread count.
+ * \param half_edge_mesh The simplified mesh.
+ * \param quadrics A mapping of error quadrics by vertex ID.
+ * \param error_bound The largest quadric error of a moved vertex or the midpoint of a flipped edge.
+ * \param passes The maximum number of passes.
+ * \param thread_pool The thread pool that evaluates flips and vertex moves.
+ */
+void ImproveTriangleQuality(HalfEdgeMesh& half_edge_mesh,
+                            const QuadricArray& quadrics,
+                            const float error_bound,
+                            const unsigned int passes,
+                            ThreadPool& thread_pool) {
+
+	for (unsigned int pass = 0; pass < passes; ++pass) {
+		size_t flip_count = 0;
+		size_t move_count = 0;
+
+		vector<shared_ptr<HalfEdge>> min_edges;
+		min_edges.reserve(half_edge_mesh.edges().size() / 2);
+		for (const auto& edge : half_edge_mesh.edges() | views::values) {
+			if (GetMinEdge(edge) == edge) min_edges.push_back(edge);
+		}
+		ranges::sort(min_edges, {}, [](const auto& edge) { return GetEdgeKey(*edge); });
+
+		vector<char> flip_candidates(min_edges.size());
+		thread_pool.ParallelFor(0, min_edges.size(), kParallelGrainSize, [&](const size_t begin, const size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				flip_candidates[i] = ShouldFlip(*min_edges[i], half_edge_mesh.edges(), quadrics, error_bound);
+			}
+		});
+		for (size_t i = 0; i < min_edges.size(); ++i) {
+			// an earlier flip may have removed the edge (leaving it unlinked) or replaced one of its triangles
+			if (const auto& edge = min_edges[i];
+				flip_candidates[i] && edge->face() && ShouldFlip(*edge, half_edge_mesh.edges(), quadrics, error_bound)) {
+				half_edge_mesh.FlipEdge(edge);
+				++flip_count;
+			}
+		}
+		min_edges.clear();
+
+		for (const auto& vertices : ColorVertices(half_edge_mesh)) {
+			vector<optional<vec3>> relaxed_positions(vertices.size());
+			thread_pool.ParallelFor(0, vertices.size(), kParallelGrainSize, [&](const size_t begin, const size_t end) {
+				for (auto i = begin; i < end; ++i) {
+					relaxed_positions[i] = ComputeRelaxedPosition(*vertices[i], quadrics, error_bound);
+				}
+			});
+			for (size_t i = 0; i < vertices.size(); ++i) {
+				if (relaxed_positions[i]) {
+					half_edge_mesh.MoveVertex(vertices[i], *relaxed_positions[i]);
+					++move_count;
+				}
+			}
+		}
+
+		if (flip_count == 0 && move_count == 0) break;
+	}
+}
+
 /** \brief Represents an edge contraction priority queue entry. */
 struct EdgeContraction {
 
-	EdgeContraction(HalfEdgeMesh& mesh, const shared_ptr<HalfEdge>& edge, const unordered_map<size_t, mat4>& quadrics)
-		: edge{edge} { tie(vertex, cost) = GetOptimalEdgeContractionVertex(mesh.next_vertex_id(), *edge, quadrics); }
+	EdgeContraction(const shared_ptr<HalfEdge>& edge, const QuadricArray& quadrics)
+		: edge{edge}, edge_key{GetEdgeKey(*edge)} {
+		tie(position, cost) = GetOptimalEdgeContractionPosition(*edge, quadrics);
+	}
+
+	EdgeContraction(const shared_ptr<HalfEdge>& edge, const float min_cost)
+		: edge{edge}, edge_key{GetEdgeKey(*edge)}, cost{min_cost}, exact{false} {}
+
+	EdgeContraction(const shared_ptr<HalfEdge>& edge,
+	                const vec3& position,
+	                const float cost,
+	                const bool exact,
+	                const bool queued,
+	                const uint64_t sequence)
+		: edge{edge},
+		  edge_key{GetEdgeKey(*edge)},
+		  position{position},
+		  cost{cost},
+		  exact{exact},
+		  queued{queued},
+		  sequence{sequence} {}
+
+	/** \brief Computes the optimal vertex position and exact cost of an entry queued with a lower bound of its cost. */
+	void Evaluate(const QuadricArray& quadrics) {
+		tie(position, cost) = GetOptimalEdgeContractionPosition(*edge, quadrics);
+		exact = true;
+	}
 
 	/** \brief The edge to be collapsed. */
 	const shared_ptr<HalfEdge> edge;
 
-	/** \brief The optimal vertex position that minimizes the cost of collapsing this edge. */
-	shared_ptr<Vertex> vertex;
+	/** \brief The key of \c edge, kept since the links of an edge are cleared once it is removed from the mesh. */
+	const pair<size_t, size_t> edge_key;
+
+	/**
+	 * \brief The optimal vertex position that minimizes the cost of collapsing this edge.
+	 * \details The vertex is only created once the edge is collapsed, so candidates that are never collapsed do not
+	 *          consume vertex IDs and the IDs of the simplified mesh stay dense.
+	 */
+	vec3 position{0.f};
 
 	/** \brief The associated cost of collapsing this edge. */
 	float cost = numeric_limits<float>::infinity();
 
+	/** \brief Whether \c cost is exact rather than a lower bound, in which case \c position is not yet computed. */
+	bool exact = true;
+
 	/**
-	 * \brief This is used as a workaround for priority_queue not providing a method to update an existing
+	 * \brief This is used as a workaround for the priority queue not providing a method to update an existing
 	 *        entry's priority. As edges are updated in the mesh, duplicated entries may be inserted in the queue
 	 *        and this property will be used to determine if an entry refers to the most recent edge update.
 	 */
 	bool valid = true;
+
+	/**
+	 * \brief Whether this entry is in the priority queue. Entries popped because their collapse would degenerate or fold
+	 *        over the mesh stay valid, so they can be requeued with their cached cost once a nearby collapse changes their
+	 *        neighborhood.
+	 */
+	bool queued = true;
+
+	/** \brief The order this entry was queued in, which orders entries of the same bucket in an approximate queue. */
+	uint64_t sequence = 0;
 };
+
+/**
+ * \brief Creates an edge contraction candidate for an edge affected by an edge collapse.
+ * \param edge The edge to collapse.
+ * \param v_new The vertex created by the collapse.
+ * \param min_costs The lower bound of the cost of collapsing the edge from \p v_new to each of its neighbors, empty
+ *                  to compute the exact cost of every candidate.
+ * \param quadrics A mapping of error quadrics by vertex ID.
+ * \return A candidate queued with a lower bound of its cost if \p edge is incident to \p v_new and \p min_costs holds
+ *         a bound for it, otherwise a candidate with its optimal vertex position and exact cost.
+ */
+shared_ptr<EdgeContraction> MakeEdgeContraction(const shared_ptr<HalfEdge>& edge,
+                                                const Vertex& v_new,
+                                                const vector<pair<size_t, float>>& min_costs,
+                                                const QuadricArray& quadrics) {
+	const auto& v0 = *edge->flip()->vertex();
+	const auto& v1 = *edge->vertex();
+	if (&v0 == &v_new || &v1 == &v_new) {
+		const auto neighbor_id = &v0 == &v_new ? v1.id() : v0.id();
+		if (const auto min_cost = ranges::find(min_costs, neighbor_id, &pair<size_t, float>::first);
+			min_cost != min_costs.end()) {
+			return MakeTracked<EdgeContraction>(MemoryCategory::kEdgeQueue, edge, min_cost->second);
+		}
+	}
+	return MakeTracked<EdgeContraction>(MemoryCategory::kEdgeQueue, edge, quadrics);
 }
 
-Mesh mesh::Simplify(const Mesh& mesh, const float rate) {
+/** \brief An array of edge contraction candidates attributed to \c MemoryCategory::kEdgeQueue. */
+using EdgeContractionArray = vector<shared_ptr<EdgeContraction>, LargeArrayTrackingAllocator<shared_ptr<EdgeContraction>>>;
 
-	if (rate < 0.f || rate > 1.f) throw invalid_argument{format("Invalid mesh simplification rate {}", rate)};
+/**
+ * \brief Determines if an edge contraction should be collapsed after another.
+ * \details Cost ties are broken by edge key so contractions are collapsed in the same order regardless of insertion order.
+ */
+bool IsLowerPriority(const shared_ptr<EdgeContraction>& lhs, const shared_ptr<EdgeContraction>& rhs) noexcept {
+	if (lhs->cost != rhs->cost) return lhs->cost > rhs->cost;
+	return lhs->edge_key > rhs->edge_key;
+}
+
+/**
+ * \brief A priority queue of edge contraction candidates that pops the cheapest candidate first.
+ * \details Candidates are either exactly ordered by a binary heap or approximately ordered by a bucket queue. The bucket
+ *          queue quantizes costs by the upper bits of their floating-point representation into buckets that double in
+ *          size every \c kBucketsPerOctave buckets, so pushing a candidate takes constant time and the cheapest bucket
+ *          is found by scanning a bitmap of occupied buckets from the last one popped. Each bucket pops its most
+ *          recently pushed candidate first, except that the candidates the queue is built from are exactly ordered
+ *          within each bucket. Sequence numbers record the order candidates were pushed in so a queue rebuilt from a
+ *          checkpoint pops candidates in the same order.
+ */
+class EdgeContractionQueue {
+
+	/** \brief The number of buckets spanning each doubling of cost, which bounds costs in a bucket to differ by 4.4%. */
+	static constexpr uint32_t kBucketsPerOctave = 16;
+
+	/** \brief The number of low mantissa bits discarded to quantize a cost into a bucket. */
+	static constexpr int kBucketShift = numeric_limits<float>::digits - 1 - countr_zero(kBucketsPerOctave);
+
+	/** \brief The number of buckets needed to hold every nonnegative float, including infinity and NaN. */
+	static constexpr size_t kBucketCount = size_t{1} << (31 - kBucketShift);
 
-	const auto start_time = chrono::high_resolution_clock::now();
-	HalfEdgeMesh half_edge_mesh{mesh};
+	using Bucket = vector<shared_ptr<EdgeContraction>, TrackingAllocator<shared_ptr<EdgeContraction>>>;
 
-	// compute error quadrics for each vertex
-	unordered_map<size_t, mat4> quadrics;
-	for (const auto& [vertex_id, vertex] : half_edge_mesh.vertices()) {
-		quadrics.emplace(vertex_id, ComputeQuadric(*vertex));
+public:
+	/**
+	 * \brief Fills the queue, which must be empty.
+	 * \param edge_contractions The initial candidates, which are moved into the queue. Within each bucket, candidates
+	 *                          are ordered by sequence number (e.g., when restored from a checkpoint) and then by cost.
+	 * \param approximate Whether to order candidates approximately with a bucket queue rather than a binary heap.
+	 */
+	void Build(EdgeContractionArray& edge_contractions, const bool approximate) {
+		approximate_ = approximate;
+
+		// building the heap from every initial candidate at once is linear rather than pushing candidates one at a time,
+		// swapping leaves the previous heap array to hold the candidates of the next build
+		if (!approximate_) {
+			heap_.swap(edge_contractions);
+			ranges::make_heap(heap_, IsLowerPriority);
+			return;
+		}
+
+		if (buckets_.empty()) {
+			buckets_.resize(kBucketCount, Bucket{Bucket::allocator_type{MemoryCategory::kEdgeQueue}});
+		}
+		for (auto& edge_contraction : edge_contractions) {
+			buckets_[GetBucket(edge_contraction->cost)].push_back(move(edge_contraction));
+		}
+		edge_contractions.clear();
+
+		// order each bucket so its back is its cheapest candidate, then renumber candidates in popping order
+		for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+			auto& candidates = buckets_[bucket];
+			if (candidates.empty()) continue;
+			ranges::sort(candidates, [](const auto& lhs, const auto& rhs) noexcept {
+				if (lhs->sequence != rhs->sequence) return lhs->sequence < rhs->sequence;
+				return IsLowerPriority(lhs, rhs);
+			});
+			for (const auto& edge_contraction : candidates) {
+				edge_contraction->sequence = ++sequence_;
+			}
+			occupied_[bucket / 64] |= uint64_t{1} << bucket % 64;
+			size_ += candidates.size();
+		}
+		first_bucket_ = FindOccupiedBucket(0);
 	}
 
-	// use a priority queue to sort edge contraction candidates by the associate cost of collapsing that edge
-	constexpr auto kMinHeapComparator = [](
-		const shared_ptr<EdgeContraction>& lhs, const shared_ptr<EdgeContraction>& rhs) noexcept {
-		return lhs->cost > rhs->cost;
+	/**
+	 * \brief Removes every candidate.
+	 * \details Arrays small enough to be retained keep their capacity so the queue can be refilled without allocating.
+	 */
+	void Clear() {
+		Recycle(heap_);
+		size_t bucket_bytes = 0;
+		for (auto& candidates : buckets_) {
+			candidates.clear();
+			bucket_bytes += candidates.capacity() * sizeof(shared_ptr<EdgeContraction>);
+		}
+		if (bucket_bytes > kMaxRetainedBufferBytes) {
+			vector<Bucket>{}.swap(buckets_);
+		}
+		occupied_.fill(0);
+		first_bucket_ = kBucketCount;
+		size_ = 0;
+		sequence_ = 0;
+	}
+
+	/** \brief Determines if the queue is empty. */
+	[[nodiscard]] bool empty() const noexcept { return approximate_ ? size_ == 0 : heap_.empty(); }
+
+	/** \brief Gets the candidate to collapse next, the queue must not be empty. */
+	[[nodiscard]] const shared_ptr<EdgeContraction>& top() const noexcept {
+		return approximate_ ? buckets_[first_bucket_].back() : heap_.front();
+	}
+
+	/** \brief Removes the candidate to collapse next, the queue must not be empty. */
+	void pop() {
+		if (!approximate_) {
+			ranges::pop_heap(heap_, IsLowerPriority);
+			heap_.pop_back();
+			return;
+		}
+		auto& candidates = buckets_[first_bucket_];
+		candidates.pop_back();
+		--size_;
+		if (candidates.empty()) {
+			occupied_[first_bucket_ / 64] &= ~(uint64_t{1} << first_bucket_ % 64);
+			first_bucket_ = FindOccupiedBucket(first_bucket_);
+		}
+	}
+
+	/** \brief Adds a candidate to the queue. */
+	void push(shared_ptr<EdgeContraction> edge_contraction) {
+		if (!approximate_) {
+			heap_.push_back(move(edge_contraction));
+			ranges::push_heap(heap_, IsLowerPriority);
+			return;
+		}
+		const auto bucket = GetBucket(edge_contraction->cost);
+		edge_contraction->sequence = ++sequence_;
+		buckets_[bucket].push_back(move(edge_contraction));
+		occupied_[bucket / 64] |= uint64_t{1} << bucket % 64;
+		++size_;
+		first_bucket_ = std::min(first_bucket_, bucket);
+	}
+
+private:
+	/** \brief Gets the bucket of a cost, where negative costs share the first bucket with zero. */
+	[[nodiscard]] static size_t GetBucket(const float cost) noexcept {
+		const auto bits = bit_cast<uint32_t>(cost);
+		return bits >> 31 ? 0 : bits >> kBucketShift;
+	}
+
+	/** \brief Gets the first occupied bucket at or after \p bucket, or \c kBucketCount if there is none. */
+	[[nodiscard]] size_t FindOccupiedBucket(const size_t bucket) const noexcept {
+		for (auto word = bucket / 64; word < occupied_.size(); ++word) {
+			auto bits = occupied_[word];
+			if (word == bucket / 64) bits &= ~uint64_t{0} << bucket % 64;
+			if (bits) return word * 64 + static_cast<size_t>(countr_zero(bits));
+		}
+		return kBucketCount;
+	}
+
+	bool approximate_ = false;
+	EdgeContractionArray heap_{EdgeContractionArray::allocator_type{MemoryCategory::kEdgeQueue}};
+	vector<Bucket> buckets_;
+	array<uint64_t, kBucketCount / 64> occupied_{};
+	size_t first_bucket_ = kBucketCount;
+	size_t size_ = 0;
+	uint64_t sequence_ = 0;
+};
+
+/**
+ * \brief Computes a value that identifies a simplification so its checkpoints are never resumed by another.
+ * \param mesh The mesh to simplify.
+ * \param rate The percentage of triangles to be removed.
+ * \param options The options that control simplification.
+ * \return A hash of \p mesh, \p rate, and the options that affect the simplified mesh.
+ */
+uint64_t ComputeFingerprint(const MeshView& mesh, const float rate, const mesh::SimplificationOptions& options) {
+	const auto parameters = format("rate={};features={},{},{},{};approximate={};lazy={};visibility={},{},{}",
+		rate,
+		options.preserve_features,
+		options.feature_angle,
+		options.feature_weight,
+		options.curvature_weight,
+		options.approximate_ordering,
+		options.lazy_evaluation,
+		options.weight_by_visibility,
+		options.visibility_samples,
+		options.hidden_weight);
+	return io::HashBytes(as_bytes(span{parameters.data(), parameters.size()}), io::HashMesh(mesh));
+}
+
+/**
+ * \brief Reads the checkpoint of an interrupted simplification.
+ * \param filepath The checkpoint file, or an empty path if checkpoints are disabled.
+ * \param fingerprint The fingerprint of the simplification to resume (see \c ComputeFingerprint).
+ * \return The checkpoint stored at \p filepath if it exists, can be read, and matches \p fingerprint.
+ */
+optional<io::SimplificationCheckpoint> ReadCheckpoint(const filesystem::path& filepath, const uint64_t fingerprint) {
+	if (error_code error; filepath.empty() || !filesystem::exists(filepath, error)) return nullopt;
+	try {
+		if (auto checkpoint = io::ReadSimplificationCheckpoint(filepath); checkpoint.fingerprint == fingerprint) {
+			return checkpoint;
+		}
+		cerr << format("Ignoring checkpoint {} of a different simplification\n", filepath.string());
+	} catch (const exception& e) {
+		cerr << format("Ignoring checkpoint: {}\n", e.what());
+	}
+	return nullopt;
+}
+
+/**
+ * \brief Saves the state of a simplification in progress.
+ * \param half_edge_mesh The partially simplified mesh.
+ * \param quadrics A mapping of error quadrics by vertex ID.
+ * \param valid_edges A mapping of the valid edge contraction candidates by edge ID.
+ * \return A checkpoint holding the remaining vertices, triangles, quadrics, and edge contraction candidates.
+ */
+io::SimplificationCheckpoint CreateCheckpoint(const HalfEdgeMesh& half_edge_mesh,
+                                              const QuadricArray& quadrics,
+                                              const IdMap<shared_ptr<EdgeContraction>>& valid_edges) {
+	io::SimplificationCheckpoint checkpoint;
+
+	const auto& vertices = half_edge_mesh.vertices();
+	checkpoint.vertex_ids.reserve(vertices.size());
+	checkpoint.positions.reserve(vertices.size());
+	checkpoint.quadrics.reserve(vertices.size());
+	unordered_map<size_t, unsigned int> index_map;
+	index_map.reserve(vertices.size());
+	for (const auto& vertex : vertices | views::values) {
+		index_map.emplace(vertex->id(), static_cast<unsigned int>(checkpoint.vertex_ids.size()));
+		checkpoint.vertex_ids.push_back(vertex->id());
+		checkpoint.positions.push_back(vertex->position());
+		checkpoint.quadrics.push_back(quadrics.at(vertex->id()));
+	}
+
+	const auto& faces = half_edge_mesh.faces();
+	auto& face_geometry = checkpoint.face_geometry;
+	checkpoint.indices.reserve(faces.size() * 3);
+	for (auto* const values : {&face_geometry.normal_x,
+	                           &face_geometry.normal_y,
+	                           &face_geometry.normal_z,
+	                           &face_geometry.areas,
+	                           &face_geometry.plane_offsets}) {
+		values->reserve(faces.size());
+	}
+	for (const auto& face : faces | views::values) {
+		for (const auto* const vertex : {face->v0().get(), face->v1().get(), face->v2().get()}) {
+			checkpoint.indices.push_back(index_map.at(vertex->id()));
+		}
+		const auto plane = face->plane();
+		face_geometry.normal_x.push_back(plane.x);
+		face_geometry.normal_y.push_back(plane.y);
+		face_geometry.normal_z.push_back(plane.z);
+		face_geometry.areas.push_back(face->area());
+		face_geometry.plane_offsets.push_back(plane.w);
+	}
+
+	checkpoint.edge_contractions.reserve(valid_edges.size());
+	for (const auto& edge_contraction : valid_edges | views::values) {
+		checkpoint.edge_contractions.push_back(io::CheckpointEdgeContraction{
+			.source_id = edge_contraction->edge_key.first,
+			.target_id = edge_contraction->edge_key.second,
+			.sequence = edge_contraction->sequence,
+			.position = edge_contraction->position,
+			.cost = edge_contraction->cost,
+			.queued = edge_contraction->queued,
+			.lower_bound = !edge_contraction->exact});
+	}
+
+	return checkpoint;
+}
+}
+
+/** \brief The buffers a simplifier retains between meshes. */
+struct mesh::Simplifier::Workspace {
+
+	/** \brief Releases the mesh elements referenced by the buffers and every buffer too large to retain. */
+	void Clear() {
+		Recycle(vertices);
+		Recycle(quadrics);
+		Recycle(valid_edges);
+		Recycle(min_edges);
+		Recycle(initial_edge_contractions);
+		edge_contractions.Clear();
+		Recycle(min_costs);
+		Recycle(visited_edges);
+	}
+
+	vector<shared_ptr<Vertex>> vertices;
+	QuadricArray quadrics{QuadricArray::allocator_type{MemoryCategory::kQuadrics}};
+	IdMap<shared_ptr<EdgeContraction>> valid_edges{
+		IdMap<shared_ptr<EdgeContraction>>::allocator_type{MemoryCategory::kValidEdges}};
+	vector<shared_ptr<HalfEdge>> min_edges;
+	EdgeContractionArray initial_edge_contractions{EdgeContractionArray::allocator_type{MemoryCategory::kEdgeQueue}};
+	EdgeContractionQueue edge_contractions;
+	vector<pair<size_t, float>> min_costs;
+	unordered_set<size_t> visited_edges;
+};
+
+mesh::Simplifier::Simplifier(SimplificationOptions options)
+	: options_{move(options)}, workspace_{make_unique<Workspace>()} {}
+
+mesh::Simplifier::~Simplifier() = default;
+
+mesh::Simplifier::Simplifier(Simplifier&&) noexcept = default;
+
+mesh::Simplifier& mesh::Simplifier::operator=(Simplifier&&) noexcept = default;
+
+mesh::SimplifiedMesh mesh::Simplifier::Simplify(const MeshView& mesh, const float rate) {
+
+	const auto& options = options_;
+	if (rate < 0.f || rate > 1.f) throw invalid_argument{format("Invalid mesh simplification rate {}", rate)};
+	if (options.feature_weight < 0.f || options.curvature_weight < 0.f) {
+		throw invalid_argument{"Feature and curvature weights must not be negative"};
+	}
+	if (options.weight_by_visibility
+		&& (options.visibility_samples == 0 || !(options.hidden_weight >= 0.f && options.hidden_weight <= 1.f))) {
+		throw invalid_argument{format(
+			"Invalid visibility weighting with {} samples and hidden weight {}", options.visibility_samples, options.hidden_weight)};
+	}
+
+	const auto end_phase = [memory_profiler = options.memory_profiler](const string_view phase) {
+		if (memory_profiler) memory_profiler->EndPhase(phase);
 	};
-	priority_queue<
-		shared_ptr<EdgeContraction>,
-		vector<shared_ptr<EdgeContraction>>,
-		decltype(kMinHeapComparator)
-	> edge_contractions{kMinHeapComparator};
+
+	// release the elements of a mesh whose simplification threw before the workspace was cleared
+	auto& workspace = *workspace_;
+	workspace.Clear();
+
+	// resume from the checkpoint of an interrupted run of the same simplification if there is one
+	const auto fingerprint = options.checkpoint_path.empty() ? 0 : ComputeFingerprint(mesh, rate, options);
+	auto checkpoint = ReadCheckpoint(options.checkpoint_path, fingerprint);
+
+	HalfEdgeMesh half_edge_mesh = checkpoint
+		? HalfEdgeMesh{MeshView{.positions = checkpoint->positions,
+		                        .texture_coordinates = {},
+		                        .normals = {},
+		                        .indices = checkpoint->indices,
+		                        .model_transform = mesh.model_transform},
+		               checkpoint->vertex_ids,
+		               checkpoint->face_geometry,
+		               static_cast<size_t>(checkpoint->next_vertex_id)}
+		: HalfEdgeMesh{mesh};
+	half_edge_mesh.set_snapshot_channel(options.snapshot_channel.get());
+	end_phase("half-edge mesh");
+
+	auto& thread_pool = ThreadPool::Default();
+
+	// compute error quadrics for each vertex along with their feature weights, capacity is reserved for the vertex
+	// created by each collapse, which removes a vertex, so the array is never reallocated and its pages never copied
+	auto& quadrics = workspace.quadrics;
+	quadrics.reserve(half_edge_mesh.vertex_id_count() + half_edge_mesh.vertices().size());
+	quadrics.resize(half_edge_mesh.vertex_id_count());
+	if (checkpoint) {
+		for (size_t i = 0; i < checkpoint->vertex_ids.size(); ++i) {
+			quadrics[checkpoint->vertex_ids[i]] = checkpoint->quadrics[i];
+		}
+	} else {
+		auto& vertices = workspace.vertices;
+		vertices.reserve(half_edge_mesh.vertices().size());
+		ranges::copy(half_edge_mesh.vertices() | views::values, back_inserter(vertices));
+
+		optional<IdMap<float>> face_weights;
+		if (options.weight_by_visibility) {
+			face_weights = ComputeVisibilityWeights(half_edge_mesh, options, thread_pool);
+			end_phase("visibility");
+		}
+
+		// quadrics are default-initialized so their pages are first touched by the worker threads that compute them,
+		// the IDs of a new mesh are its vertex indices so each worker writes a contiguous range of the array
+		thread_pool.ParallelFor(0, vertices.size(), kParallelGrainSize, [&](const size_t begin, const size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				quadrics[vertices[i]->id()] = ComputeQuadric(*vertices[i], options, face_weights ? &*face_weights : nullptr);
+			}
+		});
+		Recycle(vertices);
+	}
+	end_phase("quadrics");
 
 	// this is used to invalidate existing priority queue entries as edges are updated or removed from the mesh
-	unordered_map<size_t, shared_ptr<EdgeContraction>> valid_edges;
+	auto& valid_edges = workspace.valid_edges;
+	valid_edges.reserve(half_edge_mesh.edges().size() / 2);
 
-	// compute the optimal vertex position that minimizes the cost of collapsing each edge
-	for (const auto& edge : half_edge_mesh.edges() | views::values) {
-		const auto min_edge = GetMinEdge(edge);
-		if (const auto min_edge_key = hash_value(*min_edge); !valid_edges.contains(min_edge_key)) {
-			const auto edge_contraction = make_shared<EdgeContraction>(half_edge_mesh, min_edge, quadrics);
-			edge_contractions.push(edge_contraction);
-			valid_edges.emplace(min_edge_key, edge_contraction);
+	// use a priority queue to sort edge contraction candidates by the associate cost of collapsing that edge
+	auto& initial_edge_contractions = workspace.initial_edge_contractions;
+	if (checkpoint) {
+		// candidates waiting for their neighborhood to change are valid but not queued
+		const auto& vertices = half_edge_mesh.vertices();
+		for (const auto& saved_edge_contraction : checkpoint->edge_contractions) {
+			const auto& edge = half_edge_mesh.edges().at(hash_value(
+				*vertices.at(saved_edge_contraction.source_id), *vertices.at(saved_edge_contraction.target_id)));
+			auto edge_contraction = MakeTracked<EdgeContraction>(MemoryCategory::kEdgeQueue,
+			                                                     edge,
+			                                                     saved_edge_contraction.position,
+			                                                     saved_edge_contraction.cost,
+			                                                     saved_edge_contraction.lower_bound == 0,
+			                                                     saved_edge_contraction.queued != 0,
+			                                                     saved_edge_contraction.sequence);
+			if (edge_contraction->queued) {
+				initial_edge_contractions.push_back(edge_contraction);
+			}
+			valid_edges.emplace(hash_value(*edge), move(edge_contraction));
+		}
+	} else {
+		// gather each edge once, the order of candidates does not matter since the queue orders them by cost and edge key
+		auto& min_edges = workspace.min_edges;
+		min_edges.reserve(half_edge_mesh.edges().size() / 2);
+		for (const auto& edge : half_edge_mesh.edges() | views::values) {
+			const auto& min_edge = GetMinEdge(edge);
+			if (const auto min_edge_key = hash_value(*min_edge); valid_edges.emplace(min_edge_key, nullptr).second) {
+				min_edges.push_back(min_edge);
+			}
 		}
+
+		// compute the optimal vertex position that minimizes the cost of collapsing each edge
+		initial_edge_contractions.resize(min_edges.size());
+		thread_pool.ParallelFor(0, min_edges.size(), kParallelGrainSize, [&](const size_t begin, const size_t end) {
+			for (auto i = begin; i < end; ++i) {
+				initial_edge_contractions[i] = MakeTracked<EdgeContraction>(MemoryCategory::kEdgeQueue, min_edges[i], quadrics);
+			}
+		});
+
+		for (const auto& edge_contraction : initial_edge_contractions) {
+			valid_edges[hash_value(*edge_contraction->edge)] = edge_contraction;
+		}
+		Recycle(min_edges);
 	}
 
+	auto& edge_contractions = workspace.edge_contractions;
+	edge_contractions.Build(initial_edge_contractions, options.approximate_ordering);
+	Recycle(initial_edge_contractions);
+	end_phase("edge contractions");
+
 	// stop mesh simplification if the number of triangles has been sufficiently reduced
-	const auto initial_face_count = static_cast<float>(half_edge_mesh.faces().size());
-	const auto target_face_count = initial_face_count * (1.f - rate);
+	const auto initial_face_count = checkpoint ? static_cast<size_t>(checkpoint->initial_face_count) : half_edge_mesh.faces().size();
+	const auto target_face_count = static_cast<float>(initial_face_count) * (1.f - rate);
 	const auto should_stop = [&]() noexcept {
 		const auto face_count = static_cast<float>(half_edge_mesh.faces().size());
 		return face_count < target_face_count;
 	};
 
+	// the largest cost of any contraction so far bounds the squared distance of each vertex to its original planes
+	auto max_cost = checkpoint ? checkpoint->max_cost : 0.f;
+
+	if (checkpoint) {
+		cout << format("Resumed simplification from {} with {} of {} triangles remaining\n",
+			options.checkpoint_path.string(),
+			half_edge_mesh.faces().size(),
+			initial_face_count);
+		checkpoint.reset();
+	}
+
+	// the largest cost of the removed edges to each neighbor of a collapsed edge, which bounds the cost of the new edges
+	auto& min_costs = workspace.min_costs;
+	auto& visited_edges = workspace.visited_edges;
+
+	auto checkpoint_time = chrono::steady_clock::now() + options.checkpoint_interval;
 	while (!edge_contractions.empty() && !should_stop()) {
-		const auto& edge_contraction = edge_contractions.top();
+		// the state between iterations is complete, so a checkpoint taken here resumes exactly where it left off
+		if (!options.checkpoint_path.empty() && chrono::steady_clock::now() >= checkpoint_time) {
+			try {
+				auto saved_checkpoint = CreateCheckpoint(half_edge_mesh, quadrics, valid_edges);
+				saved_checkpoint.fingerprint = fingerprint;
+				saved_checkpoint.next_vertex_id = half_edge_mesh.vertex_id_count();
+				saved_checkpoint.initial_face_count = initial_face_count;
+				saved_checkpoint.max_cost = max_cost;
+				io::WriteSimplificationCheckpoint(saved_checkpoint, options.checkpoint_path);
+			} catch (const exception& e) {
+				// losing a checkpoint only costs progress on the next interruption, so keep simplifying
+				cerr << format("Failed to write checkpoint: {}\n", e.what());
+			}
+			checkpoint_time = chrono::steady_clock::now() + options.checkpoint_interval;
+		}
+
+		// pop before collapsing since the candidates pushed below may replace the top of the queue
+		const auto edge_contraction = edge_contractions.top();
+		edge_contractions.pop();
+		if (!edge_contraction->valid) continue;
+
+		// solve for the placement of a lazily queued candidate and requeue it unless it remains the cheapest
+		if (!edge_contraction->exact) {
+			edge_contraction->Evaluate(quadrics);
+			if (!edge_contractions.empty() && IsLowerPriority(edge_contraction, edge_contractions.top())) {
+				edge_contractions.push(edge_contraction);
+				continue;
+			}
+		}
+
 		const auto& edge01 = edge_contraction->edge;
-		const auto& v_new = edge_contraction->vertex;
-
-		if (edge_contraction->valid && !WillDegenerate(edge01)) {
-			const auto v0 = edge01->flip()->vertex();
-			const auto v1 = edge01->vertex();
-
-			// remove the edge from the mesh and attach incident edges to the new vertex
-			half_edge_mesh.CollapseEdge(edge01, v_new);
-
-			// compute the error quadric for the new vertex
-			const auto& q0 = quadrics.at(v0->id());
-			const auto& q1 = quadrics.at(v1->id());
-			quadrics.emplace(v_new->id(), q0 + q1);
-
-			// invalidate entries in the priority queue that were removed during the edge contraction
-			for (const auto& vertex : {v0, v1}) {
-				auto edge = vertex->edge();
-				do {
-					const auto min_edge = GetMinEdge(edge);
-					if (const auto iterator = valid_edges.find(hash_value(*min_edge)); iterator != valid_edges.end()) {
-						iterator->second->valid = false;
-						valid_edges.erase(iterator);
+		if (WillDegenerate(*edge01) || WillFoldOver(*edge01, edge_contraction->position)) {
+			edge_contraction->queued = false;
+			continue;
+		}
+
+		const auto v0 = edge01->flip()->vertex();
+		const auto v1 = edge01->vertex();
+
+		// invalidate entries in the priority queue for edges removed by the edge contraction, which must be done
+		// beforehand since removed edges are unlinked from the mesh
+		min_costs.clear();
+		for (const auto* const vertex : {v0.get(), v1.get()}) {
+			for (const auto& edge : IncomingHalfEdges(*vertex)) {
+				if (const auto iterator = valid_edges.find(hash_value(*GetMinEdge(edge))); iterator != valid_edges.end()) {
+					// the edges that replace the edges to each neighbor cost at least as much as the edges they replace
+					if (options.lazy_evaluation) {
+						const auto neighbor_id = edge->flip()->vertex()->id();
+						const auto min_cost = ranges::find(min_costs, neighbor_id, &pair<size_t, float>::first);
+						if (min_cost == min_costs.end()) {
+							min_costs.emplace_back(neighbor_id, iterator->second->cost);
+						} else {
+							min_cost->second = std::max(min_cost->second, iterator->second->cost);
+						}
 					}
-					edge = edge->next()->flip();
-				} while (edge != vertex->edge());
+					iterator->second->valid = false;
+					valid_edges.erase(iterator);
+				}
 			}
+		}
 
-			// add new edge contraction candidates for edges affected by the edge contraction
-			unordered_map<size_t, shared_ptr<HalfEdge>> visited_edges;
-			const auto& vi = v_new;
-			auto edgeji = vi->edge();
-			do {
-				const auto vj = edgeji->flip()->vertex();
-				auto edgekj = vj->edge();
-				do {
-					const auto min_edge = GetMinEdge(edgekj);
-					if (const auto min_edge_key = hash_value(*min_edge); !visited_edges.contains(min_edge_key)) {
-						if (const auto iterator = valid_edges.find(min_edge_key); iterator != valid_edges.end()) {
+		// remove the edge from the mesh and attach incident edges to the new vertex
+		const auto v_new = MakeTracked<Vertex>(MemoryCategory::kVertices, half_edge_mesh.next_vertex_id(), edge_contraction->position);
+		half_edge_mesh.CollapseEdge(edge01, v_new);
+		max_cost = std::max(max_cost, edge_contraction->cost);
+
+		// compute the error quadric for the new vertex, which has the next ID and is therefore appended
+		quadrics.push_back(quadrics[v0->id()] + quadrics[v1->id()]);
+
+		// add new edge contraction candidates for edges affected by the edge contraction
+		visited_edges.clear();
+		for (const auto& vj : AdjacentVertices(*v_new)) {
+			for (const auto& edgekj : IncomingHalfEdges(*vj)) {
+				const auto& min_edge = GetMinEdge(edgekj);
+				if (const auto min_edge_key = hash_value(*min_edge); visited_edges.insert(min_edge_key).second) {
+					// vertex IDs are never reused and a vertex keeps its quadric for its lifetime, so an entry for an edge
+					// whose endpoints survived the collapse still holds the exact placement and cost
+					if (const auto iterator = valid_edges.find(min_edge_key);
+						iterator != valid_edges.end() && iterator->second->edge == min_edge) {
+						// requeue a candidate previously rejected for degeneracy since the neighborhood of its edge changed
+						if (const auto& cached_edge_contraction = iterator->second; !cached_edge_contraction->queued) {
+							cached_edge_contraction->queued = true;
+							edge_contractions.push(cached_edge_contraction);
+						}
+					} else {
+						if (iterator != valid_edges.end()) {
 							// invalidate existing edge contraction candidate in the priority queue
 							iterator->second->valid = false;
 						}
-						const auto new_edge_contraction = make_shared<EdgeContraction>(half_edge_mesh, min_edge, quadrics);
+						const auto new_edge_contraction = MakeEdgeContraction(min_edge, *v_new, min_costs, quadrics);
 						valid_edges[min_edge_key] = new_edge_contraction;
-						edge_contractions.emplace(new_edge_contraction);
-						visited_edges.emplace(min_edge_key, min_edge);
+						edge_contractions.push(new_edge_contraction);
 					}
-					edgekj = edgekj->next()->flip();
-				} while (edgekj != vj->edge());
-				edgeji = edgeji->next()->flip();
-			} while (edgeji != vi->edge());
+				}
+			}
 		}
+	}
+	end_phase("edge collapses");
 
-		edge_contractions.pop();
+	if (options.quality_passes > 0) {
+		ImproveTriangleQuality(half_edge_mesh, quadrics, max_cost, options.quality_passes, thread_pool);
+		end_phase("triangle quality");
 	}
+	half_edge_mesh.set_snapshot_channel(nullptr);
+
+	// the workspace references the elements of the half-edge mesh, release them before converting it
+	workspace.Clear();
 
-	const auto end_time = chrono::high_resolution_clock::now();
-	cout << std::format(
-		"Mesh simplified from {} to {} triangles in {} seconds\n",
-		initial_face_count,
-		half_edge_mesh.faces().size(),
-		chrono::duration<float>{end_time - start_time}.count());
+	auto simplified_mesh = static_cast<Mesh>(half_edge_mesh);
+	end_phase("conversion");
+
+	if (error_code error; !options.checkpoint_path.empty()) {
+		filesystem::remove(options.checkpoint_path, error);
+	}
+
+	return SimplifiedMesh{.mesh = move(simplified_mesh), .error = std::sqrt(max_cost)};
+}
+
+Mesh mesh::Simplify(const MeshView& mesh, const float rate, const SimplificationOptions& options) {
+	return SimplifyWithError(mesh, rate, options).mesh;
+}
 
-	return static_cast<Mesh>(half_edge_mesh);
+mesh::SimplifiedMesh mesh::SimplifyWithError(const MeshView& mesh, const float rate, const SimplificationOptions& options) {
+	return Simplifier{options}.Simplify(mesh, rate);
+}
+
+vector<mesh::SimplifiedMesh> mesh::SimplifyAll(const span<const MeshView> meshes,
+                                               const float rate,
+                                               const SimplificationOptions& options) {
+	if (!options.checkpoint_path.empty() || options.snapshot_channel || options.memory_profiler) {
+		throw invalid_argument{
+			"Checkpoints, snapshot channels, and memory profilers cannot be shared by several meshes"};
+	}
+
+	// each task simplifies a contiguous range of meshes with its own simplifier so its buffers are reused
+	vector<optional<SimplifiedMesh>> simplified_meshes(meshes.size());
+	ThreadPool::Default().ParallelFor(0, meshes.size(), 1, [&](const size_t begin, const size_t end) {
+		Simplifier simplifier{options};
+		for (auto i = begin; i < end; ++i) {
+			simplified_meshes[i] = simplifier.Simplify(meshes[i], rate);
+		}
+	});
+
+	vector<SimplifiedMesh> results;
+	results.reserve(simplified_meshes.size());
+	for (auto& simplified_mesh : simplified_meshes) {
+		results.push_back(move(*simplified_mesh));
+	}
+	return results;
 }
@@ -1,17 +1,226 @@
 #pragma once
 
-namespace gfx {
-class Mesh;
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh.h"
+
+namespace concurrency {
+class MemoryProfiler;
+}
+
+namespace geometry {
+class MeshSnapshotChannel;
 }
 
 namespace geometry::mesh {
 
+/** \brief A simplified mesh and an estimate of how far it deviates from the mesh it was simplified from. */
+struct SimplifiedMesh {
+
+	/** \brief The simplified triangle mesh. */
+	gfx::Mesh mesh;
+
+	/**
+	 * \brief The square root of the largest quadric error of any contracted edge.
+	 * \details This approximates the largest distance (in object space) between a simplified vertex and the planes of
+	 *          the source triangles it replaced, which makes it suitable for selecting levels of detail by their
+	 *          projected screen-space error.
+	 */
+	float error;
+};
+
+/** \brief Options that control how a mesh is simplified. */
+struct SimplificationOptions {
+
+	/**
+	 * \brief Whether sharp features of the source mesh are weighted so they survive aggressive reduction.
+	 * \details Edges whose adjacent faces meet at a dihedral angle of at least \c feature_angle are feature edges. Each
+	 *          adds planes through the edge perpendicular to its faces to the quadrics of its vertices, which penalizes
+	 *          moving the vertices off the crease, and each vertex quadric is scaled by the total dihedral angle of its
+	 *          incident edges so curved regions are simplified after flat ones. The reported error includes these
+	 *          penalties and therefore overestimates the geometric error of meshes with features.
+	 */
+	bool preserve_features = false;
+
+	/** \brief The smallest dihedral angle in radians between adjacent faces for their shared edge to be a feature edge. */
+	float feature_angle = .5235988f;
+
+	/** \brief The weight of feature edge constraint planes relative to the planes of source triangles. */
+	float feature_weight = 64.f;
+
+	/** \brief The weight of the total dihedral angle (in turns) of a vertex when scaling its quadric. */
+	float curvature_weight = .5f;
+
+	/**
+	 * \brief The number of passes that improve the shape of simplified triangles, zero to not improve them.
+	 * \details Each pass flips edges whose flip raises the quality of the worst of their two triangles and then moves
+	 *          each vertex toward the centroid of its neighbors within its tangent plane if that raises the quality of
+	 *          the worst incident triangle. Flips are limited to nearly planar edges, and neither may place a vertex or
+	 *          flipped edge farther from the source triangles (by quadric error) than the reported error, so long thin
+	 *          triangles are removed without increasing the error or the triangle count. Passes stop early once they
+	 *          no longer change the mesh.
+	 */
+	unsigned int quality_passes = 0;
+
+	/**
+	 * \brief Whether to order edge contractions approximately rather than exactly by cost.
+	 * \details Costs are quantized into logarithmic buckets that differ by less than 5%, so edge contractions are queued
+	 *          in constant time and the cheapest bucket is found in amortized constant time rather than maintaining a
+	 *          binary heap. Contractions within a bucket are exactly ordered once the queue is built, after which the
+	 *          most recently queued contraction of the cheapest bucket is collapsed first. The reported error remains
+	 *          exact, but may be marginally larger for the same rate. Simplification remains deterministic.
+	 */
+	bool approximate_ordering = false;
+
+	/**
+	 * \brief Whether to defer solving for the placement of edge contractions created by each collapse.
+	 * \details The quadric of a collapsed vertex is the sum of the quadrics it replaces, so the cost of each edge incident
+	 *          to it is at least the cost of the edges it replaces. Such edges are queued with that lower bound, and their
+	 *          placement and exact cost are only computed once they reach the top of the queue, after which they are
+	 *          requeued if they are no longer the cheapest contraction. About half of these edges are replaced again
+	 *          before reaching the top of the queue and are never solved, but nearly all others are requeued, so this
+	 *          pays off when solves cost more than queue operations (e.g., with \c approximate_ordering). The bound does
+	 *          not hold for edges placed at their midpoint because their quadric is singular, so the simplified mesh may
+	 *          differ slightly.
+	 */
+	bool lazy_evaluation = false;
+
+	/**
+	 * \brief Whether the quadric of each face is weighted by how much of it can be seen from outside the mesh.
+	 * \details The visibility of each face is the fraction of \c visibility_samples directions evenly distributed over
+	 *          the hemisphere above it along which a ray cast from its centroid escapes the mesh. Faces enclosed by other
+	 *          parts (e.g., interiors of assemblies) or in deep cavities have low visibility, so their quadrics are
+	 *          scaled down and they are simplified before exposed faces. The reported error is weighted the same way and
+	 *          therefore underestimates the geometric error of hidden regions.
+	 */
+	bool weight_by_visibility = false;
+
+	/** \brief The number of ray directions sampled over the sphere to estimate the visibility of each face. */
+	unsigned int visibility_samples = 64;
+
+	/** \brief The weight (0-1) of the quadric of a face that is never visible relative to a fully visible face. */
+	float hidden_weight = .1f;
+
+	/**
+	 * \brief The file simplification progress is periodically saved to, empty to not save progress.
+	 * \details If the file holds a checkpoint of the same mesh, rate, and options (e.g., left by a preempted process),
+	 *          simplification resumes from it and produces the same mesh as an uninterrupted run. Checkpoints that
+	 *          cannot be read are ignored. The file is removed once simplification completes.
+	 */
+	std::filesystem::path checkpoint_path;
+
+	/** \brief The time between checkpoints written to \c checkpoint_path. */
+	std::chrono::seconds checkpoint_interval{300};
+
+	/**
+	 * \brief The channel simplification progress is published to, null to not publish progress.
+	 * \details The mesh is published once simplification begins and each edge collapse is committed as an epoch, so
+	 *          other threads can take consistent snapshots of the mesh being simplified (e.g., for live previews)
+	 *          without stopping it. The final snapshot is identical to the simplified mesh.
+	 */
+	std::shared_ptr<MeshSnapshotChannel> snapshot_channel;
+
+	/**
+	 * \brief The profiler the memory of each simplification phase is attributed to, null to not profile memory.
+	 * \details The profiler is owned by the caller and must outlive simplification. Phases are only sampled when a
+	 *          profiler is given because sampling reads the resident set size of the process.
+	 */
+	concurrency::MemoryProfiler* memory_profiler = nullptr;
+};
+
 /**
  * \brief Reduces the number of triangles in a mesh.
- * \param mesh The mesh to simplify.
+ * \param mesh The mesh to simplify. A \c gfx::Mesh converts implicitly, other sources (e.g., memory-mapped
+ *             containers) can be simplified in place without copying.
  * \param rate The percentage of triangles to be removed (e.g., .95 indicates 95% of triangles should be removed).
+ * \param options The options that control simplification.
  * \return A triangle mesh with \p rate percent of triangles removed from \p mesh.
+ * \note Regardless of \p options, edge contractions that would flip the orientation of a remaining triangle or reduce
+ *       it to a sliver are skipped until the mesh around them changes, so flat regions (e.g., of CAD models) stay
+ *       valid.
+ * \note Simplification is deterministic: cost ties are broken by vertex IDs, parallel phases only write per-element
+ *       results, and no output depends on hash table iteration order, so identical inputs produce identical meshes
+ *       regardless of thread count or standard library implementation.
  * \see docs/surface_simplification for a detailed description of this mesh simplification algorithm.
  */
-gfx::Mesh Simplify(const gfx::Mesh& mesh, float rate);
+gfx::Mesh Simplify(const gfx::MeshView& mesh, float rate, const SimplificationOptions& options = {});
+
+/**
+ * \brief Reduces the number of triangles in a mesh and reports the geometric error introduced.
+ * \param mesh The mesh to simplify.
+ * \param rate The percentage of triangles to be removed.
+ * \param options The options that control simplification.
+ * \return The simplified mesh and its error estimate.
+ * \see Simplify
+ */
+SimplifiedMesh SimplifyWithError(const gfx::MeshView& mesh, float rate, const SimplificationOptions& options = {});
+
+/**
+ * \brief Simplifies meshes one after another while retaining some of its working memory between them.
+ * \details The vertex quadric array, the valid edge hash table, the minimum edge, edge contraction, and minimum cost
+ *          arrays, the priority queue (including the buckets of the approximate queue), and the set of edges visited by
+ *          each collapse are cleared rather than freed, so simplifying many small meshes does not allocate them again
+ *          for each mesh. Buffers larger than a few MiB are released once a mesh is simplified, so
+ *          simplifying a large mesh does not pin its memory. Allocation is not eliminated: the vertices, half-edges,
+ *          and faces of each mesh and its edge contraction candidates are still allocated individually, and dominate
+ *          the setup time of small meshes, so only very small meshes (e.g., a few hundred triangles) simplify
+ *          noticeably faster. Meshes simplified by a simplifier are identical to those simplified by
+ *          \c SimplifyWithError.
+ * \note A simplifier must only be used by one thread at a time.
+ */
+class Simplifier {
+
+public:
+	/**
+	 * \brief Initializes a simplifier.
+	 * \param options The options that control how each mesh is simplified.
+	 */
+	explicit Simplifier(SimplificationOptions options = {});
+
+	~Simplifier();
+
+	Simplifier(const Simplifier&) = delete;
+	Simplifier& operator=(const Simplifier&) = delete;
+
+	Simplifier(Simplifier&&) noexcept;
+	Simplifier& operator=(Simplifier&&) noexcept;
+
+	/** \brief Gets the options that control how each mesh is simplified. */
+	[[nodiscard]] const SimplificationOptions& options() const noexcept { return options_; }
+
+	/**
+	 * \brief Reduces the number of triangles in a mesh and reports the geometric error introduced.
+	 * \param mesh The mesh to simplify.
+	 * \param rate The percentage of triangles to be removed.
+	 * \return The simplified mesh and its error estimate.
+	 * \throw std::invalid_argument Indicates \p rate or the options of this simplifier are invalid.
+	 */
+	SimplifiedMesh Simplify(const gfx::MeshView& mesh, float rate);
+
+private:
+	struct Workspace;
+
+	SimplificationOptions options_;
+	std::unique_ptr<Workspace> workspace_;
+};
+
+/**
+ * \brief Reduces the number of triangles in many meshes in parallel.
+ * \details Meshes are divided into contiguous ranges processed by the default thread pool, each with its own
+ *          \c Simplifier, so the buffers each worker retains are reused across the meshes it simplifies (see
+ *          \c Simplifier for which buffers are retained).
+ * \param meshes The meshes to simplify.
+ * \param rate The percentage of triangles to be removed from each mesh.
+ * \param options The options that control simplification.
+ * \return The simplified meshes and their error estimates in the order of \p meshes.
+ * \throw std::invalid_argument Indicates \p rate or \p options are invalid, or that \p options set a checkpoint path,
+ *                              snapshot channel, or memory profiler, which cannot be shared by several meshes.
+ */
+std::vector<SimplifiedMesh> SimplifyAll(std::span<const gfx::MeshView> meshes,
+                                        float rate,
+                                        const SimplificationOptions& options = {});
 }
@@ -0,0 +1,137 @@
+#include "geometry/mesh_snapshot.h"
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+#include "geometry/face.h"
+#include "geometry/face_geometry.h"
+#include "geometry/vertex.h"
+#include "graphics/mesh.h"
+
+using namespace geometry;
+using namespace gfx;
+using namespace glm;
+using namespace std;
+
+void MeshSnapshotChannel::Reset(const mat4& model_transform) {
+	recorded_changes_.vertices.clear();
+	recorded_changes_.faces.clear();
+	recorded_changes_.reset = true;
+	recorded_changes_.model_transform = model_transform;
+}
+
+void MeshSnapshotChannel::AddVertex(const Vertex& vertex) {
+	recorded_changes_.vertices.push_back(VertexChange{.id = vertex.id(), .position = vertex.position(), .removed = false});
+}
+
+void MeshSnapshotChannel::RemoveVertex(const Vertex& vertex) {
+	recorded_changes_.vertices.push_back(VertexChange{.id = vertex.id(), .position = vec3{0.f}, .removed = true});
+}
+
+void MeshSnapshotChannel::AddFace(const Face& face) {
+	recorded_changes_.faces.push_back(FaceChange{
+		.id = hash_value(face), .vertex_ids = {face.v0()->id(), face.v1()->id(), face.v2()->id()}, .removed = false});
+}
+
+void MeshSnapshotChannel::RemoveFace(const Face& face) {
+	recorded_changes_.faces.push_back(FaceChange{.id = hash_value(face), .vertex_ids = {}, .removed = true});
+}
+
+void MeshSnapshotChannel::Commit() {
+	if (recorded_changes_.vertices.empty() && recorded_changes_.faces.empty() && !recorded_changes_.reset) return;
+
+	// the writer never waits for readers, changes remain recorded until a commit finds the channel unlocked
+	if (unique_lock lock{mutex_, try_to_lock}) {
+		Publish();
+	}
+}
+
+void MeshSnapshotChannel::Flush() {
+	if (recorded_changes_.vertices.empty() && recorded_changes_.faces.empty() && !recorded_changes_.reset) return;
+
+	lock_guard lock{mutex_};
+	Publish();
+}
+
+void MeshSnapshotChannel::Publish() {
+
+	// a reset discards changes to the previous mesh that no reader has collected
+	if (recorded_changes_.reset) {
+		published_changes_.vertices.clear();
+		published_changes_.faces.clear();
+		published_changes_.reset = true;
+		published_changes_.model_transform = recorded_changes_.model_transform;
+		recorded_changes_.reset = false;
+	}
+
+	// append rather than move so the recorded buffers keep their capacity across epochs
+	published_changes_.vertices.insert(
+		published_changes_.vertices.end(), recorded_changes_.vertices.begin(), recorded_changes_.vertices.end());
+	published_changes_.faces.insert(
+		published_changes_.faces.end(), recorded_changes_.faces.begin(), recorded_changes_.faces.end());
+	recorded_changes_.vertices.clear();
+	recorded_changes_.faces.clear();
+
+	++epoch_;
+}
+
+optional<Mesh> MeshSnapshotChannel::TakeSnapshot() {
+
+	lock_guard reader_lock{reader_mutex_};
+
+	// only hold the lock shared with the writer long enough to collect the published changes
+	Changes changes;
+	{
+		lock_guard lock{mutex_};
+		if (epoch_ == snapshot_epoch_) return nullopt;
+		swap(changes, published_changes_);
+		snapshot_epoch_ = epoch_;
+	}
+
+	if (changes.reset) {
+		vertices_.clear();
+		faces_.clear();
+		model_transform_ = changes.model_transform;
+	}
+	for (const auto& [id, position, removed] : changes.vertices) {
+		if (removed) {
+			vertices_.erase(id);
+		} else {
+			vertices_.insert_or_assign(id, position);
+		}
+	}
+	for (const auto& [id, vertex_ids, removed] : changes.faces) {
+		if (removed) {
+			faces_.erase(id);
+		} else {
+			faces_.insert_or_assign(id, vertex_ids);
+		}
+	}
+
+	vector<vec3> positions;
+	positions.reserve(vertices_.size());
+	unordered_map<size_t, GLuint> index_map;
+	index_map.reserve(vertices_.size());
+	for (GLuint i = 0; const auto& [id, position] : vertices_) {
+		positions.push_back(position);
+		index_map.emplace(id, i++);
+	}
+
+	// order triangles like the conversion of a half-edge mesh so final snapshots match simplified meshes exactly
+	vector<array<GLuint, 3>> triangles;
+	triangles.reserve(faces_.size());
+	for (const auto& [v0, v1, v2] : faces_ | views::values) {
+		triangles.push_back({index_map.at(v0), index_map.at(v1), index_map.at(v2)});
+	}
+	ranges::sort(triangles);
+
+	vector<GLuint> indices;
+	indices.reserve(triangles.size() * 3);
+	for (const auto& triangle : triangles) {
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+
+	auto normals = ComputeVertexNormals(positions, indices);
+	return Mesh{move(positions), {}, move(normals), move(indices), model_transform_};
+}
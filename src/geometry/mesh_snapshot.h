@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace gfx {
+class Mesh;
+}
+
+namespace geometry {
+class Face;
+class Vertex;
+
+/**
+ * \brief Publishes the state of a half-edge mesh so other threads can take consistent snapshots while it is modified.
+ * \details The writer records the vertices and faces it adds and removes into a private buffer and commits them at
+ *          the end of each consistent modification (e.g., an edge collapse), which begins a new epoch. Committing
+ *          hands the buffered changes to readers without blocking: if a reader is collecting changes, they remain
+ *          buffered until the next commit. Readers apply the changes of every published epoch to their own copy of
+ *          the mesh, so building a snapshot never pauses the writer.
+ * \note Published changes are retained until a reader takes a snapshot, so readers should poll while the mesh is
+ *       modified. Snapshots may be taken from any number of threads, but changes must be recorded from one thread.
+ */
+class MeshSnapshotChannel {
+
+public:
+	/**
+	 * \brief Discards all recorded changes to begin recording a new mesh.
+	 * \param model_transform The model transform of snapshots of the new mesh.
+	 */
+	void Reset(const glm::mat4& model_transform);
+
+	/** \brief Records that a vertex was added to the mesh or moved. */
+	void AddVertex(const Vertex& vertex);
+
+	/** \brief Records that a vertex was removed from the mesh. */
+	void RemoveVertex(const Vertex& vertex);
+
+	/** \brief Records that a face was added to the mesh. */
+	void AddFace(const Face& face);
+
+	/** \brief Records that a face was removed from the mesh. */
+	void RemoveFace(const Face& face);
+
+	/**
+	 * \brief Publishes the changes recorded since the last published epoch if no reader is collecting changes.
+	 * \details Must only be called when the recorded changes leave the mesh in a consistent state.
+	 */
+	void Commit();
+
+	/**
+	 * \brief Publishes the changes recorded since the last published epoch, waiting for readers if necessary.
+	 * \details Must only be called when the recorded changes leave the mesh in a consistent state.
+	 */
+	void Flush();
+
+	/**
+	 * \brief Takes a snapshot of the mesh as of the last published epoch.
+	 * \details Vertices are ordered by ID and triangles by their vertex indices, so a snapshot taken after the final
+	 *          changes were flushed is identical to converting the half-edge mesh to a triangle mesh.
+	 * \return A triangle mesh with area-weighted vertex normals, or \c std::nullopt if no epoch has been published since
+	 *         the last snapshot.
+	 */
+	[[nodiscard]] std::optional<gfx::Mesh> TakeSnapshot();
+
+private:
+	/** \brief A vertex added to or removed from the mesh. */
+	struct VertexChange {
+		std::size_t id;
+		glm::vec3 position;
+		bool removed;
+	};
+
+	/** \brief A face added to or removed from the mesh. */
+	struct FaceChange {
+		std::size_t id;
+		std::array<std::size_t, 3> vertex_ids;
+		bool removed;
+	};
+
+	/** \brief The changes to a mesh since the previous epoch. */
+	struct Changes {
+		std::vector<VertexChange> vertices;
+		std::vector<FaceChange> faces;
+		bool reset = false;
+		glm::mat4 model_transform{1.f};
+	};
+
+	/** \brief Appends the changes recorded by the writer to the published changes, which must be locked. */
+	void Publish();
+
+	Changes recorded_changes_;
+
+	std::mutex mutex_;
+	Changes published_changes_;
+	std::size_t epoch_ = 0;
+
+	std::mutex reader_mutex_;
+	std::map<std::size_t, glm::vec3> vertices_;
+	std::unordered_map<std::size_t, std::array<std::size_t, 3>> faces_;
+	glm::mat4 model_transform_{1.f};
+	std::size_t snapshot_epoch_ = 0;
+};
+}
@@ -0,0 +1,81 @@
+#include "geometry/mesh_tiler.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+using namespace geometry;
+using namespace gfx;
+using namespace glm;
+using namespace std;
+
+namespace {
+
+/** \brief The triangles of a tile and the mapping from source vertex indices to tile vertex indices. */
+struct TileBuilder {
+	vector<vec3> positions;
+	vector<vec2> texture_coordinates;
+	vector<vec3> normals;
+	vector<GLuint> indices;
+	map<GLuint, GLuint> index_map;
+};
+}
+
+vector<mesh::MeshTile> mesh::SplitIntoTiles(
+	const MeshView& mesh, const vec3& box_min, const vec3& box_max, const unsigned int tiles_per_axis) {
+
+	if (tiles_per_axis == 0) throw invalid_argument{"A mesh must be split into at least one tile per axis"};
+
+	const auto& positions = mesh.positions;
+	const auto& indices = mesh.indices;
+	const auto index_count = indices.empty() ? positions.size() : indices.size();
+	const auto get_index = [&](const size_t i) { return indices.empty() ? static_cast<GLuint>(i) : indices[i]; };
+
+	const auto cell_size = max(box_max - box_min, vec3{numeric_limits<float>::min()}) / static_cast<float>(tiles_per_axis);
+	const auto max_coordinate = static_cast<float>(tiles_per_axis - 1);
+
+	// order tiles by coordinates so the output does not depend on triangle order
+	map<tuple<unsigned int, unsigned int, unsigned int>, TileBuilder> tiles;
+	for (size_t i = 0; i + 2 < index_count; i += 3) {
+		const array triangle{get_index(i), get_index(i + 1), get_index(i + 2)};
+		const auto centroid = (positions[triangle[0]] + positions[triangle[1]] + positions[triangle[2]]) / 3.f;
+		const uvec3 coordinates{clamp(floor((centroid - box_min) / cell_size), vec3{0.f}, vec3{max_coordinate})};
+
+		auto& tile = tiles[{coordinates.x, coordinates.y, coordinates.z}];
+		for (const auto index : triangle) {
+			const auto [iterator, inserted] = tile.index_map.emplace(index, static_cast<GLuint>(tile.positions.size()));
+			if (inserted) {
+				tile.positions.push_back(positions[index]);
+				if (!mesh.texture_coordinates.empty()) tile.texture_coordinates.push_back(mesh.texture_coordinates[index]);
+				if (!mesh.normals.empty()) tile.normals.push_back(mesh.normals[index]);
+			}
+			tile.indices.push_back(iterator->second);
+		}
+	}
+
+	vector<MeshTile> mesh_tiles;
+	mesh_tiles.reserve(tiles.size());
+	for (auto& [coordinates, tile] : tiles) {
+		vec3 tile_min{numeric_limits<float>::max()};
+		vec3 tile_max{numeric_limits<float>::lowest()};
+		for (const auto& position : tile.positions) {
+			tile_min = min(tile_min, position);
+			tile_max = max(tile_max, position);
+		}
+		mesh_tiles.push_back(MeshTile{
+			.coordinates = uvec3{get<0>(coordinates), get<1>(coordinates), get<2>(coordinates)},
+			.mesh = Mesh{move(tile.positions),
+			             move(tile.texture_coordinates),
+			             move(tile.normals),
+			             move(tile.indices),
+			             mesh.model_transform,
+			             tile_min,
+			             tile_max}});
+	}
+	return mesh_tiles;
+}
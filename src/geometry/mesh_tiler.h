@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "graphics/mesh.h"
+
+namespace geometry::mesh {
+
+/** \brief A spatial tile of a mesh. */
+struct MeshTile {
+
+	/** \brief The integer coordinates of the tile in its grid. */
+	glm::uvec3 coordinates;
+
+	/** \brief The triangles whose centroids lie inside the tile. */
+	gfx::Mesh mesh;
+};
+
+/**
+ * \brief Splits a mesh into a uniform grid of tiles.
+ * \details Each triangle is assigned to the tile containing its centroid, so tiles may extend slightly past their grid
+ *          cell but every triangle belongs to exactly one tile. Splitting each level of detail of a mesh over the same
+ *          grid produces a level of detail chain per tile.
+ * \param mesh The mesh to split. If the mesh has no indices, its positions are treated as a triangle list.
+ * \param box_min,box_max The bounds of the grid in object space.
+ * \param tiles_per_axis The number of grid cells along each axis.
+ * \return The nonempty tiles. Tile meshes only contain vertices referenced by their triangles and keep the texture
+ *         coordinates, normals, and model transform of \p mesh.
+ * \throw std::invalid_argument Indicates \p tiles_per_axis is zero.
+ */
+std::vector<MeshTile> SplitIntoTiles(
+	const gfx::MeshView& mesh, const glm::vec3& box_min, const glm::vec3& box_max, unsigned int tiles_per_axis);
+}
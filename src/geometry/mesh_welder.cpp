@@ -0,0 +1,64 @@
+#include "geometry/mesh_welder.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include "graphics/mesh.h"
+
+using namespace geometry;
+using namespace gfx;
+using namespace glm;
+using namespace std;
+
+namespace {
+
+/** \brief Hashes a position by its exact bit pattern so only identical positions are merged. */
+struct PositionHash {
+	size_t operator()(const vec3& position) const noexcept {
+		size_t seed = 0;
+		for (auto i = 0; i < 3; ++i) {
+			seed ^= hash<float>{}(position[i]) + 0x9E3779B9 + (seed << 6) + (seed >> 2);
+		}
+		return seed;
+	}
+};
+}
+
+Mesh mesh::Weld(const Mesh& mesh) {
+	const auto& positions = mesh.GetPositions();
+	const auto& indices = mesh.GetIndices();
+
+	// meshes without an element buffer define a triangle for every three consecutive positions
+	const auto index_count = indices.empty() ? positions.size() : indices.size();
+	const auto get_index = [&](const size_t i) { return indices.empty() ? static_cast<GLuint>(i) : indices[i]; };
+
+	vector<vec3> welded_positions;
+	vector<GLuint> welded_indices;
+	welded_indices.reserve(index_count);
+
+	unordered_map<vec3, GLuint, PositionHash> index_map;
+	index_map.reserve(positions.size());
+
+	vector<GLuint> remap(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i) {
+		const auto [iterator, inserted] = index_map.emplace(positions[i], static_cast<GLuint>(welded_positions.size()));
+		if (inserted) welded_positions.push_back(positions[i]);
+		remap[i] = iterator->second;
+	}
+
+	for (size_t i = 0; i + 2 < index_count; i += 3) {
+		const array<GLuint, 3> triangle{remap[get_index(i)], remap[get_index(i + 1)], remap[get_index(i + 2)]};
+		const auto& p0 = welded_positions[triangle[0]];
+		const auto& p1 = welded_positions[triangle[1]];
+		const auto& p2 = welded_positions[triangle[2]];
+		if (length(cross(p1 - p0, p2 - p0)) == 0.f) continue;
+		welded_indices.insert(welded_indices.end(), triangle.begin(), triangle.end());
+	}
+
+	return Mesh{
+		move(welded_positions), {}, {}, move(welded_indices), mesh.GetModelTransform(), mesh.GetBoxMin(), mesh.GetBoxMax()};
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace gfx {
+class Mesh;
+}
+
+namespace geometry::mesh {
+
+/**
+ * \brief Merges mesh vertices that share the same position into a single indexed vertex.
+ * \param mesh The mesh to weld.
+ * \return An indexed triangle mesh where each distinct position appears once. Triangles that collapse to a line or a
+ *         point after welding are removed.
+ * \note Texture coordinates and normals are discarded because they cannot be shared across welded vertices.
+ *       Simplified meshes recompute normals from the welded connectivity.
+ */
+gfx::Mesh Weld(const gfx::Mesh& mesh);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#include "geometry/face.h"
+#include "geometry/half_edge.h"
+#include "geometry/vertex.h"
+
+namespace geometry {
+
+/** \brief The elements of a vertex one-ring visited by a \c OneRing range. */
+enum class OneRingElement { kIncomingHalfEdges, kOutgoingHalfEdges, kFaces, kVertices };
+
+/**
+ * \brief An iterator that circulates the one-ring of a vertex in a closed half-edge mesh.
+ * \details Steps through the half-edges pointing to the vertex starting from \c Vertex::edge and yields references to
+ *          the mesh elements reached from each of them. The iterator only stores raw pointers, so it is trivially
+ *          copyable and traversals do not modify reference counts. The mesh must not be modified during iteration.
+ * \tparam Element The elements of the one-ring to visit.
+ */
+template <OneRingElement Element>
+class OneRingIterator {
+
+public:
+	using iterator_concept = std::forward_iterator_tag;
+	using iterator_category = std::forward_iterator_tag;
+	using difference_type = std::ptrdiff_t;
+	using value_type = std::conditional_t<Element == OneRingElement::kFaces,
+	                                      std::shared_ptr<Face>,
+	                                      std::conditional_t<Element == OneRingElement::kVertices,
+	                                                         std::shared_ptr<Vertex>,
+	                                                         std::shared_ptr<HalfEdge>>>;
+
+	OneRingIterator() noexcept = default;
+
+	/**
+	 * \brief Initializes an iterator at the first half-edge of a one-ring.
+	 * \param edge The first half-edge pointing to the one-ring vertex, or \c nullptr for an empty one-ring.
+	 */
+	explicit OneRingIterator(const std::shared_ptr<HalfEdge>& edge) noexcept
+		: edgei0_{edge ? &edge : nullptr}, first_{edge.get()} {}
+
+	/** \brief Gets the one-ring element for the current half-edge pointing to the vertex. */
+	[[nodiscard]] const value_type& operator*() const noexcept {
+		const auto& edgei0 = *edgei0_;
+		if constexpr (Element == OneRingElement::kIncomingHalfEdges) {
+			return edgei0;
+		} else if constexpr (Element == OneRingElement::kOutgoingHalfEdges) {
+			return edgei0->flip();
+		} else if constexpr (Element == OneRingElement::kFaces) {
+			return edgei0->face();
+		} else {
+			return edgei0->flip()->vertex();
+		}
+	}
+
+	/** \brief Advances to the next half-edge pointing to the vertex in counter-clockwise order. */
+	OneRingIterator& operator++() noexcept {
+		edgei0_ = &(*edgei0_)->next()->flip();
+		if (edgei0_->get() == first_) {
+			edgei0_ = nullptr;
+		}
+		return *this;
+	}
+
+	OneRingIterator operator++(int) noexcept {
+		const auto iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	friend bool operator==(const OneRingIterator&, const OneRingIterator&) noexcept = default;
+
+	/** \brief Determines if the iterator has circulated the whole one-ring. */
+	friend bool operator==(const OneRingIterator& iterator, std::default_sentinel_t) noexcept {
+		return iterator.edgei0_ == nullptr;
+	}
+
+private:
+	const std::shared_ptr<HalfEdge>* edgei0_ = nullptr;
+	const HalfEdge* first_ = nullptr;
+};
+
+/**
+ * \brief A view of the elements in the one-ring of a vertex.
+ * \tparam Element The elements of the one-ring to visit.
+ */
+template <OneRingElement Element>
+class OneRing : public std::ranges::view_interface<OneRing<Element>> {
+
+public:
+	OneRing() noexcept = default;
+
+	/**
+	 * \brief Initializes a view of the one-ring of a vertex.
+	 * \param vertex The vertex whose one-ring to visit, which must outlive the view and its iterators.
+	 */
+	explicit OneRing(const Vertex& vertex) noexcept : edge_{&vertex.edge()} {}
+
+	[[nodiscard]] OneRingIterator<Element> begin() const noexcept {
+		return edge_ ? OneRingIterator<Element>{*edge_} : OneRingIterator<Element>{};
+	}
+
+	[[nodiscard]] static std::default_sentinel_t end() noexcept { return std::default_sentinel; }
+
+private:
+	const std::shared_ptr<HalfEdge>* edge_ = nullptr;
+};
+
+/** \brief Gets the half-edges pointing to a vertex in counter-clockwise order. */
+[[nodiscard]] inline OneRing<OneRingElement::kIncomingHalfEdges> IncomingHalfEdges(const Vertex& vertex) noexcept {
+	return OneRing<OneRingElement::kIncomingHalfEdges>{vertex};
+}
+
+/** \brief Gets the half-edges leaving a vertex in counter-clockwise order. */
+[[nodiscard]] inline OneRing<OneRingElement::kOutgoingHalfEdges> OutgoingHalfEdges(const Vertex& vertex) noexcept {
+	return OneRing<OneRingElement::kOutgoingHalfEdges>{vertex};
+}
+
+/** \brief Gets the faces incident to a vertex in counter-clockwise order. */
+[[nodiscard]] inline OneRing<OneRingElement::kFaces> IncidentFaces(const Vertex& vertex) noexcept {
+	return OneRing<OneRingElement::kFaces>{vertex};
+}
+
+/** \brief Gets the vertices connected to a vertex by an edge in counter-clockwise order. */
+[[nodiscard]] inline OneRing<OneRingElement::kVertices> AdjacentVertices(const Vertex& vertex) noexcept {
+	return OneRing<OneRingElement::kVertices>{vertex};
+}
+
+static_assert(std::is_trivially_copyable_v<OneRingIterator<OneRingElement::kIncomingHalfEdges>>);
+static_assert(std::ranges::forward_range<OneRing<OneRingElement::kIncomingHalfEdges>>);
+static_assert(std::ranges::view<OneRing<OneRingElement::kIncomingHalfEdges>>);
+}
+
+// one-rings refer to mesh elements rather than owning them, so their iterators remain valid after the view is destroyed
+template <geometry::OneRingElement Element>
+inline constexpr bool std::ranges::enable_borrowed_range<geometry::OneRing<Element>> = true;
@@ -0,0 +1,331 @@
+#include "geometry/ray_caster.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+
+#include <glm/glm.hpp>
+
+using namespace geometry;
+using namespace glm;
+using namespace std;
+
+namespace {
+
+/** \brief The number of bins triangle centroids are sorted into when searching for the best split of a node. */
+constexpr size_t kBinCount = 16;
+
+/** \brief The largest number of triangles of a node that is never split. */
+constexpr uint32_t kMinLeafSize = 4;
+
+/** \brief The largest number of triangles of a node that is not split if no split lowers its cost. */
+constexpr uint32_t kMaxLeafSize = 16;
+
+/**
+ * \brief The depth below which nodes are split at their median rather than by cost, which bounds the hierarchy depth
+ *        for degenerate inputs (e.g., many triangles sharing a centroid) where cost-based splits are unbalanced.
+ */
+constexpr uint32_t kMaxCostSplitDepth = 64;
+
+/** \brief The capacity of the traversal stack, which exceeds the depth of any hierarchy of 32-bit triangle counts. */
+constexpr size_t kTraversalStackSize = kMaxCostSplitDepth + 64;
+
+/**
+ * \brief The tolerance of barycentric coordinates of ray-triangle intersections, which slightly enlarges triangles so
+ *        rays through an edge or vertex shared by several triangles hit at least one of them despite rounding errors.
+ */
+constexpr auto kBarycentricTolerance = 1e-5f;
+
+constexpr auto kInfinity = numeric_limits<float>::infinity();
+
+/** \brief An axis-aligned bounding box. */
+struct Box {
+
+	/** \brief Extends the box to contain a point. */
+	void Grow(const vec3& point) noexcept {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	/** \brief Extends the box to contain another box. */
+	void Grow(const Box& box) noexcept {
+		min = glm::min(min, box.min);
+		max = glm::max(max, box.max);
+	}
+
+	/** \brief Gets half the surface area of the box, which is proportional to the probability of a ray hitting it. */
+	[[nodiscard]] float HalfArea() const noexcept {
+		const auto extent = max - min;
+		return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+	}
+
+	vec3 min{kInfinity};
+	vec3 max{-kInfinity};
+};
+
+/**
+ * \brief Intersects a ray with a bounding box.
+ * \param box_min,box_max The corners of the box.
+ * \param origin The ray origin.
+ * \param inverse_direction The reciprocal of each component of the ray direction.
+ * \param max_distance The largest distance along the ray to consider.
+ * \return The distance at which the ray enters the box, or infinity if it misses the box within \p max_distance.
+ */
+float IntersectBox(const vec3& box_min,
+                   const vec3& box_max,
+                   const vec3& origin,
+                   const vec3& inverse_direction,
+                   const float max_distance) noexcept {
+	const auto t0 = (box_min - origin) * inverse_direction;
+	const auto t1 = (box_max - origin) * inverse_direction;
+	const auto t_near = glm::min(t0, t1);
+	const auto t_far = glm::max(t0, t1);
+	const auto entry = std::max({t_near.x, t_near.y, t_near.z, 0.f});
+	const auto exit = std::min({t_far.x, t_far.y, t_far.z, max_distance});
+	return entry <= exit ? entry : kInfinity;
+}
+
+/**
+ * \brief Intersects a ray with a triangle from either side using the Möller-Trumbore algorithm.
+ * \param origin The ray origin.
+ * \param direction The ray direction.
+ * \param triangle The three triangle vertices.
+ * \return The distance along the ray to the intersection, or infinity if the ray misses the triangle.
+ */
+float IntersectTriangle(const vec3& origin, const vec3& direction, const vec3* const triangle) noexcept {
+	const auto edge01 = triangle[1] - triangle[0];
+	const auto edge02 = triangle[2] - triangle[0];
+	const auto p = cross(direction, edge02);
+	const auto determinant = dot(edge01, p);
+	if (determinant == 0.f) return kInfinity;
+
+	const auto inverse_determinant = 1.f / determinant;
+	const auto s = origin - triangle[0];
+	const auto u = dot(s, p) * inverse_determinant;
+	if (u < -kBarycentricTolerance || u > 1.f + kBarycentricTolerance) return kInfinity;
+
+	const auto q = cross(s, edge01);
+	const auto v = dot(direction, q) * inverse_determinant;
+	if (v < -kBarycentricTolerance || u + v > 1.f + kBarycentricTolerance) return kInfinity;
+
+	const auto distance = dot(edge02, q) * inverse_determinant;
+	return distance > 0.f ? distance : kInfinity;
+}
+}
+
+RayCaster::RayCaster(const span<const vec3> positions, const span<const unsigned int> indices) {
+
+	const auto triangle_count = (indices.empty() ? positions.size() : indices.size()) / 3;
+	if (triangle_count > numeric_limits<uint32_t>::max()) {
+		throw length_error{format("Cannot cast rays against {} triangles", triangle_count)};
+	}
+	const auto get_vertex = [&](const size_t triangle, const size_t corner) noexcept {
+		const auto i = triangle * 3 + corner;
+		return positions[indices.empty() ? i : indices[i]];
+	};
+
+	vector<Box> triangle_boxes(triangle_count);
+	vector<vec3> centroids(triangle_count);
+	Box mesh_box;
+	for (size_t i = 0; i < triangle_count; ++i) {
+		for (size_t corner = 0; corner < 3; ++corner) {
+			triangle_boxes[i].Grow(get_vertex(i, corner));
+		}
+		centroids[i] = (get_vertex(i, 0) + get_vertex(i, 1) + get_vertex(i, 2)) / 3.f;
+		mesh_box.Grow(triangle_boxes[i]);
+	}
+
+	triangles_.resize(triangle_count);
+	iota(triangles_.begin(), triangles_.end(), uint32_t{0});
+	if (triangle_count == 0) return;
+	box_min_ = mesh_box.min;
+	box_max_ = mesh_box.max;
+
+	// nodes are split in depth-first order, each split appends both children so siblings are adjacent
+	struct Task {
+		uint32_t node, begin, end, depth;
+	};
+	nodes_.reserve(triangle_count / kMinLeafSize * 2 + 1);
+	nodes_.push_back(Node{});
+	vector<Task> tasks{Task{.node = 0, .begin = 0, .end = static_cast<uint32_t>(triangle_count), .depth = 0}};
+
+	while (!tasks.empty()) {
+		const auto [node, begin, end, depth] = tasks.back();
+		tasks.pop_back();
+
+		Box node_box, centroid_box;
+		for (auto i = begin; i < end; ++i) {
+			node_box.Grow(triangle_boxes[triangles_[i]]);
+			centroid_box.Grow(centroids[triangles_[i]]);
+		}
+		const auto count = end - begin;
+		nodes_[node] = Node{.box_min = node_box.min, .first = begin, .box_max = node_box.max, .count = count};
+		if (count <= kMinLeafSize) continue;
+
+		const auto extent = centroid_box.max - centroid_box.min;
+		const auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+		auto middle = begin;
+
+		if (extent[axis] > 0.f && depth < kMaxCostSplitDepth) {
+			const auto bin_scale = static_cast<float>(kBinCount) / extent[axis];
+			const auto get_bin = [&](const uint32_t triangle) noexcept {
+				const auto offset = (centroids[triangle][axis] - centroid_box.min[axis]) * bin_scale;
+				return std::min(static_cast<size_t>(offset), kBinCount - 1);
+			};
+
+			array<Box, kBinCount> bin_boxes;
+			array<uint32_t, kBinCount> bin_counts{};
+			for (auto i = begin; i < end; ++i) {
+				const auto bin = get_bin(triangles_[i]);
+				bin_boxes[bin].Grow(triangle_boxes[triangles_[i]]);
+				++bin_counts[bin];
+			}
+
+			// sweep from the right to accumulate the cost of the right side of each split between bins
+			array<float, kBinCount - 1> right_costs{};
+			Box right_box;
+			uint32_t right_count = 0;
+			for (auto bin = kBinCount - 1; bin > 0; --bin) {
+				right_box.Grow(bin_boxes[bin]);
+				right_count += bin_counts[bin];
+				right_costs[bin - 1] = right_count > 0 ? right_box.HalfArea() * static_cast<float>(right_count) : 0.f;
+			}
+
+			Box left_box;
+			uint32_t left_count = 0;
+			auto best_cost = kInfinity;
+			size_t best_split = 0;
+			for (size_t bin = 0; bin < kBinCount - 1; ++bin) {
+				left_box.Grow(bin_boxes[bin]);
+				left_count += bin_counts[bin];
+				if (left_count == 0 || left_count == count) continue;
+				if (const auto cost = left_box.HalfArea() * static_cast<float>(left_count) + right_costs[bin]; cost < best_cost) {
+					best_cost = cost;
+					best_split = bin + 1;
+				}
+			}
+
+			// keep small nodes as leaves when intersecting every triangle is cheaper than any split
+			if (best_split > 0) {
+				if (count <= kMaxLeafSize && best_cost >= node_box.HalfArea() * static_cast<float>(count)) continue;
+				middle = static_cast<uint32_t>(
+					partition(triangles_.begin() + begin,
+					          triangles_.begin() + end,
+					          [&](const uint32_t triangle) noexcept { return get_bin(triangle) < best_split; })
+					- triangles_.begin());
+			}
+		}
+
+		// split at the median centroid when no bin boundary separates the triangles, breaking ties by triangle index
+		if (middle == begin || middle == end) {
+			middle = begin + count / 2;
+			nth_element(triangles_.begin() + begin,
+			            triangles_.begin() + middle,
+			            triangles_.begin() + end,
+			            [&](const uint32_t lhs, const uint32_t rhs) noexcept {
+				            const auto lhs_centroid = centroids[lhs][axis], rhs_centroid = centroids[rhs][axis];
+				            return lhs_centroid != rhs_centroid ? lhs_centroid < rhs_centroid : lhs < rhs;
+			            });
+		}
+
+		const auto first_child = static_cast<uint32_t>(nodes_.size());
+		nodes_[node].first = first_child;
+		nodes_[node].count = 0;
+		nodes_.resize(nodes_.size() + 2);
+		tasks.push_back(Task{.node = first_child, .begin = begin, .end = middle, .depth = depth + 1});
+		tasks.push_back(Task{.node = first_child + 1, .begin = middle, .end = end, .depth = depth + 1});
+	}
+
+	// store triangle vertices in hierarchy order so the triangles of a leaf are contiguous in memory
+	vertices_.reserve(triangle_count * 3);
+	for (const auto triangle : triangles_) {
+		for (size_t corner = 0; corner < 3; ++corner) {
+			vertices_.push_back(get_vertex(triangle, corner));
+		}
+	}
+}
+
+vector<vec3> geometry::SampleSphere(const size_t count) {
+	const auto golden_angle = numbers::pi_v<float> * (3.f - std::sqrt(5.f));
+	vector<vec3> directions(count);
+	for (size_t i = 0; i < count; ++i) {
+		const auto z = 1.f - (2.f * static_cast<float>(i) + 1.f) / static_cast<float>(count);
+		const auto radius = std::sqrt(std::max(0.f, 1.f - z * z));
+		const auto azimuth = static_cast<float>(i) * golden_angle;
+		directions[i] = vec3{radius * std::cos(azimuth), radius * std::sin(azimuth), z};
+	}
+	return directions;
+}
+
+optional<RayHit> RayCaster::Cast(const vec3& origin, const vec3& direction, const float max_distance) const noexcept {
+	return Traverse<false>(origin, direction, max_distance);
+}
+
+bool RayCaster::IsOccluded(const vec3& origin, const vec3& direction, const float max_distance) const noexcept {
+	return Traverse<true>(origin, direction, max_distance).has_value();
+}
+
+template <bool kAnyHit>
+optional<RayHit> RayCaster::Traverse(const vec3& origin, const vec3& direction, const float max_distance) const noexcept {
+
+	if (nodes_.empty()) return nullopt;
+	const auto inverse_direction = 1.f / direction;
+	if (IntersectBox(nodes_[0].box_min, nodes_[0].box_max, origin, inverse_direction, max_distance) == kInfinity) {
+		return nullopt;
+	}
+
+	struct Entry {
+		uint32_t node;
+		float distance;
+	};
+	array<Entry, kTraversalStackSize> stack;
+	size_t stack_size = 0;
+
+	optional<RayHit> closest_hit;
+	auto closest_distance = max_distance;
+	uint32_t node_index = 0;
+
+	for (;;) {
+		if (const auto& node = nodes_[node_index]; node.count > 0) {
+			for (auto i = node.first; i < node.first + node.count; ++i) {
+				if (const auto distance = IntersectTriangle(origin, direction, &vertices_[size_t{i} * 3]);
+					distance < closest_distance) {
+					closest_distance = distance;
+					closest_hit = RayHit{.triangle = triangles_[i], .distance = distance};
+					if constexpr (kAnyHit) return closest_hit;
+				}
+			}
+		} else {
+			// descend into the nearer child first so hits found there prune the farther child
+			auto near_node = node.first, far_node = node.first + 1;
+			auto near_distance = IntersectBox(
+				nodes_[near_node].box_min, nodes_[near_node].box_max, origin, inverse_direction, closest_distance);
+			auto far_distance = IntersectBox(
+				nodes_[far_node].box_min, nodes_[far_node].box_max, origin, inverse_direction, closest_distance);
+			if (far_distance < near_distance) {
+				swap(near_node, far_node);
+				swap(near_distance, far_distance);
+			}
+			if (near_distance != kInfinity) {
+				if (far_distance != kInfinity) {
+					stack[stack_size++] = Entry{.node = far_node, .distance = far_distance};
+				}
+				node_index = near_node;
+				continue;
+			}
+		}
+
+		// resume with the nearest deferred node that may still hold a closer hit
+		for (;;) {
+			if (stack_size == 0) return closest_hit;
+			if (const auto [deferred_node, distance] = stack[--stack_size]; distance < closest_distance) {
+				node_index = deferred_node;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+namespace geometry {
+
+/** \brief The intersection of a ray with a triangle. */
+struct RayHit {
+
+	/** \brief The index of the intersected triangle in the mesh the ray caster was built from. */
+	std::size_t triangle;
+
+	/** \brief The distance to the intersection along the ray in multiples of the ray direction. */
+	float distance;
+};
+
+/**
+ * \brief Casts rays against the triangles of a mesh.
+ * \details Triangles are organized in a bounding volume hierarchy whose nodes are split by binning triangle centroids
+ *          along their longest axis and choosing the split with the lowest surface area heuristic cost, so each query
+ *          visits a number of nodes logarithmic in the triangle count for typical meshes. Rays do not leak through
+ *          the edges and vertices shared by triangles of closed meshes. Building is deterministic, and queries do not
+ *          modify the ray caster so they may be issued from any number of threads concurrently.
+ */
+class RayCaster {
+
+public:
+	/**
+	 * \brief Builds a ray caster.
+	 * \param positions The mesh vertex positions.
+	 * \param indices Element indices such that each three consecutive integers define a triangle. Every index must refer
+	 *                to an element of \p positions. If empty, \p positions are treated as a triangle list.
+	 */
+	RayCaster(std::span<const glm::vec3> positions, std::span<const unsigned int> indices);
+
+	/** \brief Gets the number of triangles. */
+	[[nodiscard]] std::size_t size() const noexcept { return triangles_.size(); }
+
+	/** \brief Gets the minimum corner of the bounding box of the triangles. */
+	[[nodiscard]] const glm::vec3& box_min() const noexcept { return box_min_; }
+
+	/** \brief Gets the maximum corner of the bounding box of the triangles. */
+	[[nodiscard]] const glm::vec3& box_max() const noexcept { return box_max_; }
+
+	/**
+	 * \brief Finds the closest triangle hit by a ray.
+	 * \param origin The ray origin.
+	 * \param direction The ray direction, which need not be normalized.
+	 * \param max_distance The largest distance along the ray to consider in multiples of \p direction.
+	 * \return The closest hit in front of \p origin within \p max_distance, or \c std::nullopt if there is none.
+	 *         Triangles are hit from either side.
+	 */
+	[[nodiscard]] std::optional<RayHit> Cast(const glm::vec3& origin,
+	                                         const glm::vec3& direction,
+	                                         float max_distance = std::numeric_limits<float>::infinity()) const noexcept;
+
+	/**
+	 * \brief Determines if a ray hits any triangle, which stops at the first hit rather than finding the closest.
+	 * \param origin The ray origin.
+	 * \param direction The ray direction, which need not be normalized.
+	 * \param max_distance The largest distance along the ray to consider in multiples of \p direction.
+	 * \return \c true if a triangle is hit in front of \p origin within \p max_distance, otherwise \c false.
+	 */
+	[[nodiscard]] bool IsOccluded(const glm::vec3& origin,
+	                              const glm::vec3& direction,
+	                              float max_distance = std::numeric_limits<float>::infinity()) const noexcept;
+
+private:
+	/**
+	 * \brief A node of the bounding volume hierarchy.
+	 * \details Interior nodes refer to their first child, which is followed by its sibling, and leaves refer to a range
+	 *          of triangles in hierarchy order.
+	 */
+	struct Node {
+		glm::vec3 box_min;
+		std::uint32_t first;
+		glm::vec3 box_max;
+		std::uint32_t count;
+	};
+
+	/** \brief Traverses the hierarchy, stopping at the first hit if \p kAnyHit or else finding the closest hit. */
+	template <bool kAnyHit>
+	[[nodiscard]] std::optional<RayHit> Traverse(const glm::vec3& origin,
+	                                             const glm::vec3& direction,
+	                                             float max_distance) const noexcept;
+
+	std::vector<Node> nodes_;
+	std::vector<glm::vec3> vertices_;
+	std::vector<std::uint32_t> triangles_;
+	glm::vec3 box_min_{0.f};
+	glm::vec3 box_max_{0.f};
+};
+
+/**
+ * \brief Gets ray directions nearly evenly distributed over the unit sphere.
+ * \details Directions lie on a Fibonacci spiral from the north pole to the south pole, which covers the sphere evenly
+ *          for any number of directions.
+ * \param count The number of directions.
+ * \return \p count unit vectors.
+ */
+std::vector<glm::vec3> SampleSphere(std::size_t count);
+}
@@ -28,8 +28,14 @@ public:
 	/** \brief Gets the vertex position. */
 	[[nodiscard]] const glm::vec3& position() const noexcept { return position_; }
 
+	/**
+	 * \brief Sets the vertex position.
+	 * \note Faces cache their geometry, so vertices of a half-edge mesh are moved with \c HalfEdgeMesh::MoveVertex.
+	 */
+	void set_position(const glm::vec3& position) noexcept { position_ = position; }
+
 	/** \brief Gets the last created half-edge that points to this vertex. */
-	[[nodiscard]] std::shared_ptr<HalfEdge> edge() const noexcept { return edge_; }
+	[[nodiscard]] const std::shared_ptr<HalfEdge>& edge() const noexcept { return edge_; }
 
 	/** \brief Sets the vertex half-edge. */
 	void set_edge(const std::shared_ptr<HalfEdge>& edge) noexcept { edge_ = edge; }
@@ -40,21 +46,33 @@ public:
 	/** \brief Gets the hash value for two vertices. */
 	friend std::size_t hash_value(const Vertex& v0, const Vertex& v1) noexcept {
 		std::size_t seed = 0x32C95994;
-		seed ^= (seed << 6) + (seed >> 2) + 0x3FA612CE + hash_value(v0);
-		seed ^= (seed << 6) + (seed >> 2) + 0x197685C2 + hash_value(v1);
+		seed = HashCombine(seed, 0x3FA612CE + hash_value(v0));
+		seed = HashCombine(seed, 0x197685C2 + hash_value(v1));
 		return seed;
 	}
 
 	/** \brief Gets the hash value for three vertices. */
 	friend std::size_t hash_value(const Vertex& v0, const Vertex& v1, const Vertex& v2) noexcept {
 		std::size_t seed = 0x230402B5;
-		seed ^= (seed << 6) + (seed >> 2) + 0x72C2C6EB + hash_value(v0);
-		seed ^= (seed << 6) + (seed >> 2) + 0x16E199E4 + hash_value(v1);
-		seed ^= (seed << 6) + (seed >> 2) + 0x6F89F2A8 + hash_value(v2);
+		seed = HashCombine(seed, 0x72C2C6EB + hash_value(v0));
+		seed = HashCombine(seed, 0x16E199E4 + hash_value(v1));
+		seed = HashCombine(seed, 0x6F89F2A8 + hash_value(v2));
 		return seed;
 	}
 
 private:
+	/**
+	 * \brief Combines a value into a hash seed.
+	 * \details Vertex IDs hash to themselves, so the combined result is passed through a 64-bit finalizer
+	 *          (splitmix64) to prevent small sequential IDs from producing colliding edge and face keys.
+	 */
+	static constexpr std::size_t HashCombine(std::size_t seed, const std::size_t value) noexcept {
+		seed ^= value + 0x9E3779B97F4A7C15 + (seed << 6) + (seed >> 2);
+		seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9;
+		seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EB;
+		return seed ^ (seed >> 31);
+	}
+
 	std::size_t id_;
 	glm::vec3 position_;
 	std::shared_ptr<HalfEdge> edge_;
@@ -0,0 +1,172 @@
+#include "geometry/vertex_cache_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+/** \brief The simulated cache size, larger than most hardware caches so the order works well across hardware. */
+constexpr int kCacheSize = 32;
+constexpr float kLastTriangleScore = .75f;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kValenceBoostScale = 2.f;
+constexpr float kValenceBoostPower = .5f;
+
+/** \brief Per-vertex optimization state. */
+struct VertexState {
+	int cache_position = -1;
+	float score = 0.f;
+	unsigned int remaining_triangles = 0;
+	unsigned int triangles_offset = 0;
+};
+
+/** \brief The number of remaining triangles per vertex beyond which the valence boost is approximated as constant. */
+constexpr unsigned int kMaxScoredValence = 64;
+
+/** \brief Precomputed vertex score terms which avoids evaluating \c pow in the inner loop. */
+struct ScoreTables {
+	array<float, kCacheSize> cache_position;
+	array<float, kMaxScoredValence + 1> valence;
+};
+
+const ScoreTables& GetScoreTables() noexcept {
+	static const auto score_tables = [] {
+		ScoreTables tables{};
+		for (auto i = 0; i < kCacheSize; ++i) {
+			// the three vertices of the last triangle get a fixed score so the next triangle does not always share an edge
+			tables.cache_position[i] = i < 3
+				? kLastTriangleScore
+				: pow(1.f - static_cast<float>(i - 3) / (kCacheSize - 3), kCacheDecayPower);
+		}
+		for (unsigned int i = 1; i <= kMaxScoredValence; ++i) {
+			tables.valence[i] = kValenceBoostScale * pow(static_cast<float>(i), -kValenceBoostPower);
+		}
+		return tables;
+	}();
+	return score_tables;
+}
+
+/**
+ * \brief Scores a vertex so that recently used vertices and vertices with few remaining triangles are preferred.
+ * \param vertex The vertex to score.
+ * \return The vertex score, or zero if no triangles that use the vertex remain.
+ */
+float ComputeScore(const VertexState& vertex) noexcept {
+	if (vertex.remaining_triangles == 0) return 0.f;
+
+	const auto& score_tables = GetScoreTables();
+	const auto cache_score = vertex.cache_position >= 0 ? score_tables.cache_position[vertex.cache_position] : 0.f;
+	return cache_score + score_tables.valence[min(vertex.remaining_triangles, kMaxScoredValence)];
+}
+}
+
+vector<unsigned int> geometry::mesh::OptimizeVertexCache(const span<const unsigned int> indices, const size_t vertex_count) {
+
+	if (indices.size() % 3 != 0) throw invalid_argument{"Object must be a triangle mesh"};
+	if (ranges::any_of(indices, [vertex_count](const auto index) { return index >= vertex_count; })) {
+		throw invalid_argument{"Vertex index is out of range"};
+	}
+
+	const auto triangle_count = indices.size() / 3;
+	vector<VertexState> vertices(vertex_count);
+
+	// build vertex to triangle adjacency in a single array indexed by each vertex's triangles offset
+	for (const auto index : indices) ++vertices[index].remaining_triangles;
+	unsigned int offset = 0;
+	for (auto& vertex : vertices) {
+		vertex.triangles_offset = offset;
+		offset += vertex.remaining_triangles;
+		vertex.score = ComputeScore(vertex);
+		vertex.remaining_triangles = 0;
+	}
+	vector<unsigned int> vertex_triangles(indices.size());
+	for (size_t i = 0; i < indices.size(); ++i) {
+		auto& vertex = vertices[indices[i]];
+		vertex_triangles[vertex.triangles_offset + vertex.remaining_triangles++] = static_cast<unsigned int>(i / 3);
+	}
+
+	vector<float> triangle_scores(triangle_count);
+	vector<bool> emitted(triangle_count);
+	for (size_t i = 0; i < triangle_count; ++i) {
+		triangle_scores[i] = vertices[indices[3 * i]].score + vertices[indices[3 * i + 1]].score
+			+ vertices[indices[3 * i + 2]].score;
+	}
+
+	vector<unsigned int> optimized_indices;
+	optimized_indices.reserve(indices.size());
+
+	array<unsigned int, kCacheSize + 3> cache{};
+	array<unsigned int, kCacheSize + 3> next_cache{};
+	size_t cache_size = 0;
+	size_t next_unemitted_triangle = 0;
+	auto best_triangle = triangle_count == 0 ? numeric_limits<size_t>::max() : 0;
+
+	while (optimized_indices.size() < indices.size()) {
+
+		// when no cached vertex has remaining triangles, restart from the first triangle not yet emitted
+		if (best_triangle == numeric_limits<size_t>::max()) {
+			while (emitted[next_unemitted_triangle]) ++next_unemitted_triangle;
+			best_triangle = next_unemitted_triangle;
+		}
+
+		emitted[best_triangle] = true;
+		const auto* const triangle = &indices[3 * best_triangle];
+
+		// emit the triangle and remove it from the adjacency of its vertices
+		size_t next_cache_size = 0;
+		for (auto i = 0; i < 3; ++i) {
+			const auto index = triangle[i];
+			optimized_indices.push_back(index);
+			next_cache[next_cache_size++] = index;
+
+			auto& vertex = vertices[index];
+			const auto first = vertex_triangles.begin() + vertex.triangles_offset;
+			const auto last = first + vertex.remaining_triangles;
+			iter_swap(find(first, last, static_cast<unsigned int>(best_triangle)), last - 1);
+			--vertex.remaining_triangles;
+		}
+
+		// move the triangle vertices to the front of the cache, vertices beyond the cache size are evicted
+		for (size_t i = 0; i < cache_size; ++i) {
+			const auto index = cache[i];
+			if (index != triangle[0] && index != triangle[1] && index != triangle[2]) {
+				next_cache[next_cache_size++] = index;
+			}
+		}
+		swap(cache, next_cache);
+		cache_size = next_cache_size;
+
+		// rescore cached and evicted vertices along with their remaining triangles
+		for (size_t i = 0; i < cache_size; ++i) {
+			auto& vertex = vertices[cache[i]];
+			vertex.cache_position = i < kCacheSize ? static_cast<int>(i) : -1;
+			const auto score_delta = ComputeScore(vertex) - vertex.score;
+			vertex.score += score_delta;
+
+			const auto first = vertex_triangles.begin() + vertex.triangles_offset;
+			for_each(first, first + vertex.remaining_triangles, [&](const auto t) { triangle_scores[t] += score_delta; });
+		}
+		cache_size = min<size_t>(cache_size, kCacheSize);
+
+		// only triangles adjacent to the cache are candidates which keeps each step independent of the mesh size
+		best_triangle = numeric_limits<size_t>::max();
+		auto best_score = -1.f;
+		for (size_t i = 0; i < cache_size; ++i) {
+			const auto& vertex = vertices[cache[i]];
+			const auto first = vertex_triangles.begin() + vertex.triangles_offset;
+			for (auto iterator = first; iterator != first + vertex.remaining_triangles; ++iterator) {
+				if (triangle_scores[*iterator] > best_score) {
+					best_score = triangle_scores[*iterator];
+					best_triangle = *iterator;
+				}
+			}
+		}
+	}
+
+	return optimized_indices;
+}
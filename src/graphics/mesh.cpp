@@ -55,6 +55,42 @@ Mesh::Mesh(
 {
 
 	Validate(positions_, texture_coordinates_, normals_, indices_);
+}
+
+Mesh::~Mesh() {
+	Unload();
+}
+
+Mesh::Mesh(Mesh&& mesh) noexcept {
+	*this = move(mesh);
+}
+
+Mesh& Mesh::operator=(Mesh&& mesh) noexcept {
+
+	if (this == &mesh) return *this;
+
+	Unload();
+
+	vertex_array_ = mesh.vertex_array_;
+	vertex_buffer_ = mesh.vertex_buffer_;
+	element_buffer_ = mesh.element_buffer_;
+
+	mesh.vertex_array_ = mesh.vertex_buffer_ = mesh.element_buffer_ = 0u;
+
+	positions_ = move(mesh.positions_);
+	texture_coordinates_ = move(mesh.texture_coordinates_);
+	normals_ = move(mesh.normals_);
+	indices_ = move(mesh.indices_);
+	model_transform_ = move(mesh.model_transform_);
+	bmin_ = mesh.bmin_;
+	bmax_ = mesh.bmax_;
+
+	return *this;
+}
+
+void Mesh::Upload() const noexcept {
+
+	if (vertex_array_) return;
 
 	glGenVertexArrays(1, &vertex_array_);
 	glBindVertexArray(vertex_array_);
@@ -98,35 +134,9 @@ Mesh::Mesh(
 	}
 }
 
-Mesh::~Mesh() {
-	glDeleteVertexArrays(1, &vertex_array_);
-	glDeleteBuffers(1, &vertex_buffer_);
-	glDeleteBuffers(1, &element_buffer_);
-}
-
-Mesh::Mesh(Mesh&& mesh) noexcept {
-	*this = move(mesh);
-}
-
-Mesh& Mesh::operator=(Mesh&& mesh) noexcept {
-
-	if (this == &mesh) return *this;
-
-	glDeleteVertexArrays(1, &vertex_array_);
-	glDeleteBuffers(1, &vertex_buffer_);
-	glDeleteBuffers(1, &element_buffer_);
-
-	vertex_array_ = mesh.vertex_array_;
-	vertex_buffer_ = mesh.vertex_buffer_;
-	element_buffer_ = mesh.element_buffer_;
-
-	mesh.vertex_array_ = mesh.vertex_buffer_ = mesh.element_buffer_ = 0u;
-
-	positions_ = move(mesh.positions_);
-	texture_coordinates_ = move(mesh.texture_coordinates_);
-	normals_ = move(mesh.normals_);
-	indices_ = move(mesh.indices_);
-	model_transform_ = move(mesh.model_transform_);
-
-	return *this;
+void Mesh::Unload() const noexcept {
+	if (vertex_array_) glDeleteVertexArrays(1, &vertex_array_);
+	if (vertex_buffer_) glDeleteBuffers(1, &vertex_buffer_);
+	if (element_buffer_) glDeleteBuffers(1, &element_buffer_);
+	vertex_array_ = vertex_buffer_ = element_buffer_ = 0u;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 #include <glad/glad.h>
@@ -8,6 +9,8 @@
 #include <glm/vec3.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "graphics/mesh_view.h"
+
 namespace gfx {
 
 	enum class DrawMode
@@ -34,6 +37,7 @@ public:
 	 *       is aligned when sent to the vertex shader. If \p indices if nonempty, it must describe a triangle mesh,
 	 *       however, \p positions, \p texture_coordinates, and \p normals may be of any size. Consequentially, each
 	 *       index assumes alignment between \p positions and \p texture_coordinates, \p normals.
+	 * \note No OpenGL calls are made until the mesh is uploaded, so meshes may be constructed on any thread.
 	 */
 	explicit Mesh(
 		std::vector<glm::vec3> positions,
@@ -66,15 +70,41 @@ public:
 	/** \brief Gets the affine transform to apply to the mesh in model space. */
 	[[nodiscard]] const glm::mat4& GetModelTransform() const noexcept { return model_transform_; }
 
+	/** \brief Gets a non-owning view of the mesh data. */
+	[[nodiscard]] operator MeshView() const noexcept {
+		return MeshView{positions_, texture_coordinates_, normals_, indices_, model_transform_};
+	}
+
     /** \brief Gets the min of mesh bounding box. */
     [[nodiscard]] const glm::vec3& GetBoxMin() const noexcept { return bmin_; }
 
     /** \brief Gets the max of mesh bounding box. */
     [[nodiscard]] const glm::vec3& GetBoxMax() const noexcept { return bmax_; }
 
-	/** \brief Renders the mesh to the current render target. */
+	/**
+	 * \brief Creates the vertex array and buffer objects for this mesh if they do not exist yet.
+	 * \note Must be called from the thread that owns the OpenGL context.
+	 */
+	void Upload() const noexcept;
+
+	/**
+	 * \brief Deletes the vertex array and buffer objects of this mesh while keeping its data in memory.
+	 * \details The mesh is uploaded again the next time it is drawn. This does nothing if the mesh was never uploaded.
+	 * \note Must be called from the thread that owns the OpenGL context.
+	 */
+	void Unload() const noexcept;
+
+	/** \brief Gets the number of bytes occupied by the vertex and element buffers once the mesh is uploaded. */
+	[[nodiscard]] std::size_t GetBufferSize() const noexcept
+	{
+		return sizeof(glm::vec3) * positions_.size() + sizeof(glm::vec2) * texture_coordinates_.size()
+			+ sizeof(glm::vec3) * normals_.size() + sizeof(GLuint) * indices_.size();
+	}
+
+	/** \brief Renders the mesh to the current render target, uploading it first if necessary. */
 	void Draw(DrawMode draw_mode) const noexcept
 	{
+		Upload();
 
 		switch (draw_mode)
 		{
@@ -137,9 +167,10 @@ private:
 	glm::vec3 bmax_;
 
 private:
-	GLuint vertex_array_ = 0;
-	GLuint vertex_buffer_ = 0;
-	GLuint element_buffer_ = 0;
+	// created lazily on the render thread, see Upload
+	mutable GLuint vertex_array_ = 0;
+	mutable GLuint vertex_buffer_ = 0;
+	mutable GLuint element_buffer_ = 0;
 
 };
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <span>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace gfx {
+
+/**
+ * \brief A non-owning view of triangle mesh data.
+ * \details Allows mesh processing to read vertex and index data in place (e.g., from a memory-mapped file) without
+ *          copying it into a \c Mesh. The viewed data must outlive the view.
+ */
+struct MeshView {
+
+	/** \brief The mesh vertex positions. */
+	std::span<const glm::vec3> positions;
+
+	/** \brief The mesh texture coordinates. */
+	std::span<const glm::vec2> texture_coordinates;
+
+	/** \brief The mesh normals. */
+	std::span<const glm::vec3> normals;
+
+	/** \brief Element indices such that each three consecutive integers define a triangle face in the mesh. */
+	std::span<const unsigned int> indices;
+
+	/** \brief A 4x4 matrix representing an affine transform to apply to the mesh in model space. */
+	glm::mat4 model_transform{1.f};
+};
+}
@@ -16,6 +16,7 @@
 
 #include <tiny_obj_loader.h>
 
+#include "concurrency/memory_tracker.h"
 #include "graphics/mesh.h"
 
 using namespace gfx;
@@ -239,8 +240,12 @@ namespace gfx
         }
     }
 
-    Mesh obj_loader::LoadMesh(const string_view filepath)
+    Mesh obj_loader::LoadMesh(const string_view filepath, concurrency::MemoryProfiler* const memory_profiler)
     {
+        const auto end_phase = [memory_profiler](const string_view phase) {
+            if (memory_profiler) memory_profiler->EndPhase(phase);
+        };
+
         std::vector<glm::vec3> vertices;
         std::vector<glm::vec2> texture_coordinates;
         std::vector<glm::vec3> normals;
@@ -275,6 +280,7 @@ namespace gfx
         if (!ret) {
             throw runtime_error{ std::string("Failed to load " + std::string(filepath)) };
         }
+        end_phase("parsing");
 
         std::cout << "Num of vertices  = " << (int)(inattrib.vertices.size()) / 3 << std::endl;
         std::cout << "Num of normals   = " << (int)(inattrib.normals.size()) / 3 << std::endl;
@@ -288,6 +294,7 @@ namespace gfx
         if (regen_all_normals) {
             ComputeSmoothingShapes(inattrib, inshapes, outshapes, outattrib);
             ComputeAllSmoothingNormals(outattrib, outshapes);
+            end_phase("smoothing normals");
         }
 
         std::vector<tinyobj::shape_t>& shapes = regen_all_normals ? outshapes : inshapes;
@@ -446,6 +453,9 @@ namespace gfx
             }
         }
 
-        return Mesh{ vertices, texture_coordinates, normals, indices, glm::mat4{1.0}, bmin, bmax };
+        end_phase("triangle soup");
+
+        // move the buffers since copying them would briefly double the memory of the loaded mesh
+        return Mesh{ std::move(vertices), std::move(texture_coordinates), std::move(normals), std::move(indices), glm::mat4{1.0}, bmin, bmax };
     }
 }
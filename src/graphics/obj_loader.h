@@ -2,6 +2,10 @@
 
 #include <string_view>
 
+namespace concurrency {
+class MemoryProfiler;
+}
+
 namespace gfx 
 {
 class Mesh;
@@ -11,9 +15,11 @@ class Mesh;
         /**
          * \brief Loads a triangle mesh from an .obj file.
          * \param filepath The filepath to the .obj file.
+         * \param memory_profiler The profiler the memory of each loading phase is attributed to, null to not profile
+         *                        memory.
          * \return A mesh defined by the position, texture coordinates, normals, and indices specified in the .obj file.
          * \throw std::runtime_error Indicates the file cannot be opened or the file load failed.
          */
-        Mesh LoadMesh(const std::string_view filepath);
+        Mesh LoadMesh(const std::string_view filepath, concurrency::MemoryProfiler* memory_profiler = nullptr);
     }
 }
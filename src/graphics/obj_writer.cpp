@@ -0,0 +1,117 @@
+#include "graphics/obj_writer.h"
+
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "graphics/mesh.h"
+
+using namespace gfx;
+using namespace std;
+
+namespace {
+
+/** \brief Buffers formatted .obj lines and flushes them to a stream in large writes. */
+class ObjStream {
+
+public:
+	explicit ObjStream(ofstream& stream) : stream_{stream} { buffer_.reserve(kBufferSize + kMaxLineSize); }
+	~ObjStream() { Flush(); }
+
+	ObjStream(const ObjStream&) = delete;
+	ObjStream& operator=(const ObjStream&) = delete;
+
+	/**
+	 * \brief Appends an element line (e.g., "v 1 2 3").
+	 * \param prefix The element keyword.
+	 * \param values The element values.
+	 */
+	template <typename T, size_t N>
+	void Write(const string_view prefix, const array<T, N>& values) {
+		buffer_.append(prefix);
+		for (const auto value : values) {
+			array<char, 32> characters{};
+			const auto [end, error] = to_chars(characters.data(), characters.data() + characters.size(), value);
+			buffer_.push_back(' ');
+			buffer_.append(characters.data(), end);
+		}
+		buffer_.push_back('\n');
+		if (buffer_.size() >= kBufferSize) Flush();
+	}
+
+	/** \brief Appends a raw string. */
+	void Write(const string_view text) {
+		buffer_.append(text);
+		if (buffer_.size() >= kBufferSize) Flush();
+	}
+
+	/** \brief Writes all buffered lines to the underlying stream. */
+	void Flush() {
+		stream_.write(buffer_.data(), static_cast<streamsize>(buffer_.size()));
+		buffer_.clear();
+	}
+
+private:
+	static constexpr size_t kBufferSize = 1u << 20;
+	static constexpr size_t kMaxLineSize = 256;
+	ofstream& stream_;
+	string buffer_;
+};
+}
+
+void obj_writer::WriteMesh(const Mesh& mesh, const string_view filepath) {
+
+	ofstream stream{string{filepath}, ios::binary};
+	if (!stream) throw runtime_error{"Unable to open " + string{filepath}};
+
+	const auto& positions = mesh.GetPositions();
+	const auto& texture_coordinates = mesh.GetTexture_coordinates();
+	const auto& normals = mesh.GetNormals();
+	const auto& indices = mesh.GetIndices();
+
+	{
+		ObjStream obj_stream{stream};
+
+		for (const auto& position : positions) {
+			obj_stream.Write("v", array{position.x, position.y, position.z});
+		}
+		// texture coordinates are flipped on load, undo this so the file round-trips
+		for (const auto& texture_coordinate : texture_coordinates) {
+			obj_stream.Write("vt", array{texture_coordinate.x, 1.f - texture_coordinate.y});
+		}
+		for (const auto& normal : normals) {
+			obj_stream.Write("vn", array{normal.x, normal.y, normal.z});
+		}
+
+		const auto has_texture_coordinates = !texture_coordinates.empty();
+		const auto has_normals = !normals.empty();
+		const auto index_count = indices.empty() ? positions.size() : indices.size();
+
+		for (size_t i = 0; i + 2 < index_count; i += 3) {
+			obj_stream.Write("f");
+			for (size_t j = i; j < i + 3; ++j) {
+				// .obj indices are 1-based
+				const auto index = (indices.empty() ? j : indices[j]) + 1;
+				array<char, 24> characters{};
+				const auto end = to_chars(characters.data(), characters.data() + characters.size(), index).ptr;
+				const string_view element{characters.data(), end};
+
+				obj_stream.Write(" ");
+				obj_stream.Write(element);
+				if (has_texture_coordinates || has_normals) {
+					obj_stream.Write("/");
+					if (has_texture_coordinates) obj_stream.Write(element);
+					if (has_normals) {
+						obj_stream.Write("/");
+						obj_stream.Write(element);
+					}
+				}
+			}
+			obj_stream.Write("\n");
+		}
+	}
+
+	if (!stream) throw runtime_error{"Failed to write " + string{filepath}};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+
+namespace gfx
+{
+class Mesh;
+
+    namespace obj_writer
+    {
+        /**
+         * \brief Writes a triangle mesh to an .obj file.
+         * \param mesh The mesh to write. Texture coordinates and normals are written when present.
+         * \param filepath The filepath of the .obj file to create or overwrite.
+         * \throw std::runtime_error Indicates the file cannot be opened or written.
+         * \note The model transform is not applied, vertex positions are written in model space.
+         */
+        void WriteMesh(const Mesh& mesh, std::string_view filepath);
+    }
+}
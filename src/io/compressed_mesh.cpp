@@ -0,0 +1,460 @@
+#include "io/compressed_mesh.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define COMPRESSED_MESH_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "geometry/edgebreaker.h"
+#include "geometry/half_edge_mesh.h"
+#include "geometry/vertex_cache_optimizer.h"
+#include "graphics/mesh.h"
+#include "io/mapped_file.h"
+
+using namespace geometry;
+using namespace gfx;
+using namespace glm;
+using namespace io;
+using namespace std;
+
+static_assert(endian::native == endian::little, "Compressed meshes are stored in little-endian byte order");
+
+namespace {
+
+constexpr array<char, 4> kMagic{'M', 'S', 'H', 'Z'};
+constexpr uint32_t kVersion = 2;
+constexpr uint32_t kHasTextureCoordinates = 1u << 0;
+constexpr uint32_t kHasNormals = 1u << 1;
+constexpr uint32_t kHasEdgebreakerConnectivity = 1u << 2;
+
+/** \brief The largest quantized attribute value (attributes are quantized to 16 bits). */
+constexpr float kQuantizationMax = 65535.f;
+
+/** \brief The largest octahedral normal component magnitude (components are 16-bit signed normalized integers). */
+constexpr float kSnormMax = 32767.f;
+
+/** \brief The compressed mesh header, followed by positions, normals, texture coordinates, and the index stream. */
+struct Header {
+	array<char, 4> magic;
+	uint32_t version;
+	uint32_t flags;
+	uint32_t vertex_count;
+	uint32_t index_count;
+	uint32_t index_stream_size;
+	array<float, 3> position_min;
+	array<float, 3> position_scale;
+	array<float, 2> texture_coordinate_min;
+	array<float, 2> texture_coordinate_scale;
+	array<float, 16> model_transform;
+};
+
+static_assert(is_trivially_copyable_v<Header> && sizeof(Header) % alignof(uint32_t) == 0);
+
+/** \brief Appends the bytes of a trivially copyable array to a byte buffer. */
+template <typename T>
+void Append(vector<byte>& bytes, const span<const T> values) {
+	const auto size = bytes.size();
+	bytes.resize(size + values.size_bytes());
+	memcpy(bytes.data() + size, values.data(), values.size_bytes());
+}
+
+/**
+ * \brief Quantizes a vertex attribute to 16 bits per component over its bounding box.
+ * \param values The attribute values to quantize.
+ * \param min Receives the bounding box min.
+ * \param scale Receives the size of one quantization step per component.
+ * \return The quantized components in attribute order.
+ */
+template <typename Vector, size_t N>
+vector<uint16_t> Quantize(const span<const Vector> values, array<float, N>& min, array<float, N>& scale) {
+	static_assert(sizeof(Vector) == N * sizeof(float));
+	Vector box_min{numeric_limits<float>::max()};
+	Vector box_max{numeric_limits<float>::lowest()};
+	for (const auto& value : values) {
+		box_min = glm::min(box_min, value);
+		box_max = glm::max(box_max, value);
+	}
+
+	const auto step = (box_max - box_min) / kQuantizationMax;
+	vector<uint16_t> quantized_values;
+	quantized_values.reserve(values.size() * N);
+	for (const auto& value : values) {
+		for (length_t i = 0; i < static_cast<length_t>(N); ++i) {
+			const auto quantized_value = step[i] > 0.f ? round((value[i] - box_min[i]) / step[i]) : 0.f;
+			quantized_values.push_back(static_cast<uint16_t>(std::clamp(quantized_value, 0.f, kQuantizationMax)));
+		}
+	}
+
+	for (length_t i = 0; i < static_cast<length_t>(N); ++i) {
+		min[i] = box_min[i];
+		scale[i] = step[i];
+	}
+	return quantized_values;
+}
+
+/** \brief Encodes unit normals as two 16-bit signed normalized components of an octahedral map. */
+vector<int16_t> EncodeOctahedral(const span<const vec3> normals) {
+	vector<int16_t> encoded_normals;
+	encoded_normals.reserve(normals.size() * 2);
+
+	for (const auto& normal : normals) {
+		const auto l1_norm = abs(normal.x) + abs(normal.y) + abs(normal.z);
+		vec2 encoded_normal = l1_norm > 0.f ? vec2{normal} / l1_norm : vec2{0.f};
+
+		// fold the lower hemisphere over the diagonals of the upper hemisphere
+		if (normal.z < 0.f) {
+			encoded_normal = vec2{(1.f - abs(encoded_normal.y)) * (encoded_normal.x >= 0.f ? 1.f : -1.f),
+			                      (1.f - abs(encoded_normal.x)) * (encoded_normal.y >= 0.f ? 1.f : -1.f)};
+		}
+		for (length_t i = 0; i < 2; ++i) {
+			encoded_normals.push_back(static_cast<int16_t>(round(std::clamp(encoded_normal[i], -1.f, 1.f) * kSnormMax)));
+		}
+	}
+	return encoded_normals;
+}
+
+/**
+ * \brief Encodes mesh connectivity with Edgebreaker if possible.
+ * \param positions The mesh vertex positions.
+ * \param indices The mesh element indices.
+ * \return The encoded connectivity, or \c std::nullopt if the mesh is not a closed manifold.
+ */
+optional<mesh::EncodedConnectivity> TryEncodeConnectivity(const span<const vec3> positions,
+                                                          const span<const unsigned int> indices) {
+	try {
+		const MeshView connectivity_view{
+			.positions = positions, .texture_coordinates = {}, .normals = {}, .indices = indices};
+		return mesh::EncodeConnectivity(HalfEdgeMesh{connectivity_view});
+	} catch (const invalid_argument&) {
+		return nullopt;
+	}
+}
+
+/** \brief Appends a value as a little-endian base-128 varint. */
+void AppendVarint(vector<byte>& bytes, uint32_t value) {
+	while (value >= 0x80) {
+		bytes.push_back(static_cast<byte>(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back(static_cast<byte>(value));
+}
+
+/**
+ * \brief Dequantizes 16-bit attribute components.
+ * \param source The quantized components.
+ * \param destination The dequantized components.
+ * \param count The number of components.
+ * \param min The per-component bounding box min repeated to fill 12 floats.
+ * \param scale The per-component quantization step repeated to fill 12 floats.
+ * \note Three and two component attributes both repeat with a period of 12 floats (three SIMD vectors).
+ */
+void Dequantize(const byte* source, float* destination, const size_t count, const array<float, 12>& min,
+                const array<float, 12>& scale) noexcept {
+	size_t i = 0;
+
+#ifdef COMPRESSED_MESH_SSE2
+	__m128 min_vectors[3];
+	__m128 scale_vectors[3];
+	for (size_t j = 0; j < 3; ++j) {
+		min_vectors[j] = _mm_loadu_ps(&min[4 * j]);
+		scale_vectors[j] = _mm_loadu_ps(&scale[4 * j]);
+	}
+
+	// each iteration converts 24 components (two periods), eight per 16-byte load
+	const auto zero = _mm_setzero_si128();
+	for (; i + 24 <= count; i += 24) {
+		for (size_t j = 0; j < 3; ++j) {
+			const auto quantized = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2 * (i + 8 * j)));
+			const auto low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(quantized, zero));
+			const auto high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(quantized, zero));
+			const auto low_period = (2 * j) % 3;
+			const auto high_period = (2 * j + 1) % 3;
+			_mm_storeu_ps(destination + i + 8 * j,
+			              _mm_add_ps(_mm_mul_ps(low, scale_vectors[low_period]), min_vectors[low_period]));
+			_mm_storeu_ps(destination + i + 8 * j + 4,
+			              _mm_add_ps(_mm_mul_ps(high, scale_vectors[high_period]), min_vectors[high_period]));
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		uint16_t quantized;
+		memcpy(&quantized, source + 2 * i, sizeof(quantized));
+		destination[i] = static_cast<float>(quantized) * scale[i % 12] + min[i % 12];
+	}
+}
+
+/**
+ * \brief Decodes a normal from octahedral components.
+ * \note Performs the same operations in the same order as the SIMD decoder so both produce identical results.
+ */
+vec3 DecodeOctahedral(const array<int16_t, 2>& encoded_normal) noexcept {
+	const auto x = static_cast<float>(encoded_normal[0]) * (1.f / kSnormMax);
+	const auto y = static_cast<float>(encoded_normal[1]) * (1.f / kSnormMax);
+	const auto z = 1.f - abs(x) - abs(y);
+	const auto t = std::max(0.f - z, 0.f);
+	const vec3 normal{x - (x < 0.f ? -t : t), y - (y < 0.f ? -t : t), z};
+	return normal / sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+}
+
+/**
+ * \brief Decodes octahedral normals.
+ * \param source The encoded normals as pairs of 16-bit signed normalized components.
+ * \param destination The decoded unit normals.
+ * \param count The number of normals.
+ */
+void DecodeOctahedral(const byte* source, vec3* destination, const size_t count) noexcept {
+	size_t i = 0;
+
+#ifdef COMPRESSED_MESH_SSE2
+	const auto snorm_scale = _mm_set1_ps(1.f / kSnormMax);
+	const auto sign_mask = _mm_set1_ps(-0.f);
+	const auto one = _mm_set1_ps(1.f);
+	const auto zero = _mm_setzero_ps();
+
+	// each iteration decodes four normals, the last 16-byte store spills into the next normal so it must exist
+	for (; i + 4 < count; i += 4) {
+		const auto encoded = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4 * i));
+		const auto low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(encoded, encoded), 16));
+		const auto high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(encoded, encoded), 16));
+		auto x = _mm_mul_ps(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)), snorm_scale);
+		auto y = _mm_mul_ps(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)), snorm_scale);
+		auto z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, x)), _mm_andnot_ps(sign_mask, y));
+
+		// unfold the lower hemisphere by moving x and y toward zero by t (copysign is done with the sign bit)
+		const auto t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+		x = _mm_sub_ps(x, _mm_or_ps(t, _mm_and_ps(x, sign_mask)));
+		y = _mm_sub_ps(y, _mm_or_ps(t, _mm_and_ps(y, sign_mask)));
+
+		const auto length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+		x = _mm_div_ps(x, length);
+		y = _mm_div_ps(y, length);
+		z = _mm_div_ps(z, length);
+
+		auto w = zero;
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		auto* const output = value_ptr(destination[i]);
+		_mm_storeu_ps(output, x);
+		_mm_storeu_ps(output + 3, y);
+		_mm_storeu_ps(output + 6, z);
+		_mm_storeu_ps(output + 9, w);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		array<int16_t, 2> encoded;
+		memcpy(encoded.data(), source + 4 * i, sizeof(encoded));
+		destination[i] = DecodeOctahedral(encoded);
+	}
+}
+
+/** \brief Repeats per-component attribute parameters to fill a 12 float SIMD period. */
+template <size_t N>
+array<float, 12> Repeat(const array<float, N>& values) noexcept {
+	array<float, 12> repeated_values{};
+	for (size_t i = 0; i < repeated_values.size(); ++i) repeated_values[i] = values[i % N];
+	return repeated_values;
+}
+}
+
+vector<byte> io::CompressMesh(const MeshView& mesh) {
+	const auto vertex_count = mesh.positions.size();
+	const auto has_texture_coordinates = !mesh.texture_coordinates.empty();
+	const auto has_normals = !mesh.normals.empty();
+
+	if ((has_texture_coordinates && mesh.texture_coordinates.size() != vertex_count)
+		|| (has_normals && mesh.normals.size() != vertex_count)) {
+		throw invalid_argument{"Vertex attributes must align with position data"};
+	}
+	if (vertex_count > numeric_limits<uint32_t>::max()) throw invalid_argument{"Mesh has too many vertices"};
+
+	vector<unsigned int> indices{mesh.indices.begin(), mesh.indices.end()};
+	if (indices.empty()) {
+		indices.resize(vertex_count);
+		iota(indices.begin(), indices.end(), 0u);
+	}
+
+	// closed manifolds encode their connectivity in about two bits per triangle, other meshes fall back to indices
+	vector<size_t> vertex_order;
+	vector<byte> index_stream;
+	auto connectivity = TryEncodeConnectivity(mesh.positions, indices);
+
+	if (connectivity) {
+		vertex_order = move(connectivity->vertex_order);
+		AppendVarint(index_stream, static_cast<uint32_t>(connectivity->symbols.size()));
+		Append(index_stream, span<const byte>{connectivity->symbols});
+		Append(index_stream, span<const byte>{connectivity->offsets});
+	} else {
+		indices = mesh::OptimizeVertexCache(indices, vertex_count);
+
+		// renumber vertices in order of first use so new vertices have the next unused index and deltas stay small
+		constexpr auto kUnused = numeric_limits<unsigned int>::max();
+		vector<unsigned int> vertex_remap(vertex_count, kUnused);
+		vertex_order.reserve(vertex_count);
+		for (auto& index : indices) {
+			if (vertex_remap[index] == kUnused) {
+				vertex_remap[index] = static_cast<unsigned int>(vertex_order.size());
+				vertex_order.push_back(index);
+			}
+			index = vertex_remap[index];
+		}
+
+		index_stream.reserve(indices.size());
+		unsigned int previous_index = 0;
+		for (const auto index : indices) {
+			const auto delta = static_cast<int32_t>(index - previous_index);
+			AppendVarint(index_stream, static_cast<uint32_t>(delta) << 1 ^ static_cast<uint32_t>(delta >> 31));
+			previous_index = index;
+		}
+	}
+
+	const auto gather = [&vertex_order](const auto values) {
+		vector<remove_cvref_t<decltype(values[0])>> gathered_values;
+		gathered_values.reserve(vertex_order.size());
+		for (const auto index : vertex_order) gathered_values.push_back(values[index]);
+		return gathered_values;
+	};
+
+	Header header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.flags = (has_texture_coordinates ? kHasTextureCoordinates : 0u) | (has_normals ? kHasNormals : 0u)
+		| (connectivity ? kHasEdgebreakerConnectivity : 0u);
+	header.vertex_count = static_cast<uint32_t>(vertex_order.size());
+	header.index_count = static_cast<uint32_t>(indices.size());
+	memcpy(header.model_transform.data(), value_ptr(mesh.model_transform), sizeof(header.model_transform));
+
+	const auto positions = Quantize(span<const vec3>{gather(mesh.positions)}, header.position_min, header.position_scale);
+	vector<int16_t> normals;
+	if (has_normals) normals = EncodeOctahedral(gather(mesh.normals));
+	vector<uint16_t> texture_coordinates;
+	if (has_texture_coordinates) {
+		texture_coordinates = Quantize(span<const vec2>{gather(mesh.texture_coordinates)},
+		                               header.texture_coordinate_min,
+		                               header.texture_coordinate_scale);
+	}
+
+	header.index_stream_size = static_cast<uint32_t>(index_stream.size());
+
+	vector<byte> bytes;
+	bytes.reserve(sizeof(Header) + positions.size() * 2 + normals.size() * 2 + texture_coordinates.size() * 2
+	              + index_stream.size());
+	Append(bytes, span<const Header>{&header, 1});
+	Append(bytes, span<const uint16_t>{positions});
+	Append(bytes, span<const int16_t>{normals});
+	Append(bytes, span<const uint16_t>{texture_coordinates});
+	Append(bytes, span<const byte>{index_stream});
+	return bytes;
+}
+
+Mesh io::DecompressMesh(const span<const byte> bytes) {
+	Header header;
+	if (bytes.size() < sizeof(Header)) throw runtime_error{"Compressed mesh is truncated"};
+	memcpy(&header, bytes.data(), sizeof(Header));
+	if (header.magic != kMagic) throw runtime_error{"Not a compressed mesh"};
+	if (header.version == 0 || header.version > kVersion) throw runtime_error{"Unsupported compressed mesh version"};
+
+	const size_t vertex_count = header.vertex_count;
+	const auto has_normals = (header.flags & kHasNormals) != 0;
+	const auto has_texture_coordinates = (header.flags & kHasTextureCoordinates) != 0;
+	const auto positions_offset = sizeof(Header);
+	const auto normals_offset = positions_offset + vertex_count * 3 * sizeof(uint16_t);
+	const auto texture_coordinates_offset = normals_offset + (has_normals ? vertex_count * 2 * sizeof(int16_t) : 0);
+	const auto index_stream_offset =
+		texture_coordinates_offset + (has_texture_coordinates ? vertex_count * 2 * sizeof(uint16_t) : 0);
+	if (bytes.size() < index_stream_offset + header.index_stream_size || header.index_count % 3 != 0) {
+		throw runtime_error{"Compressed mesh is truncated"};
+	}
+
+	vector<vec3> positions(vertex_count);
+	Dequantize(bytes.data() + positions_offset,
+	           reinterpret_cast<float*>(positions.data()),
+	           vertex_count * 3,
+	           Repeat(header.position_min),
+	           Repeat(header.position_scale));
+
+	vector<vec3> normals(has_normals ? vertex_count : 0);
+	if (has_normals) DecodeOctahedral(bytes.data() + normals_offset, normals.data(), vertex_count);
+
+	vector<vec2> texture_coordinates(has_texture_coordinates ? vertex_count : 0);
+	if (has_texture_coordinates) {
+		Dequantize(bytes.data() + texture_coordinates_offset,
+		           reinterpret_cast<float*>(texture_coordinates.data()),
+		           vertex_count * 2,
+		           Repeat(header.texture_coordinate_min),
+		           Repeat(header.texture_coordinate_scale));
+	}
+
+	const auto index_stream = bytes.subspan(index_stream_offset, header.index_stream_size);
+	const auto* iterator = reinterpret_cast<const uint8_t*>(index_stream.data());
+	const auto* const end = iterator + index_stream.size();
+	const auto read_varint = [&iterator, end] {
+		uint32_t value = 0;
+		for (auto shift = 0;; shift += 7) {
+			if (iterator == end || shift > 28) throw runtime_error{"Compressed mesh index stream is corrupt"};
+			const auto next_byte = *iterator++;
+			value |= static_cast<uint32_t>(next_byte & 0x7F) << shift;
+			if (!(next_byte & 0x80)) return value;
+		}
+	};
+
+	vector<unsigned int> indices;
+	if (header.flags & kHasEdgebreakerConnectivity) {
+		const auto symbols_size = read_varint();
+		const auto symbols_offset = static_cast<size_t>(iterator - reinterpret_cast<const uint8_t*>(index_stream.data()));
+		if (symbols_size > index_stream.size() - symbols_offset) throw runtime_error{"Compressed mesh index stream is corrupt"};
+		indices = mesh::DecodeConnectivity(index_stream.subspan(symbols_offset, symbols_size),
+		                                   index_stream.subspan(symbols_offset + symbols_size),
+		                                   header.index_count / 3,
+		                                   vertex_count);
+	} else {
+		indices.resize(header.index_count);
+		unsigned int previous_index = 0;
+		for (auto& index : indices) {
+			const auto value = read_varint();
+			index = previous_index + (value >> 1 ^ (0u - (value & 1)));
+			if (index >= vertex_count) throw runtime_error{"Compressed mesh index stream is corrupt"};
+			previous_index = index;
+		}
+	}
+
+	const vec3 box_min = make_vec3(header.position_min.data());
+	const vec3 box_max = box_min + make_vec3(header.position_scale.data()) * kQuantizationMax;
+	return Mesh{move(positions),
+	            move(texture_coordinates),
+	            move(normals),
+	            move(indices),
+	            make_mat4(header.model_transform.data()),
+	            box_min,
+	            box_max};
+}
+
+void io::WriteCompressedMesh(const MeshView& mesh, const filesystem::path& filepath) {
+	const auto bytes = CompressMesh(mesh);
+
+	ofstream stream{filepath, ios::binary};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+	stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+	if (!stream.flush()) throw runtime_error{"Failed to write " + filepath.string()};
+}
+
+Mesh io::ReadCompressedMesh(const filesystem::path& filepath) {
+	// decode straight from the page cache rather than copying the file into a buffer first
+	const auto file = MappedFile::Open(filepath);
+	return DecompressMesh(file.bytes());
+}
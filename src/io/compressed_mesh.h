@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace gfx {
+class Mesh;
+struct MeshView;
+}
+
+namespace io {
+
+/**
+ * \brief Compresses a triangle mesh into a compact binary representation.
+ * \details Positions and texture coordinates are quantized to 16 bits per component over their bounding boxes and
+ *          normals are octahedrally encoded into two 16-bit components. The connectivity of closed manifold meshes is
+ *          encoded with Edgebreaker in about two bits per triangle. Otherwise, triangles are reordered for vertex cache
+ *          reuse and vertices are renumbered in order of first use, after which indices are delta, zigzag, and varint
+ *          encoded. Vertices not referenced by any triangle are removed.
+ * \param mesh The mesh to compress. If the mesh has no indices, its positions are treated as a triangle list.
+ * \return The compressed mesh bytes in little-endian byte order.
+ * \throw std::invalid_argument Indicates \p mesh is not a valid triangle mesh.
+ */
+[[nodiscard]] std::vector<std::byte> CompressMesh(const gfx::MeshView& mesh);
+
+/**
+ * \brief Decompresses a mesh compressed by \c CompressMesh.
+ * \details Attributes are dequantized with SIMD instructions where available directly into the vertex arrays that are
+ *          uploaded to the GPU.
+ * \param bytes The compressed mesh bytes.
+ * \return The decompressed indexed triangle mesh.
+ * \throw std::runtime_error Indicates \p bytes is not a valid compressed mesh.
+ */
+[[nodiscard]] gfx::Mesh DecompressMesh(std::span<const std::byte> bytes);
+
+/**
+ * \brief Compresses a triangle mesh to a file.
+ * \param mesh The mesh to compress.
+ * \param filepath The file to write (conventionally with the .mshz extension).
+ * \throw std::invalid_argument Indicates \p mesh is not a valid triangle mesh.
+ * \throw std::runtime_error Indicates the file cannot be written.
+ */
+void WriteCompressedMesh(const gfx::MeshView& mesh, const std::filesystem::path& filepath);
+
+/**
+ * \brief Decompresses a mesh from a file written by \c WriteCompressedMesh.
+ * \param filepath The file to read.
+ * \return The decompressed indexed triangle mesh.
+ * \throw std::runtime_error Indicates the file cannot be read or is not a valid compressed mesh.
+ */
+[[nodiscard]] gfx::Mesh ReadCompressedMesh(const std::filesystem::path& filepath);
+}
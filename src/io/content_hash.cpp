@@ -0,0 +1,76 @@
+#include "io/content_hash.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace io;
+using namespace std;
+
+namespace {
+
+constexpr uint64_t kPrime0 = 0x9E3779B185EBCA87;
+constexpr uint64_t kPrime1 = 0xC2B2AE3D27D4EB4F;
+
+/** \brief Avalanches all bits of a hash state (splitmix64 finalizer). */
+constexpr uint64_t Finalize(uint64_t hash) noexcept {
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+	return hash ^ (hash >> 31);
+}
+
+/** \brief Mixes a 64-bit word into a hash state. */
+constexpr uint64_t Mix(const uint64_t hash, const uint64_t word) noexcept {
+	return rotl(hash ^ (word * kPrime1), 31) * kPrime0;
+}
+}
+
+uint64_t io::HashBytes(const span<const byte> bytes, const uint64_t seed) noexcept {
+	auto hash = Finalize(seed + kPrime0) ^ bytes.size();
+
+	// process 8-byte words, memcpy keeps unaligned loads well defined and compiles to a single load
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, bytes.data() + i, sizeof(word));
+		hash = Mix(hash, word);
+	}
+
+	uint64_t tail = 0;
+	for (auto shift = 0; i < bytes.size(); ++i, shift += 8) {
+		tail |= static_cast<uint64_t>(bytes[i]) << shift;
+	}
+
+	return Finalize(Mix(hash, tail));
+}
+
+uint64_t io::HashMesh(const gfx::MeshView& mesh, const uint64_t seed) noexcept {
+	// each hash seeds the next so moving data between attributes changes the checksum
+	auto hash = HashBytes(as_bytes(mesh.positions), seed);
+	hash = HashBytes(as_bytes(mesh.texture_coordinates), hash);
+	hash = HashBytes(as_bytes(mesh.normals), hash);
+	return HashBytes(as_bytes(mesh.indices), hash);
+}
+
+uint64_t io::HashFile(const filesystem::path& filepath, const uint64_t seed) {
+
+	ifstream stream{filepath, ios::binary};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+
+	// hash fixed-size blocks so memory use does not depend on file size
+	static constexpr size_t kBlockSize = 1u << 22;
+	vector<byte> block(kBlockSize);
+	auto hash = seed;
+
+	while (stream) {
+		stream.read(reinterpret_cast<char*>(block.data()), static_cast<streamsize>(block.size()));
+		const auto size = static_cast<size_t>(stream.gcount());
+		if (size == 0) break;
+		hash = HashBytes(span{block.data(), size}, hash);
+	}
+
+	if (stream.bad()) throw runtime_error{"Failed to read " + filepath.string()};
+	return hash;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "graphics/mesh_view.h"
+
+namespace io {
+
+/**
+ * \brief Computes a 64-bit non-cryptographic hash of a byte sequence.
+ * \param bytes The bytes to hash.
+ * \param seed A value to mix into the hash (e.g., to hash several sequences in succession).
+ * \return A hash value that is identical across runs and processes for identical input.
+ */
+[[nodiscard]] std::uint64_t HashBytes(std::span<const std::byte> bytes, std::uint64_t seed = 0) noexcept;
+
+/**
+ * \brief Computes a checksum of a mesh (e.g., to verify that a simplified mesh is reproduced exactly).
+ * \param mesh The mesh to hash.
+ * \param seed A value to mix into the hash (e.g., to hash several levels of detail in succession).
+ * \return A hash of the positions, texture coordinates, normals, and indices of \p mesh as computed by \c HashBytes.
+ */
+[[nodiscard]] std::uint64_t HashMesh(const gfx::MeshView& mesh, std::uint64_t seed = 0) noexcept;
+
+/**
+ * \brief Computes the content hash of a file.
+ * \param filepath The file to hash.
+ * \param seed A value to mix into the hash (e.g., to hash several files in succession).
+ * \return The hash of the file contents as computed by \c HashBytes.
+ * \throw std::runtime_error Indicates the file cannot be opened or read.
+ */
+[[nodiscard]] std::uint64_t HashFile(const std::filesystem::path& filepath, std::uint64_t seed = 0);
+}
@@ -0,0 +1,108 @@
+#include "io/file_watcher.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace io;
+using namespace std;
+
+namespace {
+
+/** \brief Gets the last write time of a file or the minimum time if the file does not currently exist. */
+filesystem::file_time_type GetLastWriteTime(const filesystem::path& filepath) noexcept {
+	error_code error;
+	const auto last_write_time = filesystem::last_write_time(filepath, error);
+	return error ? filesystem::file_time_type::min() : last_write_time;
+}
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher() : descriptor_{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)} {
+	if (descriptor_ == -1) throw runtime_error{format("Unable to initialize inotify ({})", strerror(errno))};
+}
+
+FileWatcher::~FileWatcher() {
+	close(descriptor_);
+}
+
+filesystem::path FileWatcher::Watch(const filesystem::path& filepath) {
+	auto absolute_filepath = filesystem::absolute(filepath).lexically_normal();
+	const auto directory = absolute_filepath.parent_path();
+
+	// watch the directory rather than the file so replacing the file by a rename is also observed
+	const auto watch_descriptor =
+		inotify_add_watch(descriptor_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (watch_descriptor == -1) {
+		throw runtime_error{format("Unable to watch {} ({})", directory.string(), strerror(errno))};
+	}
+
+	directories_[watch_descriptor] = directory;
+	files_.emplace(absolute_filepath.string(), GetLastWriteTime(absolute_filepath));
+	return absolute_filepath;
+}
+
+vector<filesystem::path> FileWatcher::Poll() {
+	vector<filesystem::path> modified_filepaths;
+
+	alignas(inotify_event) array<char, 1u << 14> buffer;
+	for (;;) {
+		const auto size = read(descriptor_, buffer.data(), buffer.size());
+		if (size <= 0) break;
+
+		for (auto offset = 0; offset < size;) {
+			const auto* const event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+			offset += static_cast<int>(sizeof(inotify_event) + event->len);
+
+			// IN_CREATE alone reports an empty file about to be written, wait for the writer to close it
+			if (event->len == 0 || event->mask & IN_CREATE) continue;
+			const auto directory = directories_.find(event->wd);
+			if (directory == directories_.end()) continue;
+
+			auto filepath = directory->second / event->name;
+			if (files_.contains(filepath.string()) && ranges::find(modified_filepaths, filepath) == modified_filepaths.end()) {
+				modified_filepaths.push_back(move(filepath));
+			}
+		}
+	}
+
+	return modified_filepaths;
+}
+
+#else
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() = default;
+
+filesystem::path FileWatcher::Watch(const filesystem::path& filepath) {
+	auto absolute_filepath = filesystem::absolute(filepath).lexically_normal();
+	files_.emplace(absolute_filepath.string(), GetLastWriteTime(absolute_filepath));
+	return absolute_filepath;
+}
+
+vector<filesystem::path> FileWatcher::Poll() {
+	vector<filesystem::path> modified_filepaths;
+
+	for (auto& [filepath, last_write_time] : files_) {
+		if (const auto write_time = GetLastWriteTime(filepath);
+			write_time != last_write_time && write_time != filesystem::file_time_type::min()) {
+			last_write_time = write_time;
+			modified_filepaths.emplace_back(filepath);
+		}
+	}
+
+	return modified_filepaths;
+}
+
+#endif
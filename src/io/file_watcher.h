@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace io {
+
+/**
+ * \brief Reports files that were modified since they were last polled.
+ * \details On Linux, the directories containing watched files are monitored with inotify so files replaced by a rename
+ *          (as many exporters do) are still reported. On other platforms, file modification times are polled.
+ */
+class FileWatcher {
+
+public:
+	/**
+	 * \brief Initializes a file watcher with no watched files.
+	 * \throw std::runtime_error Indicates the operating system file notification service is unavailable.
+	 */
+	FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+	~FileWatcher();
+
+	/**
+	 * \brief Starts watching a file for modification.
+	 * \param filepath The file to watch.
+	 * \return The absolute, normalized filepath that \c Poll reports when the file is modified.
+	 * \throw std::runtime_error Indicates the directory containing the file cannot be watched.
+	 */
+	std::filesystem::path Watch(const std::filesystem::path& filepath);
+
+	/**
+	 * \brief Gets watched files modified since the last call without blocking.
+	 * \return The absolute, normalized filepaths of modified files, each reported once.
+	 */
+	[[nodiscard]] std::vector<std::filesystem::path> Poll();
+
+private:
+	/** \brief Watched files keyed by absolute, normalized filepath with their last observed write time. */
+	std::unordered_map<std::string, std::filesystem::file_time_type> files_;
+#ifdef __linux__
+	int descriptor_ = -1;
+	std::unordered_map<int, std::filesystem::path> directories_;
+#endif
+};
+}
@@ -0,0 +1,155 @@
+#include "io/lod_archive.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "graphics/mesh.h"
+#include "io/compressed_mesh.h"
+
+using namespace glm;
+using namespace io;
+using namespace std;
+
+namespace {
+
+constexpr array<char, 8> kMagic{'M', 'S', 'L', 'O', 'D', '\0', '\0', '\0'};
+constexpr uint32_t kVersion = 1;
+
+/**
+ * \brief The alignment of each level in the archive.
+ * \details This is the smallest page size of supported platforms, aligning levels to it ensures reading one level never
+ *          faults in the pages of another.
+ */
+constexpr uint64_t kPageSize = 4096;
+
+/** \brief The archive header, followed by a directory of \c LodArchiveLevel entries and the compressed levels. */
+struct Header {
+	array<char, 8> magic;
+	uint32_t version;
+	uint32_t level_count;
+	array<float, 3> box_min;
+	array<float, 3> box_max;
+};
+
+static_assert(is_trivially_copyable_v<Header> && sizeof(Header) % alignof(LodArchiveLevel) == 0);
+static_assert(is_trivially_copyable_v<LodArchiveLevel> && sizeof(LodArchiveLevel) == 32);
+
+constexpr uint64_t AlignUp(const uint64_t value) noexcept {
+	return (value + kPageSize - 1) & ~(kPageSize - 1);
+}
+}
+
+void LodArchiveWriter::Add(const gfx::MeshView& mesh, const float rate, const float error) {
+	auto bytes = CompressMesh(mesh);
+
+	vec3 box_min{numeric_limits<float>::max()};
+	vec3 box_max{numeric_limits<float>::lowest()};
+	for (const auto& position : mesh.positions) {
+		box_min = min(box_min, position);
+		box_max = max(box_max, position);
+	}
+	box_min_ = levels_.empty() ? box_min : min(box_min_, box_min);
+	box_max_ = levels_.empty() ? box_max : max(box_max_, box_max);
+
+	const auto triangle_count = (mesh.indices.empty() ? mesh.positions.size() : mesh.indices.size()) / 3;
+	levels_.push_back(Level{
+		.description = LodArchiveLevel{.rate = rate,
+		                               .error = error,
+		                               .triangle_count = static_cast<uint32_t>(triangle_count),
+		                               .vertex_count = static_cast<uint32_t>(mesh.positions.size()),
+		                               .offset = 0,
+		                               .size = bytes.size()},
+		.bytes = move(bytes)});
+}
+
+void LodArchiveWriter::Write(const filesystem::path& filepath) const {
+	if (levels_.empty()) throw logic_error{"A level of detail archive requires at least one level"};
+
+	vector<const Level*> levels;
+	levels.reserve(levels_.size());
+	for (const auto& level : levels_) levels.push_back(&level);
+	ranges::stable_sort(levels, [](const auto* const lhs, const auto* const rhs) {
+		return lhs->description.triangle_count > rhs->description.triangle_count;
+	});
+
+	Header header{.magic = kMagic,
+	              .version = kVersion,
+	              .level_count = static_cast<uint32_t>(levels.size()),
+	              .box_min = {box_min_.x, box_min_.y, box_min_.z},
+	              .box_max = {box_max_.x, box_max_.y, box_max_.z}};
+
+	vector<LodArchiveLevel> directory;
+	directory.reserve(levels.size());
+	auto offset = AlignUp(sizeof(Header) + levels.size() * sizeof(LodArchiveLevel));
+	for (const auto* const level : levels) {
+		auto& description = directory.emplace_back(level->description);
+		description.offset = offset;
+		offset = AlignUp(offset + description.size);
+	}
+
+	// write next to the destination so the rename below does not cross file systems
+	auto temporary_filepath = filepath;
+	temporary_filepath += ".tmp";
+	{
+		ofstream stream{temporary_filepath, ios::binary};
+		if (!stream) throw runtime_error{"Unable to open " + temporary_filepath.string()};
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		stream.write(reinterpret_cast<const char*>(directory.data()),
+		             static_cast<streamsize>(directory.size() * sizeof(LodArchiveLevel)));
+		for (size_t i = 0; i < levels.size(); ++i) {
+			stream.seekp(static_cast<streamoff>(directory[i].offset));
+			const auto& bytes = levels[i]->bytes;
+			stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+		}
+		if (!stream.flush()) throw runtime_error{"Failed to write " + temporary_filepath.string()};
+	}
+	filesystem::rename(temporary_filepath, filepath);
+}
+
+LodArchive::LodArchive(const filesystem::path& filepath) : file_{MappedFile::Open(filepath)} {
+	const auto bytes = file_.bytes();
+
+	Header header{};
+	if (bytes.size() < sizeof(Header)) throw runtime_error{format("{} is not a level of detail archive", filepath.string())};
+	memcpy(&header, bytes.data(), sizeof(Header));
+
+	if (header.magic != kMagic) throw runtime_error{format("{} is not a level of detail archive", filepath.string())};
+	if (header.version != kVersion) {
+		throw runtime_error{format("{} has unsupported archive version {}", filepath.string(), header.version)};
+	}
+	if (header.level_count == 0 || header.level_count > (bytes.size() - sizeof(Header)) / sizeof(LodArchiveLevel)) {
+		throw runtime_error{format("{} has an invalid directory", filepath.string())};
+	}
+
+	levels_.resize(header.level_count);
+	memcpy(levels_.data(), bytes.data() + sizeof(Header), levels_.size() * sizeof(LodArchiveLevel));
+	for (const auto& level : levels_) {
+		if (level.offset > bytes.size() || level.size > bytes.size() - level.offset) {
+			throw runtime_error{format("{} is truncated", filepath.string())};
+		}
+	}
+
+	box_min_ = make_vec3(header.box_min.data());
+	box_max_ = make_vec3(header.box_max.data());
+}
+
+size_t LodArchive::SelectLevel(const float max_error) const noexcept {
+	for (auto i = levels_.size(); i-- > 1;) {
+		if (levels_[i].error <= max_error) return i;
+	}
+	return 0;
+}
+
+gfx::Mesh LodArchive::LoadLevel(const size_t level) const {
+	const auto& description = levels_.at(level);
+	return DecompressMesh(file_.bytes().subspan(static_cast<size_t>(description.offset), static_cast<size_t>(description.size)));
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "io/mapped_file.h"
+
+namespace gfx {
+class Mesh;
+struct MeshView;
+}
+
+namespace io {
+
+/** \brief The conventional file extension of level of detail archives. */
+constexpr auto kLodArchiveExtension = ".mlod";
+
+/** \brief Describes a level of detail stored in a level of detail archive. */
+struct LodArchiveLevel {
+
+	/** \brief The simplification rate the level was created with, zero for the source mesh. */
+	float rate;
+
+	/** \brief The geometric error of the level in object space (see \c geometry::mesh::SimplifiedMesh::error). */
+	float error;
+
+	/** \brief The number of triangles in the level. */
+	std::uint32_t triangle_count;
+
+	/** \brief The number of vertices in the level. */
+	std::uint32_t vertex_count;
+
+	/** \brief The offset of the compressed level from the start of the archive. */
+	std::uint64_t offset;
+
+	/** \brief The size of the compressed level in bytes. */
+	std::uint64_t size;
+};
+
+/**
+ * \brief Collects the levels of detail of a mesh and writes them to a single archive.
+ * \details Levels are compressed as they are added so the source meshes do not need to be kept in memory.
+ */
+class LodArchiveWriter {
+
+public:
+	/**
+	 * \brief Compresses and adds a level of detail to the archive.
+	 * \param mesh The level of detail.
+	 * \param rate The simplification rate \p mesh was created with.
+	 * \param error The geometric error of \p mesh in object space.
+	 * \throw std::invalid_argument Indicates \p mesh is not a valid triangle mesh.
+	 */
+	void Add(const gfx::MeshView& mesh, float rate, float error);
+
+	/**
+	 * \brief Writes the archive.
+	 * \details Levels are ordered from the most to the least detailed and each level starts on its own page so mapping
+	 *          the archive only reads the directory and the pages of levels that are decompressed. The archive is
+	 *          written to a temporary file that replaces \p filepath once complete, so processes that have mapped a
+	 *          previous version of the archive continue to read consistent data.
+	 * \param filepath The file to write (conventionally with the \c kLodArchiveExtension extension).
+	 * \throw std::logic_error Indicates no levels were added.
+	 * \throw std::runtime_error Indicates the file cannot be written.
+	 */
+	void Write(const std::filesystem::path& filepath) const;
+
+private:
+	struct Level {
+		LodArchiveLevel description;
+		std::vector<std::byte> bytes;
+	};
+
+	std::vector<Level> levels_;
+	glm::vec3 box_min_{0.f};
+	glm::vec3 box_max_{0.f};
+};
+
+/**
+ * \brief A read-only, memory-mapped level of detail archive.
+ * \details Opening an archive only reads its directory. Levels are decompressed on demand from the mapped file, so
+ *          only the pages of levels that are actually rendered are read from disk.
+ */
+class LodArchive {
+
+public:
+	/**
+	 * \brief Maps a level of detail archive.
+	 * \param filepath The archive to map.
+	 * \throw std::runtime_error Indicates the file cannot be mapped or is not a valid archive.
+	 */
+	explicit LodArchive(const std::filesystem::path& filepath);
+
+	/** \brief Gets the archive levels ordered from the most to the least detailed. */
+	[[nodiscard]] std::span<const LodArchiveLevel> levels() const noexcept { return levels_; }
+
+	/** \brief Gets the min of the bounding box enclosing every level in object space. */
+	[[nodiscard]] const glm::vec3& box_min() const noexcept { return box_min_; }
+
+	/** \brief Gets the max of the bounding box enclosing every level in object space. */
+	[[nodiscard]] const glm::vec3& box_max() const noexcept { return box_max_; }
+
+	/**
+	 * \brief Selects the least detailed level whose error does not exceed a tolerance.
+	 * \param max_error The largest acceptable geometric error in object space.
+	 * \return The index of the selected level, or zero if no level is accurate enough.
+	 */
+	[[nodiscard]] std::size_t SelectLevel(float max_error) const noexcept;
+
+	/**
+	 * \brief Decompresses a level of detail. This may be called concurrently from multiple threads.
+	 * \param level The index of the level to decompress.
+	 * \return The decompressed level of detail.
+	 * \throw std::out_of_range Indicates \p level is not a valid level index.
+	 * \throw std::runtime_error Indicates the level is corrupt.
+	 */
+	[[nodiscard]] gfx::Mesh LoadLevel(std::size_t level) const;
+
+private:
+	MappedFile file_;
+	std::vector<LodArchiveLevel> levels_;
+	glm::vec3 box_min_{0.f};
+	glm::vec3 box_max_{0.f};
+};
+}
@@ -0,0 +1,156 @@
+#include "io/mapped_file.h"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace io;
+using namespace std;
+
+namespace {
+
+#ifdef _WIN32
+
+/** \brief Closes a Windows handle when going out of scope. */
+struct ScopedHandle {
+	HANDLE handle;
+	~ScopedHandle() {
+		if (handle && handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+	}
+};
+
+/** \brief Creates an exception describing the last operating system error. */
+runtime_error MakeError(const string_view message, const filesystem::path& filepath) {
+	return runtime_error{format("{} {} (error {})", message, filepath.string(), GetLastError())};
+}
+
+/** \brief Maps a file into memory, \p size is read from the file unless the mapping is writable. */
+byte* Map(const filesystem::path& filepath, size_t& size, const bool writable) {
+	const ScopedHandle file{CreateFileW(filepath.c_str(),
+	                                    writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+	                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+	                                    nullptr,
+	                                    writable ? CREATE_ALWAYS : OPEN_EXISTING,
+	                                    FILE_ATTRIBUTE_NORMAL,
+	                                    nullptr)};
+	if (file.handle == INVALID_HANDLE_VALUE) throw MakeError("Unable to open", filepath);
+
+	if (!writable) {
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file.handle, &file_size)) throw MakeError("Unable to stat", filepath);
+		size = static_cast<size_t>(file_size.QuadPart);
+	}
+	if (size == 0) throw runtime_error{format("Unable to map empty file {}", filepath.string())};
+
+	const ScopedHandle mapping{CreateFileMappingW(file.handle,
+	                                              nullptr,
+	                                              writable ? PAGE_READWRITE : PAGE_READONLY,
+	                                              static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+	                                              static_cast<DWORD>(size & 0xFFFFFFFFu),
+	                                              nullptr)};
+	if (!mapping.handle) throw MakeError("Unable to map", filepath);
+
+	// the view keeps the mapping alive after both handles are closed
+	auto* const data = MapViewOfFile(mapping.handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	if (!data) throw MakeError("Unable to map", filepath);
+	return static_cast<byte*>(data);
+}
+
+/** \brief Unmaps a file mapped by \c Map. */
+void Unmap(byte* const data, size_t) noexcept {
+	UnmapViewOfFile(data);
+}
+
+#else
+
+/** \brief Creates an exception describing the last operating system error. */
+runtime_error MakeError(const string_view message, const filesystem::path& filepath) {
+	return runtime_error{format("{} {} ({})", message, filepath.string(), strerror(errno))};
+}
+
+/** \brief Closes a file descriptor when going out of scope. */
+struct ScopedDescriptor {
+	int descriptor;
+	~ScopedDescriptor() {
+		if (descriptor != -1) close(descriptor);
+	}
+};
+
+/** \brief Maps a file into memory, \p size is read from the file unless the mapping is writable. */
+byte* Map(const filesystem::path& filepath, size_t& size, const bool writable) {
+	const ScopedDescriptor file{writable ? open(filepath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+	                                     : open(filepath.c_str(), O_RDONLY | O_CLOEXEC)};
+	if (file.descriptor == -1) throw MakeError("Unable to open", filepath);
+
+	if (writable) {
+		if (ftruncate(file.descriptor, static_cast<off_t>(size)) == -1) throw MakeError("Unable to resize", filepath);
+	} else {
+		struct stat file_status {};
+		if (fstat(file.descriptor, &file_status) == -1) throw MakeError("Unable to stat", filepath);
+		size = static_cast<size_t>(file_status.st_size);
+	}
+	if (size == 0) throw runtime_error{format("Unable to map empty file {}", filepath.string())};
+
+	// the mapping remains valid after the file descriptor is closed
+	auto* const data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.descriptor, 0);
+	if (data == MAP_FAILED) throw MakeError("Unable to map", filepath);
+	return static_cast<byte*>(data);
+}
+
+/** \brief Unmaps a file mapped by \c Map. */
+void Unmap(byte* const data, const size_t size) noexcept {
+	munmap(data, size);
+}
+
+#endif
+}
+
+MappedFile MappedFile::Open(const filesystem::path& filepath) {
+	size_t size = 0;
+	auto* const data = Map(filepath, size, false);
+	return MappedFile{data, size};
+}
+
+MappedFile MappedFile::Create(const filesystem::path& filepath, size_t size) {
+	auto* const data = Map(filepath, size, true);
+	return MappedFile{data, size};
+}
+
+MappedFile::MappedFile(MappedFile&& mapped_file) noexcept
+	: data_{exchange(mapped_file.data_, nullptr)}, size_{exchange(mapped_file.size_, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& mapped_file) noexcept {
+	if (this != &mapped_file) {
+		if (data_) Unmap(data_, size_);
+		data_ = exchange(mapped_file.data_, nullptr);
+		size_ = exchange(mapped_file.size_, 0);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile() {
+	if (data_) Unmap(data_, size_);
+}
+
+void MappedFile::Flush() const {
+	if (!data_) return;
+#ifdef _WIN32
+	if (!FlushViewOfFile(data_, size_)) throw runtime_error{format("Unable to flush mapped file (error {})", GetLastError())};
+#else
+	if (msync(data_, size_, MS_SYNC) == -1) throw runtime_error{format("Unable to flush mapped file ({})", strerror(errno))};
+#endif
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace io {
+
+/**
+ * \brief A file mapped into the address space of the current process.
+ * \details Mapping a file in shared memory (e.g., /dev/shm on Linux) allows processes to exchange data without
+ *          serialization since each process reads and writes the same physical pages.
+ */
+class MappedFile {
+
+public:
+	/**
+	 * \brief Maps an existing file for reading.
+	 * \param filepath The file to map.
+	 * \return A read-only mapping of the entire file.
+	 * \throw std::runtime_error Indicates the file cannot be opened or mapped.
+	 */
+	[[nodiscard]] static MappedFile Open(const std::filesystem::path& filepath);
+
+	/**
+	 * \brief Creates (or truncates) a file of a given size and maps it for writing.
+	 * \param filepath The file to create.
+	 * \param size The size of the file in bytes.
+	 * \return A writable mapping of the entire file.
+	 * \throw std::runtime_error Indicates the file cannot be created, resized, or mapped.
+	 */
+	[[nodiscard]] static MappedFile Create(const std::filesystem::path& filepath, std::size_t size);
+
+	/** \brief Creates an empty mapping. */
+	MappedFile() noexcept = default;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& mapped_file) noexcept;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& mapped_file) noexcept;
+	~MappedFile();
+
+	/** \brief Gets the mapped file contents. */
+	[[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+	/** \brief Gets the mapped file contents for writing. Only valid for mappings returned by \c Create. */
+	[[nodiscard]] std::span<std::byte> mutable_bytes() const noexcept { return {data_, size_}; }
+
+	/**
+	 * \brief Writes modified pages back to the underlying file.
+	 * \throw std::runtime_error Indicates the pages could not be written.
+	 */
+	void Flush() const;
+
+private:
+	MappedFile(std::byte* data, std::size_t size) noexcept : data_{data}, size_{size} {}
+
+	std::byte* data_ = nullptr;
+	std::size_t size_ = 0;
+};
+}
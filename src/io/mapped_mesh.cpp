@@ -0,0 +1,145 @@
+#include "io/mapped_mesh.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace glm;
+using namespace io;
+using namespace std;
+
+namespace {
+
+constexpr array<char, 8> kMagic{'M', 'S', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr uint32_t kVersion = 1;
+
+/** \brief The alignment of each array in the container, chosen so arrays never share a cache line. */
+constexpr uint64_t kAlignment = 64;
+
+/** \brief The container header as it appears at the start of the file. */
+struct Header {
+	array<char, 8> magic;
+	uint32_t version;
+	uint32_t alignment;
+	uint64_t file_size;
+	uint64_t position_count;
+	uint64_t texture_coordinate_count;
+	uint64_t normal_count;
+	uint64_t index_count;
+	uint64_t positions_offset;
+	uint64_t texture_coordinates_offset;
+	uint64_t normals_offset;
+	uint64_t indices_offset;
+	array<float, 16> model_transform;
+};
+
+static_assert(is_trivially_copyable_v<Header>);
+static_assert(sizeof(vec3) == 3 * sizeof(float) && sizeof(vec2) == 2 * sizeof(float));
+
+constexpr uint64_t AlignUp(const uint64_t value) noexcept {
+	return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+/** \brief Computes the array offsets and file size of a container holding the counts in \p header. */
+void ComputeLayout(Header& header) noexcept {
+	header.positions_offset = AlignUp(sizeof(Header));
+	header.texture_coordinates_offset = AlignUp(header.positions_offset + header.position_count * sizeof(vec3));
+	header.normals_offset = AlignUp(header.texture_coordinates_offset + header.texture_coordinate_count * sizeof(vec2));
+	header.indices_offset = AlignUp(header.normals_offset + header.normal_count * sizeof(vec3));
+	header.file_size = header.indices_offset + header.index_count * sizeof(unsigned int);
+}
+
+/** \brief Gets a typed view of a container array after checking it lies within the mapped bytes. */
+template <typename T>
+span<T> GetArray(const span<byte> bytes, const uint64_t offset, const uint64_t count) {
+	if (offset % kAlignment != 0 || offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T)) {
+		throw runtime_error{"Mesh container array is out of bounds"};
+	}
+	return {reinterpret_cast<T*>(bytes.data() + offset), static_cast<size_t>(count)};
+}
+}
+
+MappedMesh::MappedMesh(const filesystem::path& filepath) : file_{MappedFile::Open(filepath)} {
+	const auto bytes = file_.mutable_bytes();
+
+	Header header{};
+	if (bytes.size() < sizeof(Header)) throw runtime_error{format("{} is not a mesh container", filepath.string())};
+	memcpy(&header, bytes.data(), sizeof(Header));
+
+	if (header.magic != kMagic) {
+		throw runtime_error{format("{} is not a complete mesh container", filepath.string())};
+	}
+	if (header.version != kVersion || header.alignment != kAlignment) {
+		throw runtime_error{format("{} has unsupported mesh container version {}", filepath.string(), header.version)};
+	}
+	if (header.file_size > bytes.size()) throw runtime_error{format("{} is truncated", filepath.string())};
+	if ((header.texture_coordinate_count != 0 && header.texture_coordinate_count != header.position_count)
+		|| (header.normal_count != 0 && header.normal_count != header.position_count) || header.index_count % 3 != 0) {
+		throw runtime_error{format("{} has inconsistent attribute counts", filepath.string())};
+	}
+
+	view_.positions = GetArray<const vec3>(bytes, header.positions_offset, header.position_count);
+	view_.texture_coordinates = GetArray<const vec2>(bytes, header.texture_coordinates_offset, header.texture_coordinate_count);
+	view_.normals = GetArray<const vec3>(bytes, header.normals_offset, header.normal_count);
+	view_.indices = GetArray<const unsigned int>(bytes, header.indices_offset, header.index_count);
+	view_.model_transform = make_mat4(header.model_transform.data());
+}
+
+MappedMeshWriter::MappedMeshWriter(const filesystem::path& filepath,
+                                   const size_t position_count,
+                                   const size_t texture_coordinate_count,
+                                   const size_t normal_count,
+                                   const size_t index_count) {
+
+	if ((texture_coordinate_count != 0 && texture_coordinate_count != position_count)
+		|| (normal_count != 0 && normal_count != position_count) || index_count % 3 != 0) {
+		throw invalid_argument{"Mesh container attribute counts are inconsistent"};
+	}
+
+	Header header{};
+	header.version = kVersion;
+	header.alignment = kAlignment;
+	header.position_count = position_count;
+	header.texture_coordinate_count = texture_coordinate_count;
+	header.normal_count = normal_count;
+	header.index_count = index_count;
+	ComputeLayout(header);
+
+	// the magic is left zeroed until Commit so readers reject a partially written container
+	file_ = MappedFile::Create(filepath, static_cast<size_t>(header.file_size));
+	const auto bytes = file_.mutable_bytes();
+	memcpy(bytes.data(), &header, sizeof(Header));
+
+	positions_ = GetArray<vec3>(bytes, header.positions_offset, header.position_count);
+	texture_coordinates_ = GetArray<vec2>(bytes, header.texture_coordinates_offset, header.texture_coordinate_count);
+	normals_ = GetArray<vec3>(bytes, header.normals_offset, header.normal_count);
+	indices_ = GetArray<unsigned int>(bytes, header.indices_offset, header.index_count);
+}
+
+void MappedMeshWriter::Commit(const mat4& model_transform) noexcept {
+	auto* const header = file_.mutable_bytes().data();
+	memcpy(header + offsetof(Header, model_transform), value_ptr(model_transform), sizeof(Header::model_transform));
+
+	// publish the arrays before the magic for readers that map the container while it is being written
+	atomic_thread_fence(memory_order_release);
+	memcpy(header + offsetof(Header, magic), kMagic.data(), kMagic.size());
+}
+
+void io::WriteMappedMesh(const gfx::MeshView& mesh, const filesystem::path& filepath) {
+	MappedMeshWriter writer{filepath,
+	                        mesh.positions.size(),
+	                        mesh.texture_coordinates.size(),
+	                        mesh.normals.size(),
+	                        mesh.indices.size()};
+	ranges::copy(mesh.positions, writer.positions().begin());
+	ranges::copy(mesh.texture_coordinates, writer.texture_coordinates().begin());
+	ranges::copy(mesh.normals, writer.normals().begin());
+	ranges::copy(mesh.indices, writer.indices().begin());
+	writer.Commit(mesh.model_transform);
+}
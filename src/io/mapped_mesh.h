@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "graphics/mesh_view.h"
+#include "io/mapped_file.h"
+
+namespace io {
+
+/**
+ * \brief A read-only triangle mesh backed by a memory-mapped mesh container.
+ * \details A mesh container is a fixed-size header followed by position, texture coordinate, normal, and index
+ *          arrays in native byte order, each aligned to a cache line. Because the arrays match the in-memory layout
+ *          of \c gfx::Mesh, they can be passed to the simplifier or uploaded to the GPU directly from the mapping.
+ *          Writing containers to shared memory (e.g., /dev/shm/<name>.mmesh on Linux) allows processes to exchange
+ *          meshes without serialization.
+ */
+class MappedMesh {
+
+public:
+	/**
+	 * \brief Maps a mesh container.
+	 * \param filepath The container file to map.
+	 * \throw std::runtime_error Indicates the file cannot be mapped or is not a complete mesh container.
+	 */
+	explicit MappedMesh(const std::filesystem::path& filepath);
+
+	/** \brief Gets the mesh vertex positions. */
+	[[nodiscard]] std::span<const glm::vec3> positions() const noexcept { return view_.positions; }
+
+	/** \brief Gets the mesh texture coordinates. */
+	[[nodiscard]] std::span<const glm::vec2> texture_coordinates() const noexcept { return view_.texture_coordinates; }
+
+	/** \brief Gets the mesh normals. */
+	[[nodiscard]] std::span<const glm::vec3> normals() const noexcept { return view_.normals; }
+
+	/** \brief Gets the mesh element indices. */
+	[[nodiscard]] std::span<const unsigned int> indices() const noexcept { return view_.indices; }
+
+	/** \brief Gets a view of the mapped mesh data which remains valid for the lifetime of this object. */
+	[[nodiscard]] const gfx::MeshView& view() const noexcept { return view_; }
+
+private:
+	MappedFile file_;
+	gfx::MeshView view_;
+};
+
+/**
+ * \brief Creates a mesh container whose arrays are filled in place.
+ * \details The container is not readable by \c MappedMesh until \c Commit is called which allows a producer to
+ *          write a mesh directly into shared memory without staging it in an intermediate buffer.
+ */
+class MappedMeshWriter {
+
+public:
+	/**
+	 * \brief Creates (or truncates) a mesh container sized for a mesh.
+	 * \param filepath The container file to create.
+	 * \param position_count The number of vertex positions.
+	 * \param texture_coordinate_count The number of texture coordinates (either zero or \p position_count).
+	 * \param normal_count The number of normals (either zero or \p position_count).
+	 * \param index_count The number of element indices.
+	 * \throw std::invalid_argument Indicates the attribute counts are inconsistent.
+	 * \throw std::runtime_error Indicates the file cannot be created or mapped.
+	 */
+	MappedMeshWriter(const std::filesystem::path& filepath,
+	                 std::size_t position_count,
+	                 std::size_t texture_coordinate_count,
+	                 std::size_t normal_count,
+	                 std::size_t index_count);
+
+	/** \brief Gets the vertex positions to write. */
+	[[nodiscard]] std::span<glm::vec3> positions() const noexcept { return positions_; }
+
+	/** \brief Gets the texture coordinates to write. */
+	[[nodiscard]] std::span<glm::vec2> texture_coordinates() const noexcept { return texture_coordinates_; }
+
+	/** \brief Gets the normals to write. */
+	[[nodiscard]] std::span<glm::vec3> normals() const noexcept { return normals_; }
+
+	/** \brief Gets the element indices to write. */
+	[[nodiscard]] std::span<unsigned int> indices() const noexcept { return indices_; }
+
+	/**
+	 * \brief Marks the container as complete.
+	 * \param model_transform The affine transform to apply to the mesh in model space.
+	 */
+	void Commit(const glm::mat4& model_transform = glm::mat4{1.f}) noexcept;
+
+private:
+	MappedFile file_;
+	std::span<glm::vec3> positions_;
+	std::span<glm::vec2> texture_coordinates_;
+	std::span<glm::vec3> normals_;
+	std::span<unsigned int> indices_;
+};
+
+/**
+ * \brief Writes a mesh to a mesh container.
+ * \param mesh The mesh to write.
+ * \param filepath The container file to create (or truncate).
+ * \throw std::invalid_argument Indicates the mesh attribute counts are inconsistent.
+ * \throw std::runtime_error Indicates the file cannot be created or mapped.
+ */
+void WriteMappedMesh(const gfx::MeshView& mesh, const std::filesystem::path& filepath);
+}
@@ -0,0 +1,155 @@
+#include "io/simplification_checkpoint.h"
+
+#include <array>
+#include <format>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "io/content_hash.h"
+
+using namespace glm;
+using namespace io;
+using namespace std;
+
+namespace {
+
+constexpr array<char, 8> kMagic{'M', 'S', 'C', 'K', 'P', 'T', '\0', '\0'};
+constexpr uint32_t kVersion = 2;
+
+/** \brief The checkpoint header, followed by the checkpoint arrays in the order visited by \c ForEachArray. */
+struct Header {
+	array<char, 8> magic;
+	uint32_t version;
+	float max_cost;
+	uint64_t fingerprint;
+	uint64_t next_vertex_id;
+	uint64_t initial_face_count;
+	uint64_t vertex_count;
+	uint64_t face_count;
+	uint64_t edge_contraction_count;
+	uint64_t payload_hash;
+};
+
+static_assert(is_trivially_copyable_v<Header> && sizeof(Header) == 72);
+static_assert(is_trivially_copyable_v<CheckpointEdgeContraction> && sizeof(CheckpointEdgeContraction) == 48);
+static_assert(sizeof(vec3) == 3 * sizeof(float) && sizeof(mat4) == 16 * sizeof(float));
+
+/** \brief The number of bytes each vertex, face, and edge contraction occupies in a checkpoint. */
+constexpr uint64_t kVertexSize = sizeof(uint64_t) + sizeof(vec3) + sizeof(mat4);
+constexpr uint64_t kFaceSize = 3 * sizeof(unsigned int) + 5 * sizeof(float);
+constexpr uint64_t kEdgeContractionSize = sizeof(CheckpointEdgeContraction);
+
+/** \brief Invokes a function with each array of a checkpoint in the order they are stored. */
+template <typename Checkpoint, typename Function>
+void ForEachArray(Checkpoint& checkpoint, Function function) {
+	function(checkpoint.vertex_ids);
+	function(checkpoint.positions);
+	function(checkpoint.quadrics);
+	function(checkpoint.indices);
+	function(checkpoint.face_geometry.normal_x);
+	function(checkpoint.face_geometry.normal_y);
+	function(checkpoint.face_geometry.normal_z);
+	function(checkpoint.face_geometry.areas);
+	function(checkpoint.face_geometry.plane_offsets);
+	function(checkpoint.edge_contractions);
+}
+
+/** \brief Computes the hash of every checkpoint array to detect checkpoints corrupted after they were written. */
+uint64_t HashPayload(const SimplificationCheckpoint& checkpoint) noexcept {
+	uint64_t hash = 0;
+	ForEachArray(checkpoint, [&](const auto& values) { hash = HashBytes(as_bytes(span{values}), hash); });
+	return hash;
+}
+}
+
+void io::WriteSimplificationCheckpoint(const SimplificationCheckpoint& checkpoint, const filesystem::path& filepath) {
+
+	const auto vertex_count = checkpoint.vertex_ids.size();
+	const auto face_count = checkpoint.face_geometry.size();
+	if (checkpoint.positions.size() != vertex_count || checkpoint.quadrics.size() != vertex_count
+		|| checkpoint.indices.size() != 3 * face_count || checkpoint.face_geometry.normal_x.size() != face_count
+		|| checkpoint.face_geometry.normal_y.size() != face_count || checkpoint.face_geometry.normal_z.size() != face_count
+		|| checkpoint.face_geometry.plane_offsets.size() != face_count) {
+		throw invalid_argument{"Simplification checkpoint array sizes are inconsistent"};
+	}
+
+	const Header header{.magic = kMagic,
+	                    .version = kVersion,
+	                    .max_cost = checkpoint.max_cost,
+	                    .fingerprint = checkpoint.fingerprint,
+	                    .next_vertex_id = checkpoint.next_vertex_id,
+	                    .initial_face_count = checkpoint.initial_face_count,
+	                    .vertex_count = vertex_count,
+	                    .face_count = face_count,
+	                    .edge_contraction_count = checkpoint.edge_contractions.size(),
+	                    .payload_hash = HashPayload(checkpoint)};
+
+	// write next to the destination so the rename below does not cross file systems
+	auto temporary_filepath = filepath;
+	temporary_filepath += ".tmp";
+	{
+		ofstream stream{temporary_filepath, ios::binary};
+		if (!stream) throw runtime_error{"Unable to open " + temporary_filepath.string()};
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		ForEachArray(checkpoint, [&](const auto& values) {
+			const auto bytes = as_bytes(span{values});
+			stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+		});
+		if (!stream.flush()) throw runtime_error{"Failed to write " + temporary_filepath.string()};
+	}
+	filesystem::rename(temporary_filepath, filepath);
+}
+
+SimplificationCheckpoint io::ReadSimplificationCheckpoint(const filesystem::path& filepath) {
+
+	ifstream stream{filepath, ios::binary};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+	const auto file_size = filesystem::file_size(filepath);
+
+	Header header{};
+	if (!stream.read(reinterpret_cast<char*>(&header), sizeof(Header)) || header.magic != kMagic) {
+		throw runtime_error{format("{} is not a simplification checkpoint", filepath.string())};
+	}
+	if (header.version != kVersion) {
+		throw runtime_error{format("{} has unsupported checkpoint version {}", filepath.string(), header.version)};
+	}
+
+	// validate counts against the file size before allocating so a corrupt header cannot request unbounded memory
+	if (header.vertex_count > file_size || header.face_count > file_size || header.edge_contraction_count > file_size
+		|| sizeof(Header) + header.vertex_count * kVertexSize + header.face_count * kFaceSize
+			   + header.edge_contraction_count * kEdgeContractionSize != file_size) {
+		throw runtime_error{format("{} is truncated", filepath.string())};
+	}
+
+	SimplificationCheckpoint checkpoint;
+	checkpoint.fingerprint = header.fingerprint;
+	checkpoint.next_vertex_id = header.next_vertex_id;
+	checkpoint.initial_face_count = header.initial_face_count;
+	checkpoint.max_cost = header.max_cost;
+	const auto vertex_count = static_cast<size_t>(header.vertex_count);
+	const auto face_count = static_cast<size_t>(header.face_count);
+	checkpoint.vertex_ids.resize(vertex_count);
+	checkpoint.positions.resize(vertex_count);
+	checkpoint.quadrics.resize(vertex_count);
+	checkpoint.indices.resize(3 * face_count);
+	for (auto* const values : {&checkpoint.face_geometry.normal_x,
+	                           &checkpoint.face_geometry.normal_y,
+	                           &checkpoint.face_geometry.normal_z,
+	                           &checkpoint.face_geometry.areas,
+	                           &checkpoint.face_geometry.plane_offsets}) {
+		values->resize(face_count);
+	}
+	checkpoint.edge_contractions.resize(static_cast<size_t>(header.edge_contraction_count));
+
+	ForEachArray(checkpoint, [&](auto& values) {
+		const auto bytes = as_writable_bytes(span{values});
+		stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+	});
+	if (!stream) throw runtime_error{format("Failed to read {}", filepath.string())};
+	if (HashPayload(checkpoint) != header.payload_hash) throw runtime_error{format("{} is corrupt", filepath.string())};
+
+	return checkpoint;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "geometry/face_geometry.h"
+
+namespace io {
+
+/** \brief An edge contraction candidate pending in a simplification checkpoint. */
+struct CheckpointEdgeContraction {
+
+	/** \brief The IDs of the source and target vertices of the half-edge to collapse. */
+	std::uint64_t source_id, target_id;
+
+	/** \brief The order the candidate was queued in, which orders candidates of equal priority in approximate queues. */
+	std::uint64_t sequence;
+
+	/** \brief The position of the vertex the edge collapses onto. */
+	glm::vec3 position;
+
+	/** \brief The cost of collapsing the edge. */
+	float cost;
+
+	/** \brief Nonzero if the candidate is in the priority queue rather than waiting for its neighborhood to change. */
+	std::uint32_t queued;
+
+	/** \brief Nonzero if the cost is a lower bound of the cost of collapsing the edge and the position is not computed. */
+	std::uint32_t lower_bound;
+};
+
+/**
+ * \brief The state of a partially completed mesh simplification.
+ * \details Holds the remaining mesh as raw arrays, the quadric of every remaining vertex, every valid edge contraction
+ *          candidate, and the counters needed to continue simplifying exactly where the checkpoint was taken.
+ */
+struct SimplificationCheckpoint {
+
+	/** \brief Identifies the source mesh, rate, and options so a checkpoint is never resumed with different inputs. */
+	std::uint64_t fingerprint = 0;
+
+	/** \brief The ID assigned to the next vertex created by an edge collapse. */
+	std::uint64_t next_vertex_id = 0;
+
+	/** \brief The number of triangles in the source mesh. */
+	std::uint64_t initial_face_count = 0;
+
+	/** \brief The largest cost of any edge contraction collapsed so far. */
+	float max_cost = 0.f;
+
+	/** \brief The ID of each remaining vertex. */
+	std::vector<std::uint64_t> vertex_ids;
+
+	/** \brief The position of each remaining vertex. */
+	std::vector<glm::vec3> positions;
+
+	/** \brief The error quadric of each remaining vertex. */
+	std::vector<glm::mat4> quadrics;
+
+	/** \brief Indices into the vertex arrays such that each three consecutive integers define a remaining triangle. */
+	std::vector<unsigned int> indices;
+
+	/** \brief The geometry of each remaining triangle, kept so faces are restored with bit-identical normals. */
+	geometry::FaceGeometry face_geometry;
+
+	/** \brief The valid edge contraction candidates. */
+	std::vector<CheckpointEdgeContraction> edge_contractions;
+};
+
+/**
+ * \brief Writes a simplification checkpoint.
+ * \details Each array is written with a single sequential write. The checkpoint is written to a temporary file that
+ *          replaces \p filepath once complete, so a process interrupted while writing leaves the previous checkpoint.
+ * \param checkpoint The checkpoint to write.
+ * \param filepath The file to write.
+ * \throw std::invalid_argument Indicates the array sizes of \p checkpoint are inconsistent.
+ * \throw std::runtime_error Indicates the file cannot be written.
+ */
+void WriteSimplificationCheckpoint(const SimplificationCheckpoint& checkpoint, const std::filesystem::path& filepath);
+
+/**
+ * \brief Reads a simplification checkpoint written by \c WriteSimplificationCheckpoint.
+ * \param filepath The file to read.
+ * \return The simplification checkpoint.
+ * \throw std::runtime_error Indicates the file cannot be read, is not a simplification checkpoint, or is corrupt.
+ */
+[[nodiscard]] SimplificationCheckpoint ReadSimplificationCheckpoint(const std::filesystem::path& filepath);
+}
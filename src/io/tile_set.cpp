@@ -0,0 +1,70 @@
+#include "io/tile_set.h"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+#include "geometry/mesh_tiler.h"
+
+using namespace geometry;
+using namespace glm;
+using namespace io;
+using namespace std;
+
+void io::WriteTileSet(const span<const TileSetLevel> levels,
+                      const unsigned int tiles_per_axis,
+                      const filesystem::path& directory) {
+
+	if (levels.empty()) throw invalid_argument{"A tile set requires at least one level of detail"};
+
+	// split every level over the same grid so tile boundaries line up across levels
+	vec3 box_min{numeric_limits<float>::max()};
+	vec3 box_max{numeric_limits<float>::lowest()};
+	for (const auto& level : levels) {
+		for (const auto& position : level.mesh.positions) {
+			box_min = min(box_min, position);
+			box_max = max(box_max, position);
+		}
+	}
+
+	map<tuple<unsigned int, unsigned int, unsigned int>, LodArchiveWriter> archive_writers;
+	for (const auto& [mesh, rate, error] : levels) {
+		for (const auto& [coordinates, tile_mesh] : mesh::SplitIntoTiles(mesh, box_min, box_max, tiles_per_axis)) {
+			archive_writers[{coordinates.x, coordinates.y, coordinates.z}].Add(tile_mesh, rate, error);
+		}
+	}
+
+	auto temporary_directory = directory;
+	temporary_directory += ".tmp";
+	filesystem::remove_all(temporary_directory);
+	filesystem::create_directories(temporary_directory);
+
+	for (const auto& [coordinates, archive_writer] : archive_writers) {
+		const auto& [x, y, z] = coordinates;
+		archive_writer.Write(temporary_directory / format("tile_{}_{}_{}{}", x, y, z, kLodArchiveExtension));
+	}
+
+	filesystem::remove_all(directory);
+	filesystem::rename(temporary_directory, directory);
+}
+
+vector<shared_ptr<const LodArchive>> io::OpenTileSet(const filesystem::path& directory) {
+	vector<filesystem::path> filepaths;
+	for (const auto& entry : filesystem::directory_iterator{directory}) {
+		if (entry.is_regular_file() && entry.path().extension() == kLodArchiveExtension) filepaths.push_back(entry.path());
+	}
+	if (filepaths.empty()) throw runtime_error{format("{} does not contain any tiles", directory.string())};
+	ranges::sort(filepaths);
+
+	vector<shared_ptr<const LodArchive>> lod_archives;
+	lod_archives.reserve(filepaths.size());
+	for (const auto& filepath : filepaths) {
+		lod_archives.push_back(make_shared<const LodArchive>(filepath));
+	}
+	return lod_archives;
+}
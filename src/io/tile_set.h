@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "graphics/mesh_view.h"
+#include "io/lod_archive.h"
+
+namespace io {
+
+/** \brief The conventional extension of tile set directories. */
+constexpr auto kTileSetExtension = ".mtiles";
+
+/** \brief A level of detail of a mesh that is split into tiles. */
+struct TileSetLevel {
+
+	/** \brief The level of detail. */
+	gfx::MeshView mesh;
+
+	/** \brief The simplification rate \c mesh was created with. */
+	float rate;
+
+	/** \brief The geometric error of \c mesh in object space. */
+	float error;
+};
+
+/**
+ * \brief Splits the levels of detail of a mesh into spatial tiles and writes a level of detail archive per tile.
+ * \details Every level is split over the same uniform grid (see \c geometry::mesh::SplitIntoTiles) so each tile has
+ *          its own level of detail chain and can be loaded independently of the others. The tile set is written to a
+ *          temporary directory that replaces \p directory once complete.
+ * \param levels The levels of detail of the mesh.
+ * \param tiles_per_axis The number of tiles along each axis of the mesh bounding box.
+ * \param directory The directory to write (conventionally with the \c kTileSetExtension extension).
+ * \throw std::invalid_argument Indicates \p levels is empty, \p tiles_per_axis is zero, or a level is not a valid
+ *        triangle mesh.
+ * \throw std::runtime_error Indicates the tile set cannot be written.
+ */
+void WriteTileSet(std::span<const TileSetLevel> levels, unsigned int tiles_per_axis, const std::filesystem::path& directory);
+
+/**
+ * \brief Maps the tile archives of a tile set written by \c WriteTileSet.
+ * \details Only the directory of each archive is read, tile levels are decompressed on demand.
+ * \param directory The tile set directory.
+ * \return The tile archives in a stable order.
+ * \throw std::runtime_error Indicates the directory contains no tiles or a tile is not a valid archive.
+ */
+[[nodiscard]] std::vector<std::shared_ptr<const LodArchive>> OpenTileSet(const std::filesystem::path& directory);
+}
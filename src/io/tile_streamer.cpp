@@ -0,0 +1,226 @@
+#include "io/tile_streamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "io/lod_archive.h"
+
+using namespace concurrency;
+using namespace glm;
+using namespace io;
+using namespace std;
+
+namespace {
+
+/** \brief The maximum number of levels loaded concurrently, which bounds how far loads lag behind the viewpoint. */
+constexpr size_t kMaxPendingLoads = 4;
+
+/** \brief Gets a key that identifies a level of detail of a tile. */
+constexpr uint64_t GetKey(const size_t tile_index, const size_t level) noexcept {
+	return static_cast<uint64_t>(tile_index) << 32 | static_cast<uint64_t>(level);
+}
+
+/** \brief Computes the distance from a point to an axis-aligned bounding box, zero if the point is inside the box. */
+float GetDistance(const vec3& point, const vec3& box_min, const vec3& box_max) noexcept {
+	return length(max(max(box_min - point, point - box_max), vec3{0.f}));
+}
+
+/** \brief Selects the least detailed level of a tile whose error does not exceed a tolerance, or the first level. */
+size_t SelectLevel(const TileStreamer::Tile& tile, const float max_error) noexcept {
+	for (auto i = tile.levels.size(); i-- > 1;) {
+		if (tile.levels[i].error <= max_error) return i;
+	}
+	return 0;
+}
+}
+
+TileStreamer::TileStreamer(vector<Tile> tiles,
+                           Loader loader,
+                           const size_t cpu_budget,
+                           const size_t gpu_budget,
+                           ThreadPool& thread_pool)
+	: tiles_{move(tiles)},
+	  loader_{make_shared<const Loader>(move(loader))},
+	  cpu_budget_{cpu_budget},
+	  gpu_budget_{gpu_budget},
+	  thread_pool_{&thread_pool} {
+
+	if (ranges::any_of(tiles_, [](const auto& tile) { return tile.levels.empty(); })) {
+		throw invalid_argument{"Every tile must have at least one level of detail"};
+	}
+}
+
+TileStreamer TileStreamer::FromTileSet(
+	vector<shared_ptr<const LodArchive>> lod_archives, const size_t cpu_budget, const size_t gpu_budget) {
+
+	vector<Tile> tiles;
+	tiles.reserve(lod_archives.size());
+	for (const auto& lod_archive : lod_archives) {
+		auto& tile = tiles.emplace_back(Tile{.box_min = lod_archive->box_min(), .box_max = lod_archive->box_max(), .levels = {}});
+		for (const auto& level : lod_archive->levels()) {
+			// levels are decompressed into positions, normals, and indices
+			const auto size = level.vertex_count * 2 * sizeof(vec3) + level.triangle_count * 3 * sizeof(GLuint);
+			tile.levels.push_back(Level{.error = level.error, .size = size});
+		}
+	}
+
+	return TileStreamer{
+		move(tiles),
+		[lod_archives = move(lod_archives)](const size_t tile_index, const size_t level) {
+			return lod_archives[tile_index]->LoadLevel(level);
+		},
+		cpu_budget,
+		gpu_budget};
+}
+
+void TileStreamer::Update(const vec3& viewpoint, const float max_error_per_distance) {
+	++frame_;
+	FinishLoads();
+
+	vector<pair<float, size_t>> tile_distances;
+	tile_distances.reserve(tiles_.size());
+	for (size_t i = 0; i < tiles_.size(); ++i) {
+		tile_distances.emplace_back(GetDistance(viewpoint, tiles_[i].box_min, tiles_[i].box_max), i);
+	}
+	ranges::sort(tile_distances);
+
+	drawable_meshes_.clear();
+	size_t used_bytes = 0;
+	size_t drawable_bytes = 0;
+	size_t pending_bytes = 0;
+	for (const auto& load : loads_) pending_bytes += load.size;
+
+	for (const auto& [distance, tile_index] : tile_distances) {
+		const auto& tile = tiles_[tile_index];
+		const auto level = SelectLevel(tile, distance * max_error_per_distance);
+
+		auto* const entry = FindClosestResidentLevel(tile_index, level);
+		if (entry) {
+			// farther tiles are neither drawn nor kept once the levels of nearer tiles fill the budget
+			if (used_bytes + entry->size > cpu_budget_) break;
+			used_bytes += entry->size;
+
+			entries_.splice(entries_.begin(), entries_, entries_by_key_.at(GetKey(entry->tile_index, entry->level)));
+			entry->last_used_frame = frame_;
+
+			if (drawable_bytes + entry->size <= gpu_budget_) {
+				drawable_bytes += entry->size;
+				drawable_meshes_.push_back(&entry->mesh);
+				entry->last_drawn_frame = frame_;
+				if (!entry->gpu_resident) {
+					entry->gpu_resident = true;
+					statistics_.gpu_bytes += entry->size;
+				}
+			}
+		}
+
+		const auto key = GetKey(tile_index, level);
+		if ((entry && entry->level == level) || loads_.size() >= kMaxPendingLoads || failed_keys_.contains(key)
+			|| ranges::any_of(loads_, [key](const auto& load) { return GetKey(load.tile_index, load.level) == key; })) {
+			continue;
+		}
+
+		// reserve budget for the load so the levels of nearer tiles are never evicted to make room for it
+		const auto size = tile.levels[level].size;
+		if (used_bytes + pending_bytes + size > cpu_budget_) continue;
+		pending_bytes += size;
+
+		loads_.push_back(Load{.tile_index = tile_index,
+		                      .level = level,
+		                      .size = size,
+		                      .mesh = thread_pool_->Submit([loader = loader_, tile_index, level] {
+			                      return (*loader)(tile_index, level);
+		                      })});
+	}
+
+	EvictFromMemory(pending_bytes);
+	EvictFromGpu();
+	statistics_.resident_count = entries_.size();
+	statistics_.pending_load_count = loads_.size();
+}
+
+void TileStreamer::WaitForLoads() const {
+	for (const auto& load : loads_) {
+		load.mesh.wait();
+	}
+}
+
+void TileStreamer::FinishLoads() {
+	erase_if(loads_, [this](Load& load) {
+		if (load.mesh.wait_for(chrono::seconds{0}) != future_status::ready) return false;
+
+		const auto key = GetKey(load.tile_index, load.level);
+		try {
+			auto mesh = load.mesh.get();
+			const auto size = mesh.GetBufferSize();
+			entries_.push_front(Entry{.tile_index = load.tile_index,
+			                          .level = load.level,
+			                          .mesh = move(mesh),
+			                          .size = size,
+			                          .last_used_frame = 0,
+			                          .last_drawn_frame = 0,
+			                          .gpu_resident = false});
+			entries_by_key_.emplace(key, entries_.begin());
+			statistics_.cpu_bytes += size;
+			++statistics_.load_count;
+		} catch (const exception& e) {
+			// a level that cannot be loaded is not requested again so it does not fail on every update
+			cerr << e.what() << endl;
+			failed_keys_.insert(key);
+			++statistics_.failed_load_count;
+		}
+		return true;
+	});
+}
+
+TileStreamer::Entry* TileStreamer::FindClosestResidentLevel(const size_t tile_index, const size_t level) noexcept {
+	// prefer finer levels over coarser ones at the same distance from the selected level
+	const auto level_count = tiles_[tile_index].levels.size();
+	for (size_t offset = 0; offset < level_count; ++offset) {
+		for (const auto candidate : {level - offset, level + offset}) {
+			if (candidate >= level_count) continue;
+			if (const auto iterator = entries_by_key_.find(GetKey(tile_index, candidate)); iterator != entries_by_key_.end()) {
+				return &*iterator->second;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void TileStreamer::EvictFromMemory(const size_t pending_bytes) {
+	// levels used in this update are at the front of the list and are never evicted
+	while (!entries_.empty() && statistics_.cpu_bytes + pending_bytes > cpu_budget_
+		&& entries_.back().last_used_frame != frame_) {
+
+		const auto& entry = entries_.back();
+		statistics_.cpu_bytes -= entry.size;
+		if (entry.gpu_resident) statistics_.gpu_bytes -= entry.size;
+		entries_by_key_.erase(GetKey(entry.tile_index, entry.level));
+		entries_.pop_back();
+		++statistics_.cpu_eviction_count;
+	}
+}
+
+void TileStreamer::EvictFromGpu() {
+	if (statistics_.gpu_bytes <= gpu_budget_) return;
+
+	vector<Entry*> evictable_entries;
+	for (auto& entry : entries_) {
+		if (entry.gpu_resident && entry.last_drawn_frame != frame_) evictable_entries.push_back(&entry);
+	}
+	ranges::sort(evictable_entries, {}, &Entry::last_drawn_frame);
+
+	for (auto* const entry : evictable_entries) {
+		if (statistics_.gpu_bytes <= gpu_budget_) break;
+		entry->mesh.Unload();
+		entry->gpu_resident = false;
+		statistics_.gpu_bytes -= entry->size;
+		++statistics_.gpu_eviction_count;
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "concurrency/thread_pool.h"
+#include "graphics/mesh.h"
+
+namespace io {
+class LodArchive;
+
+/**
+ * \brief Keeps the spatial tiles of a mesh that are near a viewpoint resident under fixed memory budgets.
+ * \details Each update selects a level of detail for every tile by its distance to the viewpoint, loads missing levels
+ *          asynchronously on a thread pool, and evicts the least recently used levels once the CPU budget is exceeded.
+ *          Tiles are visited from nearest to farthest so nearby tiles take precedence when a budget is exhausted, and
+ *          a tile keeps drawing its closest resident level until the selected level finishes loading.
+ *
+ *          GPU residency is tracked separately: drawable meshes count against the GPU budget and meshes that have not
+ *          been drawn recently have their buffers released with \c gfx::Mesh::Unload while staying resident in memory.
+ *          The streamer never uploads meshes itself, so it can be driven without an OpenGL context (e.g., to replay a
+ *          simulated camera path with a loader that synthesizes meshes).
+ * \note All member functions must be called from the same thread (the render thread when meshes are drawn).
+ */
+class TileStreamer {
+
+public:
+	/** \brief A level of detail of a tile. */
+	struct Level {
+
+		/** \brief The geometric error of the level in object space. */
+		float error;
+
+		/** \brief The estimated size of the level in bytes, used to reserve budget before it is loaded. */
+		std::size_t size;
+	};
+
+	/** \brief A spatial tile of a mesh. */
+	struct Tile {
+
+		/** \brief The min of the tile bounding box in object space. */
+		glm::vec3 box_min;
+
+		/** \brief The max of the tile bounding box in object space. */
+		glm::vec3 box_max;
+
+		/** \brief The tile levels of detail ordered from the most to the least detailed. */
+		std::vector<Level> levels;
+	};
+
+	/** \brief Counters describing the current residency and the work done so far. */
+	struct Statistics {
+		std::size_t cpu_bytes = 0;
+		std::size_t gpu_bytes = 0;
+		std::size_t resident_count = 0;
+		std::size_t pending_load_count = 0;
+		std::size_t load_count = 0;
+		std::size_t failed_load_count = 0;
+		std::size_t cpu_eviction_count = 0;
+		std::size_t gpu_eviction_count = 0;
+	};
+
+	/**
+	 * \brief Loads a level of detail of a tile. Invoked on a worker thread.
+	 * \details Loaders may throw to indicate a level cannot be loaded, in which case it is not requested again.
+	 */
+	using Loader = std::function<gfx::Mesh(std::size_t tile_index, std::size_t level)>;
+
+	/**
+	 * \brief Initializes a tile streamer.
+	 * \param tiles The tiles to stream.
+	 * \param loader Loads the levels of detail of \p tiles.
+	 * \param cpu_budget The number of bytes that resident and loading levels may occupy in memory.
+	 * \param gpu_budget The number of bytes of drawable levels that may occupy GPU buffers.
+	 * \param thread_pool The thread pool that runs \p loader.
+	 * \throw std::invalid_argument Indicates a tile has no levels of detail.
+	 */
+	TileStreamer(std::vector<Tile> tiles,
+	             Loader loader,
+	             std::size_t cpu_budget,
+	             std::size_t gpu_budget,
+	             concurrency::ThreadPool& thread_pool = concurrency::ThreadPool::Default());
+
+	/**
+	 * \brief Creates a tile streamer for the tile archives of a tile set (see \c io::OpenTileSet).
+	 * \param lod_archives The tile archives.
+	 * \param cpu_budget The number of bytes that resident and loading levels may occupy in memory.
+	 * \param gpu_budget The number of bytes of drawable levels that may occupy GPU buffers.
+	 * \return A tile streamer that decompresses levels from \p lod_archives.
+	 */
+	[[nodiscard]] static TileStreamer FromTileSet(
+		std::vector<std::shared_ptr<const LodArchive>> lod_archives, std::size_t cpu_budget, std::size_t gpu_budget);
+
+	/**
+	 * \brief Updates tile residency for a viewpoint.
+	 * \param viewpoint The viewpoint in the object space of the tiles.
+	 * \param max_error_per_distance The largest acceptable geometric error of a level per unit of distance from
+	 *        \p viewpoint (e.g., the pixel error tolerance divided by the number of pixels per unit at unit distance).
+	 */
+	void Update(const glm::vec3& viewpoint, float max_error_per_distance);
+
+	/** \brief Blocks until every pending load has finished. Loaded levels become drawable on the next update. */
+	void WaitForLoads() const;
+
+	/** \brief Gets the meshes to draw for the viewpoint of the last update, ordered from nearest to farthest. */
+	[[nodiscard]] std::span<const gfx::Mesh* const> drawable_meshes() const noexcept { return drawable_meshes_; }
+
+	/** \brief Gets the streamed tiles. */
+	[[nodiscard]] std::span<const Tile> tiles() const noexcept { return tiles_; }
+
+	/** \brief Gets the current residency counters. */
+	[[nodiscard]] const Statistics& statistics() const noexcept { return statistics_; }
+
+private:
+	struct Entry {
+		std::size_t tile_index;
+		std::size_t level;
+		gfx::Mesh mesh;
+		std::size_t size;
+		std::uint64_t last_used_frame;
+		std::uint64_t last_drawn_frame;
+		bool gpu_resident;
+	};
+
+	struct Load {
+		std::size_t tile_index;
+		std::size_t level;
+		std::size_t size;
+		std::future<gfx::Mesh> mesh;
+	};
+
+	void FinishLoads();
+	[[nodiscard]] Entry* FindClosestResidentLevel(std::size_t tile_index, std::size_t level) noexcept;
+	void EvictFromMemory(std::size_t pending_bytes);
+	void EvictFromGpu();
+
+	std::vector<Tile> tiles_;
+	std::shared_ptr<const Loader> loader_;
+	std::size_t cpu_budget_;
+	std::size_t gpu_budget_;
+	concurrency::ThreadPool* thread_pool_;
+
+	// resident levels ordered from most to least recently used
+	std::list<Entry> entries_;
+	std::unordered_map<std::uint64_t, std::list<Entry>::iterator> entries_by_key_;
+	std::vector<Load> loads_;
+	std::unordered_set<std::uint64_t> failed_keys_;
+	std::vector<const gfx::Mesh*> drawable_meshes_;
+	std::uint64_t frame_ = 0;
+	Statistics statistics_;
+};
+}
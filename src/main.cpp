@@ -1,4 +1,6 @@
 #include <exception>
+#include <string_view>
+#include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -30,6 +32,7 @@ int girdResolution = MAX_GRID;
 int maxNumberPerLeaf = MIN_OCTREE;
 
 bool simplify = false;
+bool simplify_all = false;
 bool backToOriginal = false;
 
 bool show_valence = false; 
@@ -169,6 +172,8 @@ void renderGui() {
         {
             ImGui::SetCursorPosX(ImGui::GetWindowSize().x * 0.2f);
             if (ImGui::Button("Simplify", ImVec2(ImGui::GetWindowSize().x * 0.5f, 0.0f))) simplify = true;
+            ImGui::SetCursorPosX(ImGui::GetWindowSize().x * 0.2f);
+            if (ImGui::Button("Simplify All", ImVec2(ImGui::GetWindowSize().x * 0.5f, 0.0f))) simplify_all = true;
         }
 
         ImGui::Dummy(ImVec2(0.0f, 20.0f));
@@ -230,7 +235,7 @@ void renderGui() {
 }
 
 
-int main() {
+int main(const int argc, char* argv[]) {
 
     try {
         constexpr auto kWindowDimensions = std::make_pair(gWidth, gHeight);
@@ -241,7 +246,10 @@ int main() {
         std::string fragShader = SHADER_FOLDER + std::string("fragment.glsl");
         ShaderProgram shader_program{ vertShader, fragShader };
 
-        Scene scene(window, camera, shader_program);
+        // models (.obj files or .mlod level of detail archives) can be passed on the command line
+        vector<string_view> model_filepaths(argv + 1, argv + argc);
+        if (model_filepaths.empty()) model_filepaths.push_back(ASSETS_FOLDER"/models/bunny.obj");
+        Scene scene(window, camera, shader_program, model_filepaths);
 
 
         /**
@@ -267,6 +275,13 @@ int main() {
             if (simplify)
                 scene.Simplify();
 
+            if (simplify_all) {
+                scene.SimplifyAll(0.5f);
+                simplify_all = false;
+            }
+
+            scene.Update();
+
             scene.SetMaterialType(static_cast<MaterialType>(material_type_index));
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -0,0 +1,520 @@
+#include "tools/batch/batch_processor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "concurrency/memory_budget.h"
+#include "concurrency/memory_tracker.h"
+#include "concurrency/thread_pool.h"
+#include "geometry/half_edge_mesh.h"
+#include "geometry/mesh_culler.h"
+#include "geometry/mesh_simplifier.h"
+#include "geometry/mesh_snapshot.h"
+#include "geometry/mesh_welder.h"
+#include "graphics/mesh.h"
+#include "graphics/obj_loader.h"
+#include "graphics/obj_writer.h"
+#include "io/compressed_mesh.h"
+#include "io/content_hash.h"
+#include "io/lod_archive.h"
+#include "io/tile_set.h"
+#include "tools/batch/manifest.h"
+
+using namespace batch;
+using namespace concurrency;
+using namespace geometry;
+using namespace gfx;
+using namespace std;
+
+namespace {
+
+constexpr auto kManifestFilename = "manifest.tsv";
+
+/**
+ * \brief The estimated peak memory used to process a model per byte of .obj input.
+ * \details Measured on closed triangle meshes, the loaded triangle soup, welded mesh, half-edge mesh, quadrics, and
+ *          priority queue together occupy roughly 20-30 times the size of the .obj text.
+ */
+constexpr size_t kPeakMemoryPerInputByte = 32;
+
+/**
+ * \brief Increment when the output of a batch run changes for identical inputs and rates.
+ * \details This includes changes to the output of default options (e.g., skipping contractions that fold triangles
+ *          over), which invalidate every manifest entry.
+ */
+constexpr auto kParametersVersion = 8;
+
+/**
+ * \brief Finds all .obj models in a directory tree.
+ * \param directory The directory to search.
+ * \return The model filepaths in lexicographic order so runs process models in a stable order.
+ */
+vector<filesystem::path> FindModels(const filesystem::path& directory) {
+	vector<filesystem::path> filepaths;
+	for (const auto& entry : filesystem::recursive_directory_iterator{directory}) {
+		auto extension = entry.path().extension().string();
+		ranges::transform(extension, extension.begin(), [](const unsigned char c) { return static_cast<char>(tolower(c)); });
+		if (entry.is_regular_file() && extension == ".obj") {
+			filepaths.push_back(entry.path());
+		}
+	}
+	ranges::sort(filepaths);
+	return filepaths;
+}
+
+/**
+ * \brief Computes a hash of the parameters that affect batch outputs.
+ * \param rates The simplification rate of each level of detail.
+ * \param compress Whether outputs are compressed.
+ * \param archive Whether outputs are level of detail archives.
+ * \param tiles_per_axis The number of tiles per axis outputs are split into.
+ * \param simplification_options The options models are simplified with.
+ * \param hidden_view_count The number of views hidden triangles are classified from, zero if they are kept.
+ * \return A hash that changes whenever \p rates, the simplification options, or the output format changes.
+ */
+uint64_t HashParameters(const vector<float>& rates,
+                        const bool compress,
+                        const bool archive,
+                        const unsigned int tiles_per_axis,
+                        const mesh::SimplificationOptions& simplification_options,
+                        const unsigned int hidden_view_count) {
+	auto parameters = format(
+		"version={};compress={};archive={};tiles={};rates=", kParametersVersion, compress, archive, tiles_per_axis);
+	for (const auto rate : rates) {
+		parameters += format("{},", rate);
+	}
+	// options are only hashed when enabled so adding an option does not change the hash of runs that do not use it,
+	// changes to the output of runs that do not use any option increment kParametersVersion instead
+	if (simplification_options.preserve_features) {
+		parameters += format(";features={},{},{}",
+			simplification_options.feature_angle,
+			simplification_options.feature_weight,
+			simplification_options.curvature_weight);
+	}
+	if (simplification_options.quality_passes > 0) {
+		parameters += format(";quality={}", simplification_options.quality_passes);
+	}
+	if (simplification_options.approximate_ordering) {
+		parameters += ";approximate";
+	}
+	if (simplification_options.weight_by_visibility) {
+		parameters += format(
+			";visibility={},{}", simplification_options.visibility_samples, simplification_options.hidden_weight);
+	}
+	if (hidden_view_count > 0) {
+		parameters += format(";hidden={}", hidden_view_count);
+	}
+	return io::HashBytes(as_bytes(span{parameters.data(), parameters.size()}));
+}
+
+/**
+ * \brief Gets the output filepaths of a model.
+ * \param output_directory The root output directory.
+ * \param relative_path The model path relative to the input directory.
+ * \param lod_count The number of levels of detail.
+ * \param extension The output file extension.
+ * \return The output filepath for each level of detail.
+ */
+vector<filesystem::path> GetOutputFilepaths(const filesystem::path& output_directory,
+                                            const filesystem::path& relative_path,
+                                            const size_t lod_count,
+                                            const string_view extension) {
+
+	vector<filesystem::path> filepaths;
+	filepaths.reserve(lod_count);
+	for (size_t i = 1; i <= lod_count; ++i) {
+		auto filepath = output_directory / relative_path;
+		filepath.replace_filename(format("{}_lod{}{}", relative_path.stem().string(), i, extension));
+		filepaths.push_back(move(filepath));
+	}
+	return filepaths;
+}
+
+/**
+ * \brief Writes the latest snapshot of a level of detail being simplified.
+ * \param snapshot_channel The channel the simplification publishes its progress to.
+ * \param filepath The .obj file to write, which is replaced rather than overwritten so readers never see a partial file.
+ */
+void WritePreview(MeshSnapshotChannel& snapshot_channel, const filesystem::path& filepath) noexcept {
+	try {
+		if (const auto snapshot = snapshot_channel.TakeSnapshot()) {
+			auto temporary_filepath = filepath;
+			temporary_filepath += ".tmp";
+			obj_writer::WriteMesh(*snapshot, temporary_filepath.string());
+			filesystem::rename(temporary_filepath, filepath);
+		}
+	} catch (const exception& e) {
+		// previews are informational, so failing to write one does not fail the model
+		cerr << format("Failed to write preview {}: {}\n", filepath.string(), e.what());
+	}
+}
+
+/**
+ * \brief Simplifies a level of detail of a model.
+ * \param mesh The model to simplify.
+ * \param rate The simplification rate of the level.
+ * \param simplification_options The options every level of detail is simplified with.
+ * \param level_filepath The output of the level, which checkpoints and previews of the level are written next to.
+ * \param preview_interval The time between previews of the level written while it is simplified, zero to not write
+ *                         previews.
+ * \return The simplified level and its error estimate.
+ */
+mesh::SimplifiedMesh SimplifyLevel(const MeshView& mesh,
+                                   const float rate,
+                                   const mesh::SimplificationOptions& simplification_options,
+                                   const filesystem::path& level_filepath,
+                                   const chrono::milliseconds preview_interval) {
+
+	auto level_options = simplification_options;
+	if (level_options.checkpoint_interval > chrono::seconds::zero()) {
+		level_options.checkpoint_path = filesystem::path{level_filepath} += ".checkpoint";
+	}
+	if (preview_interval <= chrono::milliseconds::zero()) return mesh::SimplifyWithError(mesh, rate, level_options);
+
+	// a reader thread exports snapshots of the level while it is simplified without pausing the simplification
+	auto& snapshot_channel = *(level_options.snapshot_channel = make_shared<MeshSnapshotChannel>());
+	const auto preview_filepath = filesystem::path{level_filepath} += ".preview.obj";
+	auto simplified_mesh = [&] {
+		const jthread preview_writer{[&](const stop_token stop_token) {
+			mutex mutex;
+			condition_variable_any interval_elapsed;
+			unique_lock lock{mutex};
+			while (!interval_elapsed.wait_for(lock, stop_token, preview_interval, [] { return false; })
+			       && !stop_token.stop_requested()) {
+				WritePreview(snapshot_channel, preview_filepath);
+			}
+		}};
+		return mesh::SimplifyWithError(mesh, rate, level_options);
+	}();
+
+	if (error_code error; !filesystem::remove(preview_filepath, error) && error) {
+		cerr << format("Failed to remove preview {}: {}\n", preview_filepath.string(), error.message());
+	}
+	return simplified_mesh;
+}
+
+/**
+ * \brief Loads and welds a model.
+ * \param input_filepath The model to load.
+ * \param hidden_view_count The number of views parts hidden from all of them are classified from, zero to keep hidden
+ *                          parts.
+ * \param memory_profiler The profiler the memory of loading the model is attributed to, null to not profile memory.
+ * \return The welded model without its hidden parts, which are removed before simplification so no level of detail
+ *         spends triangles on them.
+ */
+Mesh LoadModel(const filesystem::path& input_filepath,
+               const unsigned int hidden_view_count,
+               MemoryProfiler* const memory_profiler) {
+	auto mesh = mesh::Weld(obj_loader::LoadMesh(input_filepath.string(), memory_profiler));
+	if (hidden_view_count == 0) return mesh;
+	return mesh::RemoveHiddenTriangles(mesh, hidden_view_count);
+}
+
+/**
+ * \brief Simplifies a model into each level of detail and writes the results.
+ * \param mesh The model to simplify.
+ * \param output_filepaths The output filepath for each level of detail.
+ * \param rates The simplification rate of each level of detail.
+ * \param simplification_options The options to simplify the model with.
+ * \param compress Whether to write compressed meshes rather than .obj files.
+ * \param preview_interval The time between previews of each level written while it is simplified.
+ */
+void ProcessModel(const Mesh& mesh,
+                      const vector<filesystem::path>& output_filepaths,
+                      const vector<float>& rates,
+                      const mesh::SimplificationOptions& simplification_options,
+                      const bool compress,
+                      const chrono::milliseconds preview_interval) {
+
+	filesystem::create_directories(output_filepaths.front().parent_path());
+
+	for (size_t i = 0; i < rates.size(); ++i) {
+		const auto simplified_mesh
+			= SimplifyLevel(mesh, rates[i], simplification_options, output_filepaths[i], preview_interval).mesh;
+		if (compress) {
+			io::WriteCompressedMesh(simplified_mesh, output_filepaths[i]);
+		} else {
+			obj_writer::WriteMesh(simplified_mesh, output_filepaths[i].string());
+		}
+	}
+}
+
+/**
+ * \brief Simplifies a model into each level of detail and writes them to a single archive.
+ * \param mesh The model to simplify.
+ * \param output_filepath The archive to write.
+ * \param rates The simplification rate of each level of detail.
+ * \param simplification_options The options to simplify the model with.
+ * \param preview_interval The time between previews of each level written while it is simplified.
+ * \note The source model is stored as the most detailed level so viewers can refine up to full detail. It is
+ *       converted through a half-edge mesh so it has the same area-weighted vertex normals as the simplified levels.
+ */
+void ArchiveModel(const Mesh& mesh,
+                      const filesystem::path& output_filepath,
+                      const vector<float>& rates,
+                      const mesh::SimplificationOptions& simplification_options,
+                      const chrono::milliseconds preview_interval) {
+
+	filesystem::create_directories(output_filepath.parent_path());
+
+	io::LodArchiveWriter archive_writer;
+	const auto source_mesh = static_cast<Mesh>(HalfEdgeMesh{mesh});
+	archive_writer.Add(source_mesh, 0.f, 0.f);
+	for (size_t i = 0; i < rates.size(); ++i) {
+		const auto [simplified_mesh, error] = SimplifyLevel(
+			mesh, rates[i], simplification_options, filesystem::path{output_filepath} += format(".lod{}", i + 1), preview_interval);
+		archive_writer.Add(simplified_mesh, rates[i], error);
+	}
+	archive_writer.Write(output_filepath);
+}
+
+/**
+ * \brief Simplifies a model into each level of detail and splits the levels into spatially streamable tiles.
+ * \param mesh The model to simplify.
+ * \param output_directory The tile set directory to write.
+ * \param rates The simplification rate of each level of detail.
+ * \param simplification_options The options to simplify the model with.
+ * \param tiles_per_axis The number of tiles along each axis.
+ * \param preview_interval The time between previews of each level written while it is simplified.
+ */
+void TileModel(const Mesh& mesh,
+                   const filesystem::path& output_directory,
+                   const vector<float>& rates,
+                   const mesh::SimplificationOptions& simplification_options,
+                   const unsigned int tiles_per_axis,
+                   const chrono::milliseconds preview_interval) {
+
+	filesystem::create_directories(output_directory.parent_path());
+
+	// every level must be kept until all are split since each tile archive holds a level of every tile
+	vector<mesh::SimplifiedMesh> simplified_meshes;
+	simplified_meshes.reserve(rates.size() + 1);
+	simplified_meshes.push_back(mesh::SimplifiedMesh{.mesh = static_cast<Mesh>(HalfEdgeMesh{mesh}), .error = 0.f});
+	for (size_t i = 0; i < rates.size(); ++i) {
+		simplified_meshes.push_back(SimplifyLevel(
+			mesh, rates[i], simplification_options, filesystem::path{output_directory} += format(".lod{}", i + 1), preview_interval));
+	}
+
+	vector<io::TileSetLevel> levels;
+	levels.reserve(simplified_meshes.size());
+	for (size_t i = 0; i < simplified_meshes.size(); ++i) {
+		levels.push_back(io::TileSetLevel{
+			.mesh = simplified_meshes[i].mesh, .rate = i ? rates[i - 1] : 0.f, .error = simplified_meshes[i].error});
+	}
+	io::WriteTileSet(levels, tiles_per_axis, output_directory);
+}
+
+/**
+ * \brief Computes a checksum of the files written for a model.
+ * \param output_filepaths The outputs of the model. Directories (e.g., tile sets) are hashed by the relative path and
+ *                         contents of each file they contain in path order.
+ * \return A hash of the written bytes as computed by \c io::HashFile.
+ * \throw std::runtime_error Indicates an output cannot be read.
+ */
+uint64_t HashOutputs(const vector<filesystem::path>& output_filepaths) {
+	uint64_t checksum = 0;
+	for (const auto& output_filepath : output_filepaths) {
+		if (!filesystem::is_directory(output_filepath)) {
+			checksum = io::HashFile(output_filepath, checksum);
+			continue;
+		}
+		// directory iteration order is unspecified, so files are hashed in order of their relative paths
+		vector<string> relative_filepaths;
+		for (const auto& entry : filesystem::recursive_directory_iterator{output_filepath}) {
+			if (entry.is_regular_file()) {
+				relative_filepaths.push_back(entry.path().lexically_relative(output_filepath).generic_string());
+			}
+		}
+		ranges::sort(relative_filepaths);
+		for (const auto& relative_filepath : relative_filepaths) {
+			checksum = io::HashBytes(as_bytes(span{relative_filepath.data(), relative_filepath.size()}), checksum);
+			checksum = io::HashFile(output_filepath / relative_filepath, checksum);
+		}
+	}
+	return checksum;
+}
+
+/**
+ * \brief Saves the manifest of a run once it ends, even if it ends with an exception.
+ * \details A run that completes records only the models it skipped or processed, so removed or failed models are
+ *          dropped. A run that ends with an exception also keeps the cached entries of models it did not reach.
+ */
+class ManifestSaver {
+
+public:
+	ManifestSaver(const Manifest& cached_manifest, const Manifest& manifest, filesystem::path filepath)
+		: cached_manifest_{cached_manifest}, manifest_{manifest}, filepath_{move(filepath)} {}
+
+	~ManifestSaver() {
+		if (saved_) return;
+		try {
+			auto merged_manifest = cached_manifest_;
+			merged_manifest.Update(manifest_);
+			merged_manifest.Save(filepath_);
+		} catch (const exception& e) {
+			cerr << e.what() << endl;
+		}
+	}
+
+	ManifestSaver(const ManifestSaver&) = delete;
+	ManifestSaver& operator=(const ManifestSaver&) = delete;
+
+	/**
+	 * \brief Saves the manifest now rather than when the saver is destroyed.
+	 * \throw std::runtime_error Indicates the manifest cannot be written.
+	 */
+	void Save() {
+		manifest_.Save(filepath_);
+		saved_ = true;
+	}
+
+private:
+	const Manifest& cached_manifest_;
+	const Manifest& manifest_;
+	filesystem::path filepath_;
+	bool saved_ = false;
+};
+}
+
+Summary batch::Run(const Options& options) {
+
+	if (options.rates.empty()) throw invalid_argument{"At least one level of detail must be specified"};
+	if (options.job_count == 0) throw invalid_argument{"The job count must be positive"};
+	for (const auto rate : options.rates) {
+		if (rate < 0.f || rate > 1.f) throw invalid_argument{format("Invalid mesh simplification rate {}", rate)};
+	}
+
+	filesystem::create_directories(options.output_directory);
+	const auto manifest_filepath = options.output_directory / kManifestFilename;
+	const auto cached_manifest = Manifest::Load(manifest_filepath);
+	const auto parameters_hash = HashParameters(options.rates,
+	                                            options.compress,
+	                                            options.archive,
+	                                            options.tiles_per_axis,
+	                                            options.simplification_options,
+	                                            options.hidden_view_count);
+
+	// checkpoints do not affect outputs, so they are not part of the parameters hash
+	auto simplification_options = options.simplification_options;
+	simplification_options.checkpoint_interval = options.checkpoint_interval;
+
+	// rewrite the cached manifest so entries cut off by an interrupted run are dropped before entries are appended
+	cached_manifest.Save(manifest_filepath);
+
+	// entries are only recorded for models that are skipped or processed successfully in this run, the saver is
+	// declared before the thread pool so the manifest is saved after queued jobs finish even if a job rethrows
+	Manifest manifest;
+	mutex mutex;
+	Summary summary;
+	ManifestSaver manifest_saver{cached_manifest, manifest, manifest_filepath};
+
+	// the thread pool is declared last so queued jobs finish before the state they reference is destroyed
+	MemoryBudget memory_budget{options.memory_budget};
+	ThreadPool thread_pool{options.job_count};
+	vector<future<void>> jobs;
+
+	for (const auto& input_filepath : FindModels(options.input_directory)) {
+		const auto relative_path = filesystem::relative(input_filepath, options.input_directory);
+		const auto key = relative_path.generic_string();
+		auto output_filepaths = options.tiles_per_axis
+			? vector{(options.output_directory / relative_path).replace_extension(io::kTileSetExtension)}
+			: options.archive
+			? vector{(options.output_directory / relative_path).replace_extension(io::kLodArchiveExtension)}
+			: GetOutputFilepaths(
+				options.output_directory, relative_path, options.rates.size(), options.compress ? ".mshz" : ".obj");
+
+		ManifestEntry entry{};
+		size_t memory_estimate = 0;
+		try {
+			entry = ManifestEntry{.content_hash = io::HashFile(input_filepath), .parameters_hash = parameters_hash};
+			memory_estimate = filesystem::file_size(input_filepath) * kPeakMemoryPerInputByte;
+		} catch (const exception& e) {
+			cerr << e.what() << endl;
+			++summary.failed;
+			continue;
+		}
+
+		if (const auto* const cached_entry = cached_manifest.Find(key);
+			cached_entry && *cached_entry == entry && ranges::all_of(output_filepaths, [](const auto& filepath) {
+				return filesystem::exists(filepath);
+			})) {
+			manifest.Set(key, entry);
+			++summary.skipped;
+			continue;
+		}
+
+		// reserve memory before submitting so the number of running jobs adapts to model sizes
+		memory_budget.Acquire(memory_estimate);
+
+		jobs.push_back(thread_pool.Submit([&, input_filepath, key, entry, memory_estimate, output_filepaths = move(output_filepaths)] {
+			const auto start_time = chrono::steady_clock::now();
+			auto succeeded = false;
+			uint64_t checksum = 0;
+			optional<MemoryProfiler> memory_profiler;
+			try {
+				auto model_options = simplification_options;
+				if (options.profile_memory) {
+					model_options.memory_profiler = &memory_profiler.emplace(format("processing {}", key));
+				}
+				const auto mesh = LoadModel(input_filepath, options.hidden_view_count, model_options.memory_profiler);
+				if (options.tiles_per_axis) {
+					TileModel(
+						mesh, output_filepaths.front(), options.rates, model_options, options.tiles_per_axis, options.preview_interval);
+				} else if (options.archive) {
+					ArchiveModel(
+						mesh, output_filepaths.front(), options.rates, model_options, options.preview_interval);
+				} else {
+					ProcessModel(
+						mesh, output_filepaths, options.rates, model_options, options.compress, options.preview_interval);
+				}
+				checksum = HashOutputs(output_filepaths);
+				succeeded = true;
+			} catch (const exception& e) {
+				cerr << format("Failed to process {}: {}\n", key, e.what());
+			}
+			memory_budget.Release(memory_estimate);
+
+			const auto end_time = chrono::steady_clock::now();
+			scoped_lock lock{mutex};
+			if (succeeded) {
+				manifest.Set(key, entry);
+				++summary.processed;
+				// the saved manifest keeps entries of the previous run until this run ends, so appended entries are
+				// recorded on top of them in case this run is interrupted
+				try {
+					Manifest::Append(manifest_filepath, key, entry);
+				} catch (const exception& e) {
+					cerr << e.what() << endl;
+				}
+				// outputs are deterministic, so their checksum identifies them across machines and thread counts
+				cout << format("Processed {} in {} seconds (checksum {:016x})\n",
+					key,
+					chrono::duration<float>{end_time - start_time}.count(),
+					checksum);
+				if (memory_profiler) cout << memory_profiler->Summary();
+			} else {
+				++summary.failed;
+			}
+		}));
+	}
+
+	for (auto& job : jobs) {
+		job.get();
+	}
+
+	manifest_saver.Save();
+	return summary;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "geometry/mesh_simplifier.h"
+
+namespace batch {
+
+/** \brief Options that control a batch run. */
+struct Options {
+
+	/** \brief The directory that is recursively searched for .obj models. */
+	std::filesystem::path input_directory;
+
+	/** \brief The directory that receives simplified models, mirroring the layout of \c input_directory. */
+	std::filesystem::path output_directory;
+
+	/** \brief The simplification rates used to produce each level of detail (e.g., .5 removes 50% of triangles). */
+	std::vector<float> rates;
+
+	/** \brief The options every level of detail is simplified with. */
+	geometry::mesh::SimplificationOptions simplification_options;
+
+	/** \brief The maximum number of models processed concurrently. */
+	std::size_t job_count;
+
+	/** \brief The number of bytes that concurrently processed models may reserve at once. */
+	std::size_t memory_budget;
+
+	/** \brief Whether levels of detail are written as compressed .mshz meshes rather than .obj files. */
+	bool compress = false;
+
+	/** \brief Whether all levels of detail of a model are written to a single .mlod archive (implies compression). */
+	bool archive = false;
+
+	/**
+	 * \brief The number of spatial tiles along each axis a model is split into, zero to not split models.
+	 * \details Tiled models are written as a .mtiles directory holding a level of detail archive per tile.
+	 */
+	unsigned int tiles_per_axis = 0;
+
+	/**
+	 * \brief The number of view directions hidden parts are classified from, zero to keep hidden parts.
+	 * \details Connected parts that cannot be seen from outside a model from any view (e.g., enclosed parts of
+	 *          assemblies) are removed once it is welded, so every level of detail, including the source level of
+	 *          archives and tile sets, omits them (see \c geometry::mesh::RemoveHiddenTriangles).
+	 */
+	unsigned int hidden_view_count = 0;
+
+	/**
+	 * \brief The time between checkpoints of each simplification, zero to not write checkpoints.
+	 * \details Checkpoints are written next to the outputs of a model, so rerunning a batch after the process was
+	 *          interrupted (e.g., a preempted node) resumes the simplifications in progress rather than restarting them.
+	 */
+	std::chrono::seconds checkpoint_interval{0};
+
+	/**
+	 * \brief The time between previews of each level of detail written while it is simplified, zero to not write previews.
+	 * \details Previews are snapshots of the simplification in progress written to a <tt>.preview.obj</tt> file next to
+	 *          the outputs of a model by a separate thread, and are removed once the level of detail completes.
+	 */
+	std::chrono::milliseconds preview_interval{0};
+
+	/**
+	 * \brief Whether the memory used by each phase of loading and simplifying a model is reported once it is processed.
+	 * \details Allocation counters are process-wide, so the reports of concurrently processed models include each
+	 *          other's memory unless the job count is one.
+	 */
+	bool profile_memory = false;
+};
+
+/** \brief Counts of models by outcome for a completed batch run. */
+struct Summary {
+	std::size_t processed = 0;
+	std::size_t skipped = 0;
+	std::size_t failed = 0;
+};
+
+/**
+ * \brief Simplifies every model in a directory tree into a set of levels of detail.
+ * \details Each model is welded, stripped of hidden triangles if requested, and then simplified once per rate in
+ *          \p options. Outputs are written as <tt>&lt;name&gt;_lod&lt;n&gt;.obj</tt> (or <tt>.mshz</tt> when
+ *          compressing, or a single <tt>&lt;name&gt;.mlod</tt> archive, or a <tt>&lt;name&gt;.mtiles</tt> tile set)
+ *          next to a manifest recording the content hash of every input and the parameters used to process it. Models
+ *          whose content and parameters match the manifest and whose outputs still exist are skipped. Each model is
+ *          recorded in the manifest as soon as it is processed, so rerunning an interrupted batch only processes the
+ *          models it did not complete.
+ * \param options The batch options.
+ * \return The number of processed, skipped, and failed models.
+ * \throw std::invalid_argument Indicates \p options are invalid.
+ * \throw std::runtime_error Indicates the input directory or manifest cannot be read, or the manifest cannot be written.
+ */
+Summary Run(const Options& options);
+}
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "concurrency/large_array_allocator.h"
+#include "concurrency/memory_budget.h"
+#include "tools/batch/batch_processor.h"
+
+using namespace concurrency;
+using namespace std;
+
+namespace {
+
+constexpr auto kUsage =
+	"Usage: MeshSimplificationBatch <input-directory> <output-directory> [options]\n"
+	"\n"
+	"Simplifies every .obj model found in <input-directory> into one .obj file per level of detail.\n"
+	"Models that are unchanged since the previous run with the same levels of detail are skipped.\n"
+	"\n"
+	"Options:\n"
+	"  --lod <rate>            Adds a level of detail removing <rate> (0-1) of triangles. Defaults to .5, .75, .9\n"
+	"  --jobs <count>          The maximum number of models processed concurrently. Defaults to the hardware threads\n"
+	"  --memory-budget <MiB>   The memory concurrently processed models may use. Defaults to 75% of physical memory\n"
+	"  --compress              Writes levels of detail as compressed .mshz meshes instead of .obj files\n"
+	"  --archive               Writes the model and its levels of detail to a single memory-mappable .mlod archive\n"
+	"  --tiles <count>         Splits models into <count>^3 spatial tiles, each with its own levels of detail, and writes\n"
+	"                          them to a .mtiles directory for streaming\n"
+	"  --huge-pages <policy>   Backs large simplification arrays with huge pages, either transparent or explicit\n"
+	"  --feature-angle <deg>   Preserves creases whose faces meet at a dihedral angle of at least <deg> degrees\n"
+	"  --quality <passes>      Runs up to <passes> edge flip and relaxation passes that remove long thin triangles\n"
+	"  --approximate-order     Orders edge collapses by costs rounded to within 4.4%, which is faster on large models\n"
+	"  --visibility <samples>  Simplifies faces hidden from most of <samples> ray directions first, such as the interior\n"
+	"                          parts of assemblies\n"
+	"  --remove-hidden <views> Removes parts that cannot be seen from outside the model from any of <views> directions\n"
+	"                          before simplification\n"
+	"  --checkpoint <seconds>  Saves simplification progress every <seconds> next to the outputs so a rerun after an\n"
+	"                          interruption resumes where it stopped\n"
+	"  --preview <ms>          Writes the level of detail being simplified to a .preview.obj file every <ms> milliseconds\n"
+	"  --memory-profile        Reports the memory used by each phase of loading and simplifying every model\n";
+
+/** \brief Default memory budget when physical memory cannot be determined. */
+constexpr size_t kFallbackMemoryBudget = size_t{4} << 30;
+}
+
+int main(const int argc, char* argv[]) {
+
+	if (argc < 3) {
+		cerr << kUsage;
+		return EXIT_FAILURE;
+	}
+
+	try {
+		const auto physical_memory = MemoryBudget::GetPhysicalMemory();
+		batch::Options options{
+			.input_directory = argv[1],
+			.output_directory = argv[2],
+			.rates = {},
+			.simplification_options = {},
+			.job_count = max(1u, thread::hardware_concurrency()),
+			.memory_budget = physical_memory ? physical_memory / 4 * 3 : kFallbackMemoryBudget,
+			.compress = false,
+			.archive = false,
+			.tiles_per_axis = 0,
+			.hidden_view_count = 0,
+			.checkpoint_interval = chrono::seconds{0},
+			.preview_interval = chrono::milliseconds{0},
+			.profile_memory = false
+		};
+
+		for (auto i = 3; i < argc; ++i) {
+			const string_view option{argv[i]};
+			if (option == "--compress") {
+				options.compress = true;
+				continue;
+			}
+			if (option == "--archive") {
+				options.archive = true;
+				continue;
+			}
+			if (option == "--approximate-order") {
+				options.simplification_options.approximate_ordering = true;
+				continue;
+			}
+			if (option == "--memory-profile") {
+				options.profile_memory = true;
+				continue;
+			}
+			if (i + 1 >= argc) throw invalid_argument{format("Missing value for {}", option)};
+			const string value{argv[++i]};
+
+			if (option == "--lod") {
+				options.rates.push_back(stof(value));
+			} else if (option == "--jobs") {
+				options.job_count = stoul(value);
+			} else if (option == "--feature-angle") {
+				options.simplification_options.preserve_features = true;
+				options.simplification_options.feature_angle = stof(value) * numbers::pi_v<float> / 180.f;
+			} else if (option == "--quality") {
+				options.simplification_options.quality_passes = static_cast<unsigned int>(stoul(value));
+			} else if (option == "--visibility") {
+				options.simplification_options.weight_by_visibility = true;
+				options.simplification_options.visibility_samples = static_cast<unsigned int>(stoul(value));
+			} else if (option == "--remove-hidden") {
+				options.hidden_view_count = static_cast<unsigned int>(stoul(value));
+			} else if (option == "--checkpoint") {
+				options.checkpoint_interval = chrono::seconds{stoul(value)};
+			} else if (option == "--preview") {
+				options.preview_interval = chrono::milliseconds{stoul(value)};
+			} else if (option == "--tiles") {
+				options.tiles_per_axis = static_cast<unsigned int>(stoul(value));
+			} else if (option == "--huge-pages") {
+				if (value == "transparent") {
+					SetHugePagePolicy(HugePagePolicy::kTransparent);
+				} else if (value == "explicit") {
+					SetHugePagePolicy(HugePagePolicy::kExplicit);
+				} else {
+					throw invalid_argument{format("Unknown huge page policy {}", value)};
+				}
+			} else if (option == "--memory-budget") {
+				options.memory_budget = static_cast<size_t>(stoull(value)) << 20;
+			} else {
+				throw invalid_argument{format("Unknown option {}", option)};
+			}
+		}
+
+		if (options.rates.empty()) {
+			options.rates = {.5f, .75f, .9f};
+		}
+
+		const auto [processed, skipped, failed] = batch::Run(options);
+		cout << format("{} processed, {} skipped, {} failed\n", processed, skipped, failed);
+		return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+
+	} catch (const exception& e) {
+		cerr << e.what() << endl << endl << kUsage;
+		return EXIT_FAILURE;
+	}
+}
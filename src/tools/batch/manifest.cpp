@@ -0,0 +1,100 @@
+#include "tools/batch/manifest.h"
+
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+using namespace batch;
+using namespace std;
+
+namespace {
+
+constexpr string_view kHeader = "# mesh simplification batch manifest v1";
+
+/**
+ * \brief Parses a hexadecimal hash value.
+ * \param text The text to parse.
+ * \return The parsed hash value.
+ * \throw runtime_error Indicates \p text is not a hexadecimal number.
+ */
+uint64_t ParseHash(const string_view text) {
+	uint64_t value = 0;
+	if (const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value, 16);
+		error != errc{} || end != text.data() + text.size()) {
+		throw runtime_error{format("Invalid manifest hash: {}", text)};
+	}
+	return value;
+}
+
+/** \brief Formats a manifest entry as a line of the manifest file. */
+string FormatEntry(const string& key, const ManifestEntry& entry) {
+	return format("{:016x}\t{:016x}\t{}\n", entry.content_hash, entry.parameters_hash, key);
+}
+}
+
+Manifest Manifest::Load(const filesystem::path& filepath) {
+
+	Manifest manifest;
+	if (!filesystem::exists(filepath)) return manifest;
+
+	ifstream stream{filepath};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+
+	string line;
+	if (!getline(stream, line) || line != kHeader) {
+		throw runtime_error{format("Unsupported manifest format: {}", filepath.string())};
+	}
+
+	// each line is formatted as <content hash>\t<parameters hash>\t<relative path>
+	while (getline(stream, line)) {
+		// appends write whole lines, so a line without a newline was cut off by an interrupted append
+		if (line.empty() || stream.eof()) continue;
+
+		const string_view text{line};
+		const auto separator0 = text.find('\t');
+		const auto separator1 = text.find('\t', separator0 + 1);
+		if (separator0 == string_view::npos || separator1 == string_view::npos) {
+			throw runtime_error{format("Malformed manifest entry: {}", line)};
+		}
+
+		manifest.Set(string{text.substr(separator1 + 1)}, ManifestEntry{
+			.content_hash = ParseHash(text.substr(0, separator0)),
+			.parameters_hash = ParseHash(text.substr(separator0 + 1, separator1 - separator0 - 1))
+		});
+	}
+
+	return manifest;
+}
+
+void Manifest::Save(const filesystem::path& filepath) const {
+
+	auto temporary_filepath = filepath;
+	temporary_filepath += ".tmp";
+
+	{
+		ofstream stream{temporary_filepath, ios::trunc};
+		if (!stream) throw runtime_error{"Unable to open " + temporary_filepath.string()};
+
+		stream << kHeader << '\n';
+		for (const auto& [key, entry] : entries_) {
+			stream << FormatEntry(key, entry);
+		}
+
+		if (!stream.flush()) throw runtime_error{"Failed to write " + temporary_filepath.string()};
+	}
+
+	filesystem::rename(temporary_filepath, filepath);
+}
+
+void Manifest::Append(const filesystem::path& filepath, const string& key, const ManifestEntry& entry) {
+	ofstream stream{filepath, ios::app};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+	if (!(stream << FormatEntry(key, entry)).flush()) throw runtime_error{"Failed to write " + filepath.string()};
+}
+
+const ManifestEntry* Manifest::Find(const string& key) const noexcept {
+	const auto iterator = entries_.find(key);
+	return iterator == entries_.end() ? nullptr : &iterator->second;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace batch {
+
+/** \brief Identifies the input and parameters that produced a set of cached outputs. */
+struct ManifestEntry {
+
+	/** \brief The content hash of the input file. */
+	std::uint64_t content_hash;
+
+	/** \brief The hash of the processing parameters (e.g., LOD targets) used to produce the outputs. */
+	std::uint64_t parameters_hash;
+
+	friend bool operator==(const ManifestEntry&, const ManifestEntry&) = default;
+};
+
+/**
+ * \brief A record of previously processed inputs keyed by their path relative to the input directory.
+ * \details The manifest is stored as a text file with one tab-separated entry per line so that it remains readable
+ *          and easy to inspect or edit by hand.
+ */
+class Manifest {
+
+public:
+	/**
+	 * \brief Loads a manifest from a file.
+	 * \param filepath The manifest file to load.
+	 * \return The loaded manifest, or an empty manifest if \p filepath does not exist. Later entries for an input
+	 *         replace earlier ones, and an unterminated last line left by an interrupted \c Append is ignored.
+	 * \throw std::runtime_error Indicates the manifest exists but cannot be read or is malformed.
+	 */
+	[[nodiscard]] static Manifest Load(const std::filesystem::path& filepath);
+
+	/**
+	 * \brief Writes the manifest to a file.
+	 * \param filepath The manifest file to create or replace.
+	 * \throw std::runtime_error Indicates the manifest cannot be written.
+	 * \note The manifest is written to a temporary file and renamed so an interrupted run never leaves a truncated
+	 *       manifest behind.
+	 */
+	void Save(const std::filesystem::path& filepath) const;
+
+	/**
+	 * \brief Appends an entry to a manifest file, which records it without rewriting the manifest.
+	 * \details Entries are appended as each input is processed so a run that is interrupted (e.g., a preempted node)
+	 *          keeps the inputs it completed, and the next run only processes the rest.
+	 * \param filepath The manifest file written by \c Save to append to.
+	 * \param key The input path relative to the input directory.
+	 * \param entry The entry to record.
+	 * \throw std::runtime_error Indicates the entry cannot be written.
+	 */
+	static void Append(const std::filesystem::path& filepath, const std::string& key, const ManifestEntry& entry);
+
+	/**
+	 * \brief Finds the entry for an input.
+	 * \param key The input path relative to the input directory.
+	 * \return The recorded entry, or \c nullptr if the input has not been processed.
+	 */
+	[[nodiscard]] const ManifestEntry* Find(const std::string& key) const noexcept;
+
+	/**
+	 * \brief Records the entry for an input, replacing any existing entry.
+	 * \param key The input path relative to the input directory.
+	 * \param entry The entry to record.
+	 */
+	void Set(const std::string& key, const ManifestEntry& entry) { entries_[key] = entry; }
+
+	/**
+	 * \brief Records every entry of another manifest, replacing existing entries for the same inputs.
+	 * \param manifest The manifest whose entries to record.
+	 */
+	void Update(const Manifest& manifest) {
+		for (const auto& [key, entry] : manifest.entries_) {
+			entries_[key] = entry;
+		}
+	}
+
+private:
+	std::map<std::string, ManifestEntry> entries_;
+};
+}
@@ -0,0 +1,202 @@
+#include "tools/benchmark/benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+
+#include "concurrency/memory_tracker.h"
+#include "geometry/half_edge_mesh.h"
+#include "geometry/mesh_simplifier.h"
+#include "geometry/mesh_welder.h"
+#include "graphics/mesh.h"
+#include "graphics/obj_loader.h"
+#include "tools/benchmark/json.h"
+
+using namespace benchmark;
+using namespace concurrency;
+using namespace geometry;
+using namespace gfx;
+using namespace std;
+
+namespace {
+
+/** \brief Increment when the layout of the results file changes. */
+constexpr auto kResultsVersion = 1;
+
+/** \brief A stream buffer that discards all output. */
+class NullBuffer final : public streambuf {
+protected:
+	int_type overflow(const int_type c) override { return traits_type::not_eof(c); }
+};
+
+/** \brief Discards everything written to \c std::cout while in scope (e.g., mesh statistics printed while sampling). */
+class ScopedOutputSuppression {
+
+public:
+	ScopedOutputSuppression() noexcept : previous_buffer_{cout.rdbuf(&null_buffer_)} {}
+	~ScopedOutputSuppression() { cout.rdbuf(previous_buffer_); }
+
+	ScopedOutputSuppression(const ScopedOutputSuppression&) = delete;
+	ScopedOutputSuppression& operator=(const ScopedOutputSuppression&) = delete;
+
+private:
+	NullBuffer null_buffer_;
+	streambuf* previous_buffer_;
+};
+
+/** \brief Gets the sum of the live bytes and the peak bytes since a profiler was created of every memory category. */
+pair<size_t, size_t> GetTrackedMemory(const MemoryProfiler& memory_profiler) noexcept {
+	size_t live_bytes = 0, peak_bytes = 0;
+	for (size_t i = 0; i < kMemoryCategoryCount; ++i) {
+		const auto memory_usage = memory_profiler.GetMemoryUsage(static_cast<MemoryCategory>(i));
+		live_bytes += memory_usage.live_bytes;
+		peak_bytes += memory_usage.peak_bytes;
+	}
+	return {live_bytes, peak_bytes};
+}
+
+/**
+ * \brief Samples the wall clock time and memory growth of an operation.
+ * \param name The benchmark name.
+ * \param triangles The number of input triangles processed by \p operation.
+ * \param options The benchmark options specifying the number of warmup runs and samples.
+ * \param operation The operation to benchmark.
+ * \return The benchmark result.
+ */
+template <typename Operation>
+Result Sample(string name, const size_t triangles, const Options& options, Operation operation) {
+
+	cout << format("Benchmarking {}\n", name) << flush;
+	Result result{.name = move(name), .triangles = triangles, .seconds = {}, .peak_resident_bytes = 0, .peak_tracked_bytes = 0};
+	result.seconds.reserve(options.repetitions);
+
+	ScopedOutputSuppression output_suppression;
+	for (size_t i = 0; i < options.warmup_repetitions; ++i) {
+		operation();
+	}
+
+	for (size_t i = 0; i < options.repetitions; ++i) {
+		ResetPeakResidentMemory();
+		const auto initial_resident_memory = GetResidentMemory();
+		const MemoryProfiler memory_profiler{name};
+		const auto initial_tracked_bytes = GetTrackedMemory(memory_profiler).first;
+
+		const auto start_time = chrono::steady_clock::now();
+		operation();
+		const chrono::duration<double> duration = chrono::steady_clock::now() - start_time;
+
+		// memory is sampled after the operation released its allocations, which leaves the peaks unaffected
+		const auto resident_memory = GetResidentMemory();
+		const auto tracked_peak_bytes = GetTrackedMemory(memory_profiler).second;
+		result.seconds.push_back(duration.count());
+		result.peak_resident_bytes = max(result.peak_resident_bytes,
+			resident_memory.peak_bytes - min(resident_memory.peak_bytes, initial_resident_memory.current_bytes));
+		result.peak_tracked_bytes = max(result.peak_tracked_bytes,
+			tracked_peak_bytes - min(tracked_peak_bytes, initial_tracked_bytes));
+	}
+
+	return result;
+}
+
+/** \brief Gets the number of triangles in a mesh. */
+size_t GetTriangleCount(const Mesh& mesh) noexcept {
+	return mesh.GetIndices().size() / 3;
+}
+}
+
+vector<Result> benchmark::Run(const Options& options) {
+
+	if (options.models.empty()) throw invalid_argument{"No models to benchmark"};
+	if (options.repetitions == 0) throw invalid_argument{"At least one repetition is required"};
+	for (const auto rate : options.rates) {
+		if (rate < 0.f || rate >= 1.f) throw invalid_argument{format("Simplification rate {} is not in [0, 1)", rate)};
+	}
+
+	vector<Result> results;
+	for (const auto& model : options.models) {
+		const auto model_filepath = model.string();
+		const auto model_name = model.generic_string();
+
+		const auto loaded_mesh = [&] {
+			ScopedOutputSuppression output_suppression;
+			return obj_loader::LoadMesh(model_filepath);
+		}();
+		results.push_back(Sample(format("load {}", model_name), GetTriangleCount(loaded_mesh), options, [&] {
+			return obj_loader::LoadMesh(model_filepath);
+		}));
+
+		const auto welded_mesh = mesh::Weld(loaded_mesh);
+		results.push_back(Sample(format("half-edge mesh {}", model_name), GetTriangleCount(welded_mesh), options, [&] {
+			const HalfEdgeMesh half_edge_mesh{welded_mesh};
+			return half_edge_mesh.faces().size();
+		}));
+
+		for (const auto rate : options.rates) {
+			results.push_back(Sample(format("simplify {} {}", model_name, rate), GetTriangleCount(welded_mesh), options, [&] {
+				return mesh::Simplify(welded_mesh, rate);
+			}));
+		}
+	}
+
+	return results;
+}
+
+void benchmark::WriteResults(const filesystem::path& filepath, const vector<Result>& results) {
+
+	ofstream stream{filepath, ios::trunc};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+
+	stream << format("{{\n  \"version\": {},\n  \"benchmarks\": [", kResultsVersion);
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& [name, triangles, seconds, peak_resident_bytes, peak_tracked_bytes] = results[i];
+		stream << format("{}\n    {{\n      \"name\": {},\n      \"triangles\": {},\n      \"seconds\": [",
+			i == 0 ? "" : ",", json::Quote(name), triangles);
+		for (size_t j = 0; j < seconds.size(); ++j) {
+			stream << format("{}{}", j == 0 ? "" : ", ", seconds[j]);
+		}
+		stream << format("],\n      \"peak_resident_bytes\": {},\n      \"peak_tracked_bytes\": {}\n    }}",
+			peak_resident_bytes, peak_tracked_bytes);
+	}
+	stream << "\n  ]\n}\n";
+
+	if (!stream.flush()) throw runtime_error{"Failed to write " + filepath.string()};
+}
+
+vector<Result> benchmark::ReadResults(const filesystem::path& filepath) {
+
+	ifstream stream{filepath};
+	if (!stream) throw runtime_error{"Unable to open " + filepath.string()};
+	stringstream text;
+	text << stream.rdbuf();
+
+	try {
+		const auto document = json::Parse(text.str());
+		if (const auto version = document["version"].As<double>(); version != kResultsVersion) {
+			throw runtime_error{format("Unsupported results version {}", version)};
+		}
+
+		vector<Result> results;
+		for (const auto& entry : document["benchmarks"].As<json::Value::Array>()) {
+			auto& result = results.emplace_back(Result{
+				.name = entry["name"].As<string>(),
+				.triangles = static_cast<size_t>(entry["triangles"].As<double>()),
+				.seconds = {},
+				.peak_resident_bytes = static_cast<size_t>(entry["peak_resident_bytes"].As<double>()),
+				.peak_tracked_bytes = static_cast<size_t>(entry["peak_tracked_bytes"].As<double>())
+			});
+			for (const auto& seconds : entry["seconds"].As<json::Value::Array>()) {
+				result.seconds.push_back(seconds.As<double>());
+			}
+			if (result.seconds.empty()) throw runtime_error{format("Benchmark {} has no samples", result.name)};
+		}
+		return results;
+
+	} catch (const runtime_error& e) {
+		throw runtime_error{format("Unable to read benchmark results from {}: {}", filepath.string(), e.what())};
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+/** \brief Options that control a benchmark run. */
+struct Options {
+
+	/** \brief The .obj models to benchmark. */
+	std::vector<std::filesystem::path> models;
+
+	/** \brief The simplification rates to benchmark each model with. */
+	std::vector<float> rates;
+
+	/** \brief The number of timed samples taken of each benchmark. */
+	std::size_t repetitions = 10;
+
+	/** \brief The number of untimed runs of each benchmark before sampling (e.g., to warm caches and the allocator). */
+	std::size_t warmup_repetitions = 1;
+};
+
+/** \brief The samples taken of a benchmark. */
+struct Result {
+
+	/** \brief A name identifying the benchmark across runs (e.g., <tt>simplify bunny.obj 0.5</tt>). */
+	std::string name;
+
+	/** \brief The number of input triangles processed by each sample. */
+	std::size_t triangles = 0;
+
+	/** \brief The wall clock time of each sample in seconds. */
+	std::vector<double> seconds;
+
+	/**
+	 * \brief The largest growth of the resident set size over the resident set size at the start of a sample.
+	 * \details Where the peak resident set size cannot be reset between samples (e.g., Windows), memory already resident
+	 *          from earlier benchmarks is not counted, so compare this only between runs on the same platform.
+	 */
+	std::size_t peak_resident_bytes = 0;
+
+	/** \brief The largest growth of the tracked bytes of every memory category during a sample (see \c concurrency::MemoryCategory). */
+	std::size_t peak_tracked_bytes = 0;
+};
+
+/**
+ * \brief Benchmarks loading, half-edge mesh construction, and simplification of a set of models.
+ * \details Each model is benchmarked with \c gfx::obj_loader::LoadMesh, with \c geometry::HalfEdgeMesh construction
+ *          from the welded mesh, and with \c geometry::mesh::Simplify of the welded mesh once per rate. Output printed by
+ *          the benchmarked functions is suppressed while sampling.
+ * \param options The benchmark options.
+ * \return The results of every benchmark in the order they were run.
+ * \throw std::invalid_argument Indicates \p options are invalid.
+ * \throw std::runtime_error Indicates a model cannot be loaded.
+ */
+std::vector<Result> Run(const Options& options);
+
+/**
+ * \brief Writes benchmark results to a JSON file.
+ * \param filepath The file to write.
+ * \param results The results to write.
+ * \throw std::runtime_error Indicates the file cannot be written.
+ */
+void WriteResults(const std::filesystem::path& filepath, const std::vector<Result>& results);
+
+/**
+ * \brief Reads benchmark results from a JSON file written by \c WriteResults.
+ * \param filepath The file to read.
+ * \return The results in the file.
+ * \throw std::runtime_error Indicates the file cannot be read or is not a benchmark results file.
+ */
+std::vector<Result> ReadResults(const std::filesystem::path& filepath);
+}
@@ -0,0 +1,171 @@
+#include "tools/benchmark/comparison.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace benchmark;
+using namespace std;
+
+namespace {
+
+/** \brief Scales the median absolute deviation of normally distributed samples to their standard deviation. */
+constexpr auto kNormalScaleFactor = 1.4826;
+
+/** \brief The standard error of the median of normally distributed samples relative to that of their mean (sqrt(pi/2)). */
+constexpr auto kMedianEfficiencyFactor = 1.2533;
+
+/** \brief Computes the median of a set of samples, reordering them. */
+double ComputeMedian(vector<double>& samples) {
+	const auto middle = samples.begin() + samples.size() / 2;
+	ranges::nth_element(samples, middle);
+	if (samples.size() % 2 != 0) return *middle;
+	return (*middle + *ranges::max_element(samples.begin(), middle)) / 2.;
+}
+
+/** \brief Determines whether the peak memory of a candidate exceeds the peak memory of a baseline beyond the thresholds. */
+bool IsMemoryRegression(const size_t baseline_bytes, const size_t candidate_bytes, const Thresholds& thresholds) noexcept {
+	return candidate_bytes > baseline_bytes + thresholds.memory_bytes
+	       && static_cast<double>(candidate_bytes) > static_cast<double>(baseline_bytes) * (1. + thresholds.memory_change);
+}
+
+/** \brief Formats a number of triangles per second. */
+string FormatThroughput(const double throughput) {
+	if (throughput >= 1e6) return format("{:.2f} M/s", throughput / 1e6);
+	if (throughput >= 1e3) return format("{:.2f} k/s", throughput / 1e3);
+	return format("{:.2f} /s", throughput);
+}
+
+/** \brief Formats the growth of peak memory between two runs. */
+string FormatMemory(const size_t baseline_bytes, const size_t candidate_bytes) {
+	constexpr auto kMebibyte = static_cast<double>(1 << 20);
+	const auto baseline_mebibytes = static_cast<double>(baseline_bytes) / kMebibyte;
+	const auto candidate_mebibytes = static_cast<double>(candidate_bytes) / kMebibyte;
+	if (baseline_bytes == 0) return format("{:.1f} -> {:.1f} MiB", baseline_mebibytes, candidate_mebibytes);
+	return format("{:.1f} -> {:.1f} MiB ({:+.1f}%)",
+		baseline_mebibytes,
+		candidate_mebibytes,
+		(candidate_mebibytes / baseline_mebibytes - 1.) * 100.);
+}
+
+/** \brief Gets a human-readable description of a benchmark verdict. */
+string_view GetName(const Verdict verdict) noexcept {
+	switch (verdict) {
+		case Verdict::kUnchanged: return "unchanged";
+		case Verdict::kFaster: return "faster";
+		case Verdict::kSlower: return "SLOWER";
+	}
+	return "unknown";
+}
+}
+
+double Statistics::standard_error(const size_t sample_count) const noexcept {
+	return kMedianEfficiencyFactor * kNormalScaleFactor * median_absolute_deviation / sqrt(static_cast<double>(sample_count));
+}
+
+Statistics benchmark::ComputeStatistics(const span<const double> samples) {
+	if (samples.empty()) throw invalid_argument{"Statistics require at least one sample"};
+
+	vector<double> values{samples.begin(), samples.end()};
+	const auto median = ComputeMedian(values);
+	for (auto& value : values) {
+		value = abs(value - median);
+	}
+	return Statistics{.median = median, .median_absolute_deviation = ComputeMedian(values)};
+}
+
+double Comparison::speedup() const noexcept {
+	return baseline_seconds.median / candidate_seconds.median;
+}
+
+Report benchmark::Compare(const vector<Result>& baseline, const vector<Result>& candidate, const Thresholds& thresholds) {
+
+	unordered_map<string_view, const Result*> candidate_results;
+	for (const auto& result : candidate) {
+		candidate_results.emplace(result.name, &result);
+	}
+
+	Report report;
+	for (const auto& baseline_result : baseline) {
+		const auto iterator = candidate_results.find(baseline_result.name);
+		if (iterator == candidate_results.end()) {
+			report.unmatched.push_back(baseline_result.name);
+			continue;
+		}
+		const auto& candidate_result = *iterator->second;
+		candidate_results.erase(iterator);
+
+		if (baseline_result.triangles != candidate_result.triangles) {
+			throw invalid_argument{format("Benchmark {} processed {} triangles in the baseline and {} in the candidate",
+				baseline_result.name, baseline_result.triangles, candidate_result.triangles)};
+		}
+
+		auto& comparison = report.comparisons.emplace_back(Comparison{
+			.name = baseline_result.name,
+			.baseline_seconds = ComputeStatistics(baseline_result.seconds),
+			.candidate_seconds = ComputeStatistics(candidate_result.seconds),
+			.baseline_peak_resident_bytes = baseline_result.peak_resident_bytes,
+			.candidate_peak_resident_bytes = candidate_result.peak_resident_bytes,
+			.baseline_peak_tracked_bytes = baseline_result.peak_tracked_bytes,
+			.candidate_peak_tracked_bytes = candidate_result.peak_tracked_bytes
+		});
+
+		const auto baseline_median = comparison.baseline_seconds.median;
+		const auto candidate_median = comparison.candidate_seconds.median;
+		comparison.baseline_throughput = static_cast<double>(baseline_result.triangles) / baseline_median;
+		comparison.candidate_throughput = static_cast<double>(candidate_result.triangles) / candidate_median;
+
+		// samples without any spread (e.g., timer granularity) make every difference significant, leaving only the relative threshold
+		const auto difference = candidate_median - baseline_median;
+		const auto standard_error = hypot(comparison.baseline_seconds.standard_error(baseline_result.seconds.size()),
+		                                  comparison.candidate_seconds.standard_error(candidate_result.seconds.size()));
+		comparison.z_score = standard_error > 0. ? difference / standard_error
+		                    : difference != 0. ? copysign(numeric_limits<double>::infinity(), difference) : 0.;
+		if (abs(comparison.z_score) >= thresholds.z_score && abs(difference) >= thresholds.time_change * baseline_median) {
+			comparison.verdict = difference > 0. ? Verdict::kSlower : Verdict::kFaster;
+		}
+
+		comparison.memory_regression =
+			IsMemoryRegression(baseline_result.peak_resident_bytes, candidate_result.peak_resident_bytes, thresholds)
+			|| IsMemoryRegression(baseline_result.peak_tracked_bytes, candidate_result.peak_tracked_bytes, thresholds);
+	}
+
+	for (const auto& result : candidate) {
+		if (candidate_results.contains(result.name)) {
+			report.unmatched.push_back(result.name);
+		}
+	}
+
+	if (report.comparisons.empty()) throw invalid_argument{"The baseline and candidate have no benchmarks in common"};
+	return report;
+}
+
+string Report::Format() const {
+
+	auto text = format("{:<48} {:>12} {:>12} {:>8} {:>7} {:<10} {:<30} {}\n",
+		"benchmark", "baseline", "candidate", "speedup", "z", "verdict", "peak resident", "peak tracked");
+
+	size_t regression_count = 0;
+	for (const auto& comparison : comparisons) {
+		text += format("{:<48} {:>12} {:>12} {:>7.3f}x {:>7.1f} {:<10} {:<30} {}{}\n",
+			comparison.name,
+			FormatThroughput(comparison.baseline_throughput),
+			FormatThroughput(comparison.candidate_throughput),
+			comparison.speedup(),
+			comparison.z_score,
+			GetName(comparison.verdict),
+			FormatMemory(comparison.baseline_peak_resident_bytes, comparison.candidate_peak_resident_bytes),
+			FormatMemory(comparison.baseline_peak_tracked_bytes, comparison.candidate_peak_tracked_bytes),
+			comparison.memory_regression ? "  MORE MEMORY" : "");
+		regression_count += comparison.regression();
+	}
+
+	for (const auto& name : unmatched) {
+		text += format("{:<48} not present in both runs\n", name);
+	}
+
+	return text += format("{} of {} benchmarks regressed\n", regression_count, comparisons.size());
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tools/benchmark/benchmark.h"
+
+namespace benchmark {
+
+/** \brief Robust statistics of a set of samples. */
+struct Statistics {
+
+	/** \brief The median of the samples. */
+	double median = 0.;
+
+	/** \brief The median absolute deviation of the samples from their median. */
+	double median_absolute_deviation = 0.;
+
+	/**
+	 * \brief Gets the standard error of the median.
+	 * \details Estimated from the median absolute deviation, which is scaled to the standard deviation of normally
+	 *          distributed samples, so a few outliers (e.g., a sample preempted by another process) barely affect it.
+	 */
+	[[nodiscard]] double standard_error(std::size_t sample_count) const noexcept;
+};
+
+/**
+ * \brief Computes the median and median absolute deviation of a set of samples.
+ * \param samples The samples, which must not be empty.
+ * \return The statistics of \p samples.
+ */
+[[nodiscard]] Statistics ComputeStatistics(std::span<const double> samples);
+
+/** \brief Thresholds that decide when a difference between two runs is reported as a change. */
+struct Thresholds {
+
+	/** \brief The smallest difference of medians in standard errors considered significant. */
+	double z_score = 3.;
+
+	/** \brief The smallest relative difference of medians reported as a change, however significant. */
+	double time_change = .02;
+
+	/** \brief The smallest relative growth of peak memory reported as a regression. */
+	double memory_change = .05;
+
+	/** \brief The smallest absolute growth of peak memory reported as a regression (e.g., to ignore page granularity). */
+	std::size_t memory_bytes = std::size_t{1} << 20;
+};
+
+/** \brief The outcome of comparing a benchmark between a baseline and a candidate run. */
+enum class Verdict { kUnchanged, kFaster, kSlower };
+
+/** \brief A benchmark compared between a baseline and a candidate run. */
+struct Comparison {
+	std::string name;
+
+	/** \brief Statistics of the sample times of the baseline and candidate in seconds. */
+	Statistics baseline_seconds, candidate_seconds;
+
+	/** \brief The number of triangles processed per second at the median time of the baseline and candidate. */
+	double baseline_throughput = 0., candidate_throughput = 0.;
+
+	/** \brief The difference of median times in standard errors, positive if the candidate is slower. */
+	double z_score = 0.;
+
+	/** \brief Whether the candidate is significantly faster or slower than the baseline. */
+	Verdict verdict = Verdict::kUnchanged;
+
+	/** \brief The peak resident memory growth and tracked memory growth of the baseline and candidate. */
+	std::size_t baseline_peak_resident_bytes = 0, candidate_peak_resident_bytes = 0;
+	std::size_t baseline_peak_tracked_bytes = 0, candidate_peak_tracked_bytes = 0;
+
+	/** \brief Whether the peak resident or tracked memory of the candidate exceeds the baseline beyond the thresholds. */
+	bool memory_regression = false;
+
+	/** \brief Gets the ratio of the median baseline time to the median candidate time, above one if the candidate is faster. */
+	[[nodiscard]] double speedup() const noexcept;
+
+	/** \brief Gets whether the candidate is significantly slower or uses more memory than the baseline. */
+	[[nodiscard]] bool regression() const noexcept { return verdict == Verdict::kSlower || memory_regression; }
+};
+
+/** \brief The comparison of two benchmark runs. */
+struct Report {
+
+	/** \brief The comparisons of benchmarks present in both runs in baseline order. */
+	std::vector<Comparison> comparisons;
+
+	/** \brief The names of benchmarks present in only one of the runs, which cannot be compared. */
+	std::vector<std::string> unmatched;
+
+	/** \brief Formats the report as a table of throughput, speedup, and peak memory per benchmark. */
+	[[nodiscard]] std::string Format() const;
+};
+
+/**
+ * \brief Compares two benchmark runs.
+ * \param baseline The results of the baseline run (e.g., the library version currently rolled out).
+ * \param candidate The results of the candidate run.
+ * \param thresholds The thresholds that decide when differences are reported as changes.
+ * \return The comparison of every benchmark present in both runs.
+ * \throw std::invalid_argument Indicates the runs have no benchmarks in common or compare different models.
+ */
+[[nodiscard]] Report Compare(const std::vector<Result>& baseline, const std::vector<Result>& candidate, const Thresholds& thresholds);
+}
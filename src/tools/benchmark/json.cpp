@@ -0,0 +1,163 @@
+#include "tools/benchmark/json.h"
+
+#include <cctype>
+#include <charconv>
+#include <format>
+
+using namespace benchmark;
+using namespace std;
+
+namespace {
+
+/** \brief A recursive descent parser for the subset of JSON written by the benchmark tool (no \\u escapes). */
+class Parser {
+
+public:
+	explicit Parser(const string_view text) noexcept : text_{text} {}
+
+	json::Value ParseDocument() {
+		auto value = ParseValue();
+		SkipWhitespace();
+		if (position_ != text_.size()) throw Error("Unexpected trailing characters");
+		return value;
+	}
+
+private:
+	runtime_error Error(const string_view message) const {
+		return runtime_error{format("Invalid JSON at offset {}: {}", position_, message)};
+	}
+
+	void SkipWhitespace() noexcept {
+		while (position_ < text_.size() && isspace(static_cast<unsigned char>(text_[position_]))) ++position_;
+	}
+
+	char Peek() {
+		SkipWhitespace();
+		if (position_ == text_.size()) throw Error("Unexpected end of document");
+		return text_[position_];
+	}
+
+	void Expect(const char c) {
+		if (Peek() != c) throw Error(format("Expected '{}'", c));
+		++position_;
+	}
+
+	bool Consume(const string_view literal) {
+		if (!text_.substr(position_).starts_with(literal)) return false;
+		position_ += literal.size();
+		return true;
+	}
+
+	json::Value ParseValue() {
+		switch (Peek()) {
+			case '{': return json::Value{ParseObject()};
+			case '[': return json::Value{ParseArray()};
+			case '"': return json::Value{ParseString()};
+			default: break;
+		}
+		if (Consume("null")) return json::Value{nullptr};
+		if (Consume("true")) return json::Value{true};
+		if (Consume("false")) return json::Value{false};
+		return json::Value{ParseNumber()};
+	}
+
+	json::Value::Object ParseObject() {
+		json::Value::Object object;
+		Expect('{');
+		if (Peek() == '}') {
+			++position_;
+			return object;
+		}
+		for (;;) {
+			auto key = ParseString();
+			Expect(':');
+			object.insert_or_assign(move(key), ParseValue());
+			if (Peek() != ',') break;
+			++position_;
+		}
+		Expect('}');
+		return object;
+	}
+
+	json::Value::Array ParseArray() {
+		json::Value::Array array;
+		Expect('[');
+		if (Peek() == ']') {
+			++position_;
+			return array;
+		}
+		for (;;) {
+			array.push_back(ParseValue());
+			if (Peek() != ',') break;
+			++position_;
+		}
+		Expect(']');
+		return array;
+	}
+
+	string ParseString() {
+		Expect('"');
+		string value;
+		while (position_ < text_.size() && text_[position_] != '"') {
+			auto c = text_[position_++];
+			if (c == '\\') {
+				if (position_ == text_.size()) break;
+				switch (c = text_[position_++]) {
+					case 'n': c = '\n'; break;
+					case 't': c = '\t'; break;
+					case 'r': c = '\r'; break;
+					case 'b': c = '\b'; break;
+					case 'f': c = '\f'; break;
+					case '"': case '\\': case '/': break;
+					default: throw Error(format("Unsupported escape sequence \\{}", c));
+				}
+			}
+			value += c;
+		}
+		if (position_ == text_.size()) throw Error("Unterminated string");
+		++position_;
+		return value;
+	}
+
+	double ParseNumber() {
+		double value = 0;
+		const auto* const begin = text_.data() + position_;
+		const auto [end, error] = from_chars(begin, text_.data() + text_.size(), value);
+		if (error != errc{}) throw Error("Expected a value");
+		position_ += end - begin;
+		return value;
+	}
+
+	string_view text_;
+	size_t position_ = 0;
+};
+}
+
+const json::Value& json::Value::operator[](const string_view key) const {
+	const auto& object = As<Object>();
+	const auto iterator = object.find(key);
+	if (iterator == object.end()) throw runtime_error{format("Missing JSON member {}", key)};
+	return iterator->second;
+}
+
+json::Value json::Parse(const string_view text) {
+	return Parser{text}.ParseDocument();
+}
+
+string json::Quote(const string_view text) {
+	string quoted{'"'};
+	for (const auto c : text) {
+		switch (c) {
+			case '"': quoted += "\\\""; break;
+			case '\\': quoted += "\\\\"; break;
+			case '\n': quoted += "\\n"; break;
+			case '\t': quoted += "\\t"; break;
+			case '\r': quoted += "\\r"; break;
+			default:
+				// the remaining control characters never occur in benchmark names, drop rather than emit \u escapes
+				if (static_cast<unsigned char>(c) >= 0x20) quoted += c;
+				break;
+		}
+	}
+	return quoted += '"';
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace benchmark::json {
+
+/** \brief A parsed JSON value. */
+struct Value {
+	using Array = std::vector<Value>;
+	using Object = std::map<std::string, Value, std::less<>>;
+
+	std::variant<std::nullptr_t, bool, double, std::string, Array, Object> data;
+
+	/**
+	 * \brief Gets the member of an object.
+	 * \param key The member name.
+	 * \return The value of the member named \p key.
+	 * \throw std::runtime_error Indicates this value is not an object or has no member named \p key.
+	 */
+	[[nodiscard]] const Value& operator[](std::string_view key) const;
+
+	/**
+	 * \brief Gets this value as a specific type.
+	 * \tparam T The expected type, one of \c bool, \c double, \c std::string, \c Array, or \c Object.
+	 * \throw std::runtime_error Indicates this value is of another type.
+	 */
+	template <typename T>
+	[[nodiscard]] const T& As() const;
+};
+
+/**
+ * \brief Parses a JSON document.
+ * \param text The document to parse.
+ * \return The root value of the document.
+ * \throw std::runtime_error Indicates \p text is not valid JSON.
+ */
+[[nodiscard]] Value Parse(std::string_view text);
+
+/**
+ * \brief Formats a string as a JSON string literal.
+ * \param text The string to quote.
+ * \return \p text in double quotes with quotes, backslashes, and control characters escaped.
+ */
+[[nodiscard]] std::string Quote(std::string_view text);
+
+template <typename T>
+const T& Value::As() const {
+	if (const auto* const value = std::get_if<T>(&data)) return *value;
+	throw std::runtime_error{"Unexpected JSON value type"};
+}
+}
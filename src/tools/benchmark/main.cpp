@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "tools/benchmark/benchmark.h"
+#include "tools/benchmark/comparison.h"
+
+using namespace benchmark;
+using namespace std;
+
+namespace {
+
+constexpr auto kUsage =
+	"Usage: MeshSimplificationBenchmark run <results.json> <model.obj>... [options]\n"
+	"       MeshSimplificationBenchmark compare <baseline.json> <candidate.json> [options]\n"
+	"\n"
+	"run times loading, half-edge mesh construction, and simplification of each model and writes the samples and peak\n"
+	"memory to <results.json>. compare reports the throughput and peak memory of every benchmark in both runs and exits\n"
+	"with a failure status if the candidate is significantly slower or uses more memory than the baseline.\n"
+	"\n"
+	"Run options:\n"
+	"  --rate <rate>           Benchmarks simplification removing <rate> (0-1) of triangles. Defaults to .5\n"
+	"  --repetitions <count>   The number of timed samples of each benchmark. Defaults to 10\n"
+	"  --warmup <count>        The number of untimed runs of each benchmark before sampling. Defaults to 1\n"
+	"\n"
+	"Compare options:\n"
+	"  --z-score <score>       The smallest difference of medians in standard errors considered significant. Defaults to 3\n"
+	"  --time-change <ratio>   The smallest relative time difference reported as a change. Defaults to .02\n"
+	"  --memory-change <ratio> The smallest relative peak memory growth reported as a regression. Defaults to .05\n";
+
+/** \brief Parses the arguments of the run command and writes the results. */
+int RunBenchmarks(const int argc, char* argv[]) {
+
+	if (argc < 4) throw invalid_argument{"Missing results file or models"};
+
+	Options options;
+	for (auto i = 3; i < argc; ++i) {
+		const string_view argument{argv[i]};
+		if (!argument.starts_with("--")) {
+			options.models.emplace_back(argument);
+			continue;
+		}
+		if (i + 1 >= argc) throw invalid_argument{format("Missing value for {}", argument)};
+		const string value{argv[++i]};
+
+		if (argument == "--rate") {
+			options.rates.push_back(stof(value));
+		} else if (argument == "--repetitions") {
+			options.repetitions = stoul(value);
+		} else if (argument == "--warmup") {
+			options.warmup_repetitions = stoul(value);
+		} else {
+			throw invalid_argument{format("Unknown option {}", argument)};
+		}
+	}
+
+	if (options.rates.empty()) {
+		options.rates = {.5f};
+	}
+
+	const auto results = Run(options);
+	WriteResults(argv[2], results);
+
+	for (const auto& result : results) {
+		const auto [median, median_absolute_deviation] = ComputeStatistics(result.seconds);
+		cout << format("{:<48} median {:.4f} s +/- {:.4f} s  {:.0f} triangles/s  peak resident {:.1f} MiB\n",
+			result.name,
+			median,
+			median_absolute_deviation,
+			static_cast<double>(result.triangles) / median,
+			static_cast<double>(result.peak_resident_bytes) / (1 << 20));
+	}
+	return EXIT_SUCCESS;
+}
+
+/** \brief Parses the arguments of the compare command and prints the comparison. */
+int CompareBenchmarks(const int argc, char* argv[]) {
+
+	if (argc < 4) throw invalid_argument{"Missing baseline or candidate results file"};
+
+	Thresholds thresholds;
+	for (auto i = 4; i < argc; ++i) {
+		const string_view option{argv[i]};
+		if (i + 1 >= argc) throw invalid_argument{format("Missing value for {}", option)};
+		const string value{argv[++i]};
+
+		if (option == "--z-score") {
+			thresholds.z_score = stod(value);
+		} else if (option == "--time-change") {
+			thresholds.time_change = stod(value);
+		} else if (option == "--memory-change") {
+			thresholds.memory_change = stod(value);
+		} else {
+			throw invalid_argument{format("Unknown option {}", option)};
+		}
+	}
+
+	const auto report = Compare(ReadResults(argv[2]), ReadResults(argv[3]), thresholds);
+	cout << report.Format();
+	return ranges::any_of(report.comparisons, &Comparison::regression) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+}
+
+int main(const int argc, char* argv[]) {
+
+	if (argc < 2) {
+		cerr << kUsage;
+		return EXIT_FAILURE;
+	}
+
+	try {
+		const string_view command{argv[1]};
+		if (command == "run") return RunBenchmarks(argc, argv);
+		if (command == "compare") return CompareBenchmarks(argc, argv);
+		throw invalid_argument{format("Unknown command {}", command)};
+
+	} catch (const exception& e) {
+		cerr << e.what() << endl << endl << kUsage;
+		return EXIT_FAILURE;
+	}
+}
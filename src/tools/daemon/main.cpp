@@ -0,0 +1,72 @@
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "tools/daemon/server.h"
+
+using namespace service;
+using namespace std;
+
+namespace {
+
+constexpr auto kUsage =
+	"Usage: MeshSimplificationDaemon <socket-path> [options]\n"
+	"\n"
+	"Serves mesh simplification requests over a Unix domain socket until interrupted or asked to shut down.\n"
+	"\n"
+	"Options:\n"
+	"  --jobs <count>          The number of requests simplified concurrently. Defaults to the hardware threads\n"
+	"  --cache-size <MiB>      The memory used to keep recently loaded meshes. Defaults to 1024\n";
+
+Server* gServer = nullptr;
+}
+
+int main(const int argc, char* argv[]) {
+
+	if (argc < 2) {
+		cerr << kUsage;
+		return EXIT_FAILURE;
+	}
+
+	try {
+		ServerOptions options{
+			.socket_path = argv[1],
+			.job_count = max(1u, thread::hardware_concurrency()),
+			.cache_capacity = size_t{1024} << 20
+		};
+
+		for (auto i = 2; i < argc; ++i) {
+			const string_view option{argv[i]};
+			if (i + 1 >= argc) throw invalid_argument{format("Missing value for {}", option)};
+			const string value{argv[++i]};
+
+			if (option == "--jobs") {
+				options.job_count = max<size_t>(1, stoul(value));
+			} else if (option == "--cache-size") {
+				options.cache_capacity = static_cast<size_t>(stoull(value)) << 20;
+			} else {
+				throw invalid_argument{format("Unknown option {}", option)};
+			}
+		}
+
+		Server server{options};
+		gServer = &server;
+
+		const auto stop = [](int) { if (gServer) gServer->Stop(); };
+		signal(SIGINT, stop);
+		signal(SIGTERM, stop);
+
+		server.Run();
+		gServer = nullptr;
+		return EXIT_SUCCESS;
+
+	} catch (const exception& e) {
+		cerr << e.what() << endl << endl << kUsage;
+		return EXIT_FAILURE;
+	}
+}
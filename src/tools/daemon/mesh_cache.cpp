@@ -0,0 +1,106 @@
+#include "tools/daemon/mesh_cache.h"
+
+#include "geometry/mesh_welder.h"
+#include "graphics/mesh.h"
+#include "graphics/obj_loader.h"
+
+using namespace geometry;
+using namespace gfx;
+using namespace service;
+using namespace std;
+
+namespace {
+
+/** \brief Gets the number of bytes of vertex and index data held by a mesh. */
+size_t GetSize(const Mesh& mesh) noexcept {
+	return mesh.GetPositions().size() * sizeof(glm::vec3)
+		+ mesh.GetTexture_coordinates().size() * sizeof(glm::vec2)
+		+ mesh.GetNormals().size() * sizeof(glm::vec3)
+		+ mesh.GetIndices().size() * sizeof(GLuint);
+}
+}
+
+shared_ptr<const Mesh> MeshCache::Get(const filesystem::path& filepath) {
+
+	const auto key = filesystem::absolute(filepath).lexically_normal().string();
+	const auto last_write_time = filesystem::last_write_time(filepath);
+	const auto file_size = filesystem::file_size(filepath);
+
+	shared_future<shared_ptr<const Mesh>> cached_mesh;
+	promise<shared_ptr<const Mesh>> mesh_promise;
+	size_t load_id = 0;
+	{
+		scoped_lock lock{mutex_};
+		if (const auto iterator = entries_.find(key); iterator != entries_.end()) {
+			if (auto& entry = iterator->second; entry.last_write_time == last_write_time && entry.file_size == file_size) {
+				++hits_;
+				lru_keys_.splice(lru_keys_.begin(), lru_keys_, entry.lru_position);
+				cached_mesh = entry.mesh;
+			} else {
+				size_ -= entry.size;
+				lru_keys_.erase(entry.lru_position);
+				entries_.erase(iterator);
+			}
+		}
+
+		if (!cached_mesh.valid()) {
+			++misses_;
+			load_id = ++next_load_id_;
+			lru_keys_.push_front(key);
+			entries_.emplace(key, Entry{
+				.last_write_time = last_write_time,
+				.file_size = file_size,
+				.mesh = mesh_promise.get_future().share(),
+				.size = 0,
+				.load_id = load_id,
+				.lru_position = lru_keys_.begin()
+			});
+		}
+	}
+
+	if (cached_mesh.valid()) return cached_mesh.get();
+
+	// load outside the lock so requests for other meshes are not blocked
+	shared_ptr<const Mesh> mesh;
+	try {
+		mesh = make_shared<const Mesh>(mesh::Weld(obj_loader::LoadMesh(filepath.string())));
+		mesh_promise.set_value(mesh);
+	} catch (...) {
+		mesh_promise.set_exception(current_exception());
+		scoped_lock lock{mutex_};
+		if (const auto iterator = entries_.find(key); iterator != entries_.end() && iterator->second.load_id == load_id) {
+			lru_keys_.erase(iterator->second.lru_position);
+			entries_.erase(iterator);
+		}
+		throw;
+	}
+
+	scoped_lock lock{mutex_};
+	if (const auto iterator = entries_.find(key); iterator != entries_.end() && iterator->second.load_id == load_id) {
+		iterator->second.size = GetSize(*mesh);
+		size_ += iterator->second.size;
+		Evict();
+	}
+	return mesh;
+}
+
+MeshCache::Statistics MeshCache::GetStatistics() const {
+	scoped_lock lock{mutex_};
+	return Statistics{.hits = hits_, .misses = misses_, .size = size_};
+}
+
+void MeshCache::Evict() {
+	if (lru_keys_.empty()) return;
+
+	// entries that are still loading have no size yet and are skipped
+	for (auto iterator = prev(lru_keys_.end()); size_ > capacity_ && iterator != lru_keys_.begin();) {
+		const auto entry = entries_.find(*iterator);
+		const auto previous = prev(iterator);
+		if (entry->second.size > 0) {
+			size_ -= entry->second.size;
+			entries_.erase(entry);
+			lru_keys_.erase(iterator);
+		}
+		iterator = previous;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gfx {
+class Mesh;
+}
+
+namespace service {
+
+/**
+ * \brief A thread-safe least-recently-used cache of welded meshes loaded from disk.
+ * \details Entries are keyed by filepath and validated against the file size and last write time, so a model that is
+ *          re-exported is reloaded on its next request. Concurrent requests for a model that is still loading wait for
+ *          the same load instead of loading it again.
+ */
+class MeshCache {
+
+public:
+	/** \brief Cache usage counters. */
+	struct Statistics {
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t size = 0;
+	};
+
+	/**
+	 * \brief Initializes a mesh cache.
+	 * \param capacity The number of bytes of mesh data to retain. The most recently used mesh is always retained.
+	 */
+	explicit MeshCache(std::size_t capacity) noexcept : capacity_{capacity} {}
+
+	/**
+	 * \brief Gets a welded mesh, loading it if it is not cached or the file changed since it was cached.
+	 * \param filepath The .obj file to load.
+	 * \return The welded mesh.
+	 * \throw std::runtime_error Indicates the file cannot be loaded.
+	 */
+	[[nodiscard]] std::shared_ptr<const gfx::Mesh> Get(const std::filesystem::path& filepath);
+
+	/** \brief Gets the cache usage counters. */
+	[[nodiscard]] Statistics GetStatistics() const;
+
+private:
+	struct Entry {
+		std::filesystem::file_time_type last_write_time;
+		std::uintmax_t file_size;
+		std::shared_future<std::shared_ptr<const gfx::Mesh>> mesh;
+		std::size_t size;
+		std::size_t load_id;
+		std::list<std::string>::iterator lru_position;
+	};
+
+	void Evict();
+
+	std::size_t capacity_;
+	std::size_t size_ = 0;
+	std::size_t hits_ = 0;
+	std::size_t misses_ = 0;
+	std::size_t next_load_id_ = 0;
+	std::list<std::string> lru_keys_;
+	std::unordered_map<std::string, Entry> entries_;
+	mutable std::mutex mutex_;
+};
+}
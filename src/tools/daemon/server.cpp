@@ -0,0 +1,292 @@
+#include "tools/daemon/server.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "geometry/mesh_simplifier.h"
+#include "graphics/mesh.h"
+#include "graphics/obj_writer.h"
+#include "io/mapped_mesh.h"
+
+using namespace concurrency;
+using namespace geometry;
+using namespace gfx;
+using namespace io;
+using namespace service;
+using namespace std;
+
+namespace {
+
+/** \brief The interval at which blocking socket operations check whether the server is stopping. */
+constexpr int kPollIntervalMilliseconds = 250;
+
+/** \brief The maximum length of a single request line. */
+constexpr size_t kMaxRequestSize = 1u << 16;
+
+/** \brief Determines whether a request path refers to a memory-mapped mesh container rather than an .obj file. */
+bool IsMeshContainer(const filesystem::path& filepath) {
+	return filepath.extension() == ".mmesh";
+}
+
+/**
+ * \brief Splits a request into tab-separated fields.
+ * \param request The request line without its terminating newline.
+ * \return The request fields.
+ */
+vector<string_view> Split(const string_view request) {
+	vector<string_view> fields;
+	for (size_t begin = 0; begin <= request.size();) {
+		const auto end = min(request.find('\t', begin), request.size());
+		fields.push_back(request.substr(begin, end - begin));
+		begin = end + 1;
+	}
+	return fields;
+}
+
+/**
+ * \brief Writes an entire buffer to a socket.
+ * \return \c true if all bytes were written, otherwise \c false.
+ */
+bool SendAll(const int connection, const string_view data) noexcept {
+	for (size_t offset = 0; offset < data.size();) {
+		const auto count = send(connection, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) return false;
+		offset += static_cast<size_t>(count);
+	}
+	return true;
+}
+
+/**
+ * \brief Waits until a file descriptor is readable or a timeout elapses.
+ * \return \c true if the file descriptor is readable or closed, otherwise \c false.
+ */
+bool WaitReadable(const int file_descriptor) noexcept {
+	pollfd descriptor{.fd = file_descriptor, .events = POLLIN, .revents = 0};
+	return poll(&descriptor, 1, kPollIntervalMilliseconds) > 0;
+}
+
+/**
+ * \brief Removes a socket file left behind by a server that is no longer running so its path can be bound again.
+ * \param address The address of the socket.
+ * \throw std::runtime_error Indicates the path exists but is not a socket, or a server is listening on it.
+ * \throw std::system_error Indicates whether a server is listening on the socket cannot be determined.
+ */
+void RemoveStaleSocket(const sockaddr_un& address) {
+	const auto socket_path = address.sun_path;
+	struct stat status {};
+	if (lstat(socket_path, &status) < 0) {
+		if (errno == ENOENT) return;
+		throw system_error{errno, generic_category(), format("Unable to inspect {}", socket_path)};
+	}
+	if (!S_ISSOCK(status.st_mode)) throw runtime_error{format("{} exists and is not a socket", socket_path)};
+
+	// only a socket nobody listens on refuses connections, any other outcome leaves it in place
+	const auto probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (probe < 0) throw system_error{errno, generic_category(), "Unable to create socket"};
+	const auto connected = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+	const auto error = errno;
+	close(probe);
+	if (connected) throw runtime_error{format("Another server is listening on {}", socket_path)};
+	if (error != ECONNREFUSED) {
+		throw system_error{error, generic_category(), format("Unable to determine whether {} is in use", socket_path)};
+	}
+	if (unlink(socket_path) < 0 && errno != ENOENT) {
+		throw system_error{errno, generic_category(), format("Unable to remove stale socket {}", socket_path)};
+	}
+}
+}
+
+Server::Server(ServerOptions options)
+	: options_{move(options)}, mesh_cache_{options_.cache_capacity}, thread_pool_{options_.job_count} {
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	const auto socket_path = options_.socket_path.string();
+	if (socket_path.size() >= sizeof(address.sun_path)) {
+		throw invalid_argument{format("Socket path is too long: {}", socket_path)};
+	}
+	strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+	socket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (socket_ < 0) throw system_error{errno, generic_category(), "Unable to create socket"};
+
+	try {
+		RemoveStaleSocket(address);
+	} catch (...) {
+		close(socket_);
+		throw;
+	}
+	if (bind(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || listen(socket_, SOMAXCONN) < 0) {
+		const auto error = errno;
+		close(socket_);
+		throw system_error{error, generic_category(), format("Unable to listen on {}", socket_path)};
+	}
+
+	// identify the socket file so destruction does not remove a socket another server has since bound to the path
+	if (struct stat status {}; stat(socket_path.c_str(), &status) == 0) {
+		socket_device_ = status.st_dev;
+		socket_inode_ = status.st_ino;
+	}
+}
+
+Server::~Server() {
+	Stop();
+	{
+		// unblock connections waiting on clients so their threads can exit
+		scoped_lock lock{connections_mutex_};
+		for (const auto connection : connections_) {
+			shutdown(connection, SHUT_RDWR);
+		}
+	}
+	for (auto& [connection_thread, finished] : connection_threads_) {
+		connection_thread.join();
+	}
+	close(socket_);
+	if (struct stat status {}; lstat(options_.socket_path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)
+		&& status.st_dev == socket_device_ && status.st_ino == socket_inode_) {
+		unlink(options_.socket_path.c_str());
+	}
+}
+
+void Server::Run() {
+	cout << format("Listening on {}\n", options_.socket_path.string()) << flush;
+
+	while (!stopping_) {
+		if (!WaitReadable(socket_)) continue;
+
+		const auto connection = accept4(socket_, nullptr, nullptr, SOCK_CLOEXEC);
+		if (connection < 0) {
+			if (errno != EINTR && errno != ECONNABORTED) cerr << format("accept failed: {}\n", strerror(errno));
+			continue;
+		}
+
+		// join threads of connections that have closed since the last accept
+		erase_if(connection_threads_, [](ConnectionThread& connection_thread) {
+			if (!*connection_thread.finished) return false;
+			connection_thread.thread.join();
+			return true;
+		});
+
+		scoped_lock lock{connections_mutex_};
+		connections_.insert(connection);
+		auto finished = make_shared<atomic<bool>>(false);
+		connection_threads_.push_back(ConnectionThread{
+			.thread = thread{[this, connection, finished] {
+				HandleConnection(connection);
+				*finished = true;
+			}},
+			.finished = finished
+		});
+	}
+}
+
+void Server::HandleConnection(const int connection) {
+	string buffer;
+	array<char, 4096> chunk{};
+
+	while (!stopping_) {
+		if (!WaitReadable(connection)) continue;
+
+		const auto count = recv(connection, chunk.data(), chunk.size(), 0);
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) break;
+		buffer.append(chunk.data(), static_cast<size_t>(count));
+
+		size_t line_end;
+		auto connected = true;
+		while (connected && (line_end = buffer.find('\n')) != string::npos) {
+			const auto response = HandleRequest(string_view{buffer}.substr(0, line_end)) + '\n';
+			buffer.erase(0, line_end + 1);
+			connected = SendAll(connection, response);
+		}
+
+		if (!connected || buffer.size() > kMaxRequestSize) break;
+	}
+
+	{
+		scoped_lock lock{connections_mutex_};
+		connections_.erase(connection);
+	}
+	close(connection);
+}
+
+string Server::HandleRequest(string_view request) {
+	if (!request.empty() && request.back() == '\r') request.remove_suffix(1);
+	const auto fields = Split(request);
+	const auto& command = fields.front();
+
+	try {
+		if (command == "ping") return "ok\tpong";
+
+		if (command == "stats") {
+			const auto [hits, misses, size] = mesh_cache_.GetStatistics();
+			return format("ok\thits={}\tmisses={}\tcached_bytes={}", hits, misses, size);
+		}
+
+		if (command == "shutdown") {
+			Stop();
+			return "ok";
+		}
+
+		if (command == "simplify") {
+			if (fields.size() != 4) throw invalid_argument{"Usage: simplify <rate> <input> <output>"};
+			const auto rate = stof(string{fields[1]});
+			const filesystem::path input_filepath{fields[2]};
+			const filesystem::path output_filepath{fields[3]};
+
+			const auto job_id = next_job_id_.fetch_add(1, memory_order_relaxed);
+			auto job = thread_pool_.Submit([this, rate, input_filepath, output_filepath, job_id] {
+				const auto start_time = chrono::steady_clock::now();
+				// containers are simplified in place since mapping them is already cheaper than a cache lookup
+				const auto mesh = IsMeshContainer(input_filepath)
+					? mesh::Simplify(MappedMesh{input_filepath}.view(), rate)
+					: mesh::Simplify(*mesh_cache_.Get(input_filepath), rate);
+
+				// write to a temporary file so clients never observe a partially written output, each job (and each
+				// server process) uses its own so concurrent requests for the same output do not write the same file
+				auto temporary_filepath = output_filepath;
+				temporary_filepath += format(".{}.{}.tmp", getpid(), job_id);
+				try {
+					if (IsMeshContainer(output_filepath)) {
+						WriteMappedMesh(mesh, temporary_filepath);
+					} else {
+						obj_writer::WriteMesh(mesh, temporary_filepath.string());
+					}
+					filesystem::rename(temporary_filepath, output_filepath);
+				} catch (...) {
+					error_code error;
+					filesystem::remove(temporary_filepath, error);
+					throw;
+				}
+
+				const auto end_time = chrono::steady_clock::now();
+				return format("ok\t{}\t{}\t{}",
+					output_filepath.string(),
+					mesh.GetIndices().size() / 3,
+					chrono::duration<float>{end_time - start_time}.count());
+			});
+			return job.get();
+		}
+
+		throw invalid_argument{format("Unknown request: {}", command)};
+
+	} catch (const exception& e) {
+		string message{e.what()};
+		ranges::replace(message, '\n', ' ');
+		return "error\t" + message;
+	}
+}
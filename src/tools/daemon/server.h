@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "concurrency/thread_pool.h"
+#include "tools/daemon/mesh_cache.h"
+
+namespace service {
+
+/** \brief Options that configure a simplification server. */
+struct ServerOptions {
+
+	/** \brief The filepath of the Unix domain socket to listen on. */
+	std::filesystem::path socket_path;
+
+	/** \brief The number of simplification jobs that run concurrently. */
+	std::size_t job_count;
+
+	/** \brief The number of bytes of loaded meshes to keep in memory between requests. */
+	std::size_t cache_capacity;
+};
+
+/**
+ * \brief A long-lived local service that simplifies meshes on request over a Unix domain socket.
+ * \details Clients send newline-terminated requests with tab-separated fields and receive one response line per
+ *          request. A connection may send any number of requests.
+ *
+ *          Requests:
+ *          - <tt>simplify &lt;rate&gt; &lt;input .obj&gt; &lt;output .obj&gt;</tt> simplifies a model and writes the
+ *            result. Responds with <tt>ok &lt;output&gt; &lt;triangles&gt; &lt;seconds&gt;</tt>. Inputs and outputs with the
+ *            .mmesh extension are read and written as memory-mapped mesh containers (see \c io::MappedMesh).
+ *          - <tt>stats</tt> responds with mesh cache counters.
+ *          - <tt>ping</tt> responds with <tt>ok pong</tt>.
+ *          - <tt>shutdown</tt> stops the server after responding.
+ *
+ *          Failed requests respond with <tt>error &lt;message&gt;</tt>.
+ */
+class Server {
+
+public:
+	/**
+	 * \brief Initializes a server and binds its socket.
+	 * \param options The server options.
+	 * \throw std::system_error Indicates the socket cannot be created or bound.
+	 * \throw std::runtime_error Indicates the socket path exists but is not a socket, or another server listens on it.
+	 * \note Binding replaces a stale socket file left behind by a server that did not shut down cleanly, which is
+	 *       detected by connections to it being refused. The socket file is removed on destruction unless another
+	 *       server has since replaced it.
+	 */
+	explicit Server(ServerOptions options);
+	~Server();
+
+	Server(const Server&) = delete;
+	Server& operator=(const Server&) = delete;
+
+	Server(Server&&) noexcept = delete;
+	Server& operator=(Server&&) noexcept = delete;
+
+	/** \brief Accepts and serves connections until \c Stop is called. */
+	void Run();
+
+	/** \brief Requests the server to stop. This function is safe to call from any thread or a signal handler. */
+	void Stop() noexcept { stopping_ = true; }
+
+private:
+	struct ConnectionThread {
+		std::thread thread;
+		std::shared_ptr<std::atomic<bool>> finished;
+	};
+
+	void HandleConnection(int connection);
+	std::string HandleRequest(std::string_view request);
+
+	ServerOptions options_;
+	int socket_ = -1;
+	dev_t socket_device_ = 0;
+	ino_t socket_inode_ = 0;
+	std::atomic<bool> stopping_ = false;
+	std::atomic<std::size_t> next_job_id_ = 0;
+	MeshCache mesh_cache_;
+	concurrency::ThreadPool thread_pool_;
+	std::mutex connections_mutex_;
+	std::unordered_set<int> connections_;
+	std::vector<ConnectionThread> connection_threads_;
+};
+}